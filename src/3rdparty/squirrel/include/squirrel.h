@@ -175,6 +175,7 @@ typedef SQInteger (*SQFUNCTION)(HSQUIRRELVM);
 typedef SQInteger (*SQRELEASEHOOK)(SQUserPointer,SQInteger size);
 typedef void (*SQCOMPILERERROR)(HSQUIRRELVM,const SQChar * /*desc*/,const SQChar * /*source*/,SQInteger /*line*/,SQInteger /*column*/);
 typedef void (*SQPRINTFUNCTION)(HSQUIRRELVM,const SQChar * ,...);
+typedef void (*SQNATIVECALLHOOK)(HSQUIRRELVM,SQBool /*enter*/);
 
 typedef SQInteger (*SQWRITEFUNC)(SQUserPointer,SQUserPointer,SQInteger);
 typedef SQInteger (*SQREADFUNC)(SQUserPointer,SQUserPointer,SQInteger);
@@ -205,6 +206,7 @@ void sq_setforeignptr(HSQUIRRELVM v,SQUserPointer p);
 SQUserPointer sq_getforeignptr(HSQUIRRELVM v);
 void sq_setprintfunc(HSQUIRRELVM v, SQPRINTFUNCTION printfunc);
 SQPRINTFUNCTION sq_getprintfunc(HSQUIRRELVM v);
+void sq_setnativecallhook(HSQUIRRELVM v, SQNATIVECALLHOOK hook);
 SQRESULT sq_suspendvm(HSQUIRRELVM v);
 bool sq_resumecatch(HSQUIRRELVM v, int suspend = -1);
 bool sq_resumeerror(HSQUIRRELVM v);
@@ -264,6 +266,7 @@ SQChar *sq_getscratchpad(HSQUIRRELVM v,SQInteger minsize);
 SQRESULT sq_getfunctioninfo(HSQUIRRELVM v,SQInteger idx,SQFunctionInfo *fi);
 SQRESULT sq_getclosureinfo(HSQUIRRELVM v,SQInteger idx,SQUnsignedInteger *nparams,SQUnsignedInteger *nfreevars);
 SQRESULT sq_setnativeclosurename(HSQUIRRELVM v,SQInteger idx,const SQChar *name);
+SQRESULT sq_setnativeclosurecallhook(HSQUIRRELVM v,SQInteger idx,SQBool enable);
 SQRESULT sq_setinstanceup(HSQUIRRELVM v, SQInteger idx, SQUserPointer p);
 SQRESULT sq_getinstanceup(HSQUIRRELVM v, SQInteger idx, SQUserPointer *p,SQUserPointer typetag);
 SQRESULT sq_setclassudsize(HSQUIRRELVM v, SQInteger idx, SQInteger udsize);
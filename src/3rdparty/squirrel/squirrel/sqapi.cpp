@@ -385,6 +385,17 @@ SQRESULT sq_setnativeclosurename(HSQUIRRELVM v,SQInteger idx,const SQChar *name)
 	return sq_throwerror(v,"the object is not a nativeclosure");
 }
 
+SQRESULT sq_setnativeclosurecallhook(HSQUIRRELVM v,SQInteger idx,SQBool enable)
+{
+	SQObject o = stack_get(v, idx);
+	if(sq_isnativeclosure(o)) {
+		SQNativeClosure *nc = _nativeclosure(o);
+		nc->_callhook = enable != SQFalse;
+		return SQ_OK;
+	}
+	return sq_throwerror(v,"the object is not a nativeclosure");
+}
+
 SQRESULT sq_setparamscheck(HSQUIRRELVM v,SQInteger nparamscheck,const SQChar *typemask)
 {
 	SQObject o = stack_get(v, -1);
@@ -1307,6 +1318,11 @@ SQPRINTFUNCTION sq_getprintfunc(HSQUIRRELVM v)
 	return _ss(v)->_printfunc;
 }
 
+void sq_setnativecallhook(HSQUIRRELVM v, SQNATIVECALLHOOK hook)
+{
+	_ss(v)->_nativecallhook = hook;
+}
+
 void *sq_malloc(SQUnsignedInteger size)
 {
 	return SQ_MALLOC(size);
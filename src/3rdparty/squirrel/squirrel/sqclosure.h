@@ -78,7 +78,7 @@ public:
 struct SQNativeClosure : public CHAINABLE_OBJ
 {
 private:
-	SQNativeClosure(SQSharedState *ss,SQFUNCTION func) : _nparamscheck(0) {_function=func;INIT_CHAIN();ADD_TO_CHAIN(&_ss(this)->_gc_chain,this);	}
+	SQNativeClosure(SQSharedState *ss,SQFUNCTION func) : _nparamscheck(0), _callhook(false) {_function=func;INIT_CHAIN();ADD_TO_CHAIN(&_ss(this)->_gc_chain,this);	}
 public:
 	static SQNativeClosure *Create(SQSharedState *ss,SQFUNCTION func)
 	{
@@ -93,6 +93,7 @@ public:
 		ret->_outervalues.copy(_outervalues);
 		ret->_typecheck.copy(_typecheck);
 		ret->_nparamscheck = _nparamscheck;
+		ret->_callhook = _callhook;
 		return ret;
 	}
 	~SQNativeClosure()
@@ -107,6 +108,7 @@ public:
 	void Finalize() override {_outervalues.resize(0);}
 #endif
 	SQInteger _nparamscheck;
+	bool _callhook; ///< Whether calls of this closure invoke the native call hook.
 	SQIntVec _typecheck;
 	SQObjectPtrVec _outervalues;
 	SQObjectPtr _env;
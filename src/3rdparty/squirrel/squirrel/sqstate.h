@@ -106,6 +106,7 @@ public:
 
 	SQCOMPILERERROR _compilererrorhandler;
 	SQPRINTFUNCTION _printfunc;
+	SQNATIVECALLHOOK _nativecallhook; ///< Called before and after every call of a native closure marked by sq_setnativeclosurecallhook.
 	bool _debuginfo;
 	bool _notifyallexceptions;
 private:
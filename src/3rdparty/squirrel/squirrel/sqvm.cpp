@@ -1189,12 +1189,16 @@ bool SQVM::CallNative(SQNativeClosure *nclosure,SQInteger nargs,SQInteger stackb
 	/* Store the call stack size, so we can restore that */
 	SQInteger cstksize = _callsstacksize;
 	SQInteger ret;
+	SQNATIVECALLHOOK hook = nclosure->_callhook ? _ss(this)->_nativecallhook : nullptr;
 	try {
 		SQBool can_suspend = this->_can_suspend;
 		this->_can_suspend = false;
+		if (hook != nullptr) hook(this, SQTrue);
 		ret = (nclosure->_function)(this);
+		if (hook != nullptr) hook(this, SQFalse);
 		this->_can_suspend = can_suspend;
 	} catch (...) {
+		if (hook != nullptr) hook(this, SQFalse);
 		_nnativecalls--;
 		suspend = false;
 
@@ -10,6 +10,8 @@
 #include "../stdafx.h"
 #include "../core/backup_type.hpp"
 #include "../core/bitmath_func.hpp"
+#include "../core/random_func.hpp"
+#include "../command_func.h"
 #include "../company_base.h"
 #include "../company_func.h"
 #include "../network/network.h"
@@ -17,6 +19,10 @@
 #include "../framerate_type.h"
 #include "../scope_info.h"
 #include "../string_func.h"
+#include "../settings_type.h"
+#include "../worker_thread.h"
+#include "../script/squirrel.hpp"
+#include "../debug.h"
 #include "ai_scanner.hpp"
 #include "ai_instance.hpp"
 #include "ai_config.hpp"
@@ -68,6 +74,40 @@
 	return;
 }
 
+/**
+ * Run the game loop of the AIs of the given companies concurrently on the worker threads.
+ * The server executes the commands of scripts in a later tick, so the game state does not change
+ * while the scripts run, and all see the same state as when they run one after another.
+ * Everything outside of the script VMs is serialised by SquirrelConcurrency.
+ * @param companies The companies.
+ */
+static void AIConcurrentGameLoop(const std::vector<Company *> &companies)
+{
+	GameRandomSeedChecker random_state;
+	const uint64_t exec_count = _docommand_exec_count;
+	const uint queued_commands = NetworkGetLocalCommandCount();
+
+	_general_worker_pool.ParallelFor(0, companies.size(), 1, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			const Company *c = companies[i];
+			PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
+			SquirrelConcurrency::ThreadScope thread_scope(c->index);
+			c->ai_instance->GameLoop();
+		}
+	});
+
+	/* Queue the commands in company order, as when the scripts run one after another */
+	NetworkOrderLocalCommandsByCompany(queued_commands);
+
+	/* The scripts must not have changed the game state, other than by queuing commands */
+	const bool isolated = random_state.Check() && exec_count == _docommand_exec_count;
+	assert_msg(isolated, "random unchanged: %d, executed commands: " OTTD_PRINTF64U, random_state.Check(), _docommand_exec_count - exec_count);
+	if (!isolated) {
+		DEBUG(script, 0, "Concurrently running AIs changed the game state, running them one after another from now on");
+		_settings_client.network.server_concurrent_ai = false;
+	}
+}
+
 /* static */ void AI::GameLoop()
 {
 	/* If we are in networking, only servers run this function, and that only if it is allowed */
@@ -79,6 +119,32 @@
 	if ((AI::frame_counter & ((1 << (4 - _settings_game.difficulty.competitor_speed)) - 1)) != 0) return;
 
 	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
+
+	/* Only a server queues the commands of scripts instead of executing them right away */
+	if (_settings_client.network.server_concurrent_ai && _networking && _network_server) {
+		std::vector<Company *> companies;
+		for (Company *c : Company::Iterate()) {
+			if (c->is_ai) {
+				companies.push_back(c);
+			} else {
+				PerformanceMeasurer::SetInactive((PerformanceElement)(PFE_AI0 + c->index));
+			}
+		}
+		AIConcurrentGameLoop(companies);
+		cur_company.Restore();
+
+		/* Occasionally collect garbage; every 255 ticks do one company. */
+		if ((AI::frame_counter & 255) == 0) {
+			Company *c = Company::GetIfValid((CompanyID)GB(AI::frame_counter, 8, 4));
+			if (c != nullptr && c->is_ai) {
+				cur_company.Change(c->index);
+				c->ai_instance->CollectGarbage();
+				cur_company.Restore();
+			}
+		}
+		return;
+	}
+
 	for (const Company *c : Company::Iterate()) {
 		if (c->is_ai) {
 			SCOPE_INFO_FMT([&], "AI::GameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName().c_str(), c->ai_info->GetVersion());
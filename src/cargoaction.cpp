@@ -107,7 +107,7 @@ bool CargoDelivery::operator()(CargoPacket *cp)
 {
 	uint remove = this->Preprocess(cp);
 	this->source->RemoveFromMeta(cp, VehicleCargoList::MTA_DELIVER, remove);
-	this->payment->PayFinalDelivery(cp, remove, this->current_tile);
+	this->payment->PayFinalDelivery(cp, remove, this->source->GetPeriodsInTransit(cp), this->current_tile);
 	return this->Postprocess(cp, remove);
 }
 
@@ -154,6 +154,7 @@ bool CargoReturn::operator()(CargoPacket *cp)
 	assert(cp_new->Count() <= this->destination->reserved_count);
 	cp_new->UpdateUnloadingTile(this->current_tile);
 	this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_LOAD, cp_new->Count());
+	this->source->MakeAgeAbsolute(cp_new);
 	this->destination->reserved_count -= cp_new->Count();
 	this->destination->Append(cp_new, this->next);
 	return cp_new == cp;
@@ -170,6 +171,7 @@ bool CargoTransfer::operator()(CargoPacket *cp)
 	if (cp_new == nullptr) return false;
 	cp_new->UpdateUnloadingTile(this->current_tile);
 	this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_TRANSFER, cp_new->Count());
+	this->source->MakeAgeAbsolute(cp_new);
 	/* No transfer credits here as they were already granted during Stage(). */
 	this->destination->Append(cp_new, cp_new->GetNextHop());
 	return cp_new == cp;
@@ -185,6 +187,7 @@ bool CargoShift::operator()(CargoPacket *cp)
 	CargoPacket *cp_new = this->Preprocess(cp);
 	if (cp_new == nullptr) cp_new = cp;
 	this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_KEEP, cp_new->Count());
+	this->source->MakeAgeAbsolute(cp_new);
 	this->destination->Append(cp_new, VehicleCargoList::MTA_KEEP);
 	return cp_new == cp;
 }
@@ -227,6 +230,8 @@ bool VehicleCargoReroute::operator()(CargoPacket *cp, std::vector<CargoPacket *>
 	}
 	if (unlikely(this->source != this->destination)) {
 		this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_TRANSFER, cp_new->Count());
+		this->source->MakeAgeAbsolute(cp_new);
+		this->destination->MakeAgeRelative(cp_new);
 		this->destination->AddToMeta(cp_new, VehicleCargoList::MTA_TRANSFER);
 	}
 
@@ -120,9 +120,9 @@ CargoPacket::CargoPacket()
  */
 CargoPacket::CargoPacket(StationID first_station,uint16_t count, SourceType source_type, SourceID source_id) :
 		count(count),
+		first_station(first_station),
 		source_id(source_id),
-		source_type(source_type),
-		first_station(first_station)
+		source_type(source_type)
 {
 	dbg_assert(count != 0);
 }
@@ -139,9 +139,9 @@ CargoPacket::CargoPacket(StationID first_station,uint16_t count, SourceType sour
 CargoPacket::CargoPacket(uint16_t count, uint16_t periods_in_transit, StationID first_station, TileIndex source_xy, Money feeder_share) :
 		count(count),
 		periods_in_transit(periods_in_transit),
-		feeder_share(feeder_share),
+		first_station(first_station),
 		source_xy(source_xy),
-		first_station(first_station)
+		feeder_share(feeder_share)
 {
 	assert(count != 0);
 }
@@ -156,13 +156,13 @@ CargoPacket::CargoPacket(uint16_t count, uint16_t periods_in_transit, StationID
 CargoPacket::CargoPacket(uint16_t count, Money feeder_share, const CargoPacket &original) :
 		count(count),
 		periods_in_transit(original.periods_in_transit),
-		feeder_share(feeder_share),
-		source_xy(original.source_xy),
-		travelled(original.travelled),
+		first_station(original.first_station),
+		next_hop(original.next_hop),
 		source_id(original.source_id),
 		source_type(original.source_type),
-		first_station(original.first_station),
-		next_hop(original.next_hop)
+		source_xy(original.source_xy),
+		travelled(original.travelled),
+		feeder_share(feeder_share)
 {
 	dbg_assert(count != 0);
 #ifdef WITH_FULL_ASSERTS
@@ -423,6 +423,7 @@ void VehicleCargoList::Append(CargoPacket *cp, MoveToAction action)
 	dbg_assert(cp != nullptr);
 	dbg_assert(action == MTA_LOAD ||
 			(action == MTA_KEEP && this->action_counts[MTA_LOAD] == 0));
+	this->MakeAgeRelative(cp);
 	this->AddToMeta(cp, action);
 
 	if (this->count == cp->count) {
@@ -532,8 +533,10 @@ void VehicleCargoList::PopCargo(Taction action)
  */
 void VehicleCargoList::RemoveFromCache(const CargoPacket *cp, uint count)
 {
+	dbg_assert(count <= cp->count);
 	this->feeder_share -= cp->GetFeederShare(count);
-	this->Parent::RemoveFromCache(cp, count);
+	this->count -= count;
+	this->cargo_periods_in_transit -= static_cast<uint64_t>(this->GetPeriodsInTransit(cp)) * count;
 }
 
 /**
@@ -544,7 +547,8 @@ void VehicleCargoList::RemoveFromCache(const CargoPacket *cp, uint count)
 void VehicleCargoList::AddToCache(const CargoPacket *cp)
 {
 	this->feeder_share += cp->feeder_share;
-	this->Parent::AddToCache(cp);
+	this->count += cp->count;
+	this->cargo_periods_in_transit += static_cast<uint64_t>(this->GetPeriodsInTransit(cp)) * cp->count;
 }
 
 /**
@@ -575,18 +579,59 @@ void VehicleCargoList::AddToMeta(const CargoPacket *cp, MoveToAction action)
 	this->AssertCountConsistency();
 }
 
+/**
+ * Turns the age of a packet entering this list into one relative to the
+ * aging epoch of this list.
+ * @param cp Packet with an absolute age.
+ */
+void VehicleCargoList::MakeAgeRelative(CargoPacket *cp)
+{
+	if (this->packets.empty()) {
+		this->aging_epoch = 0;
+		this->periods_in_transit_bound = 0;
+	}
+	this->periods_in_transit_bound = std::max(this->periods_in_transit_bound, cp->periods_in_transit);
+	cp->periods_in_transit -= this->aging_epoch;
+}
+
 /**
  * Ages the all cargo in this list.
+ * As long as no packet can be at the maximum age, this only advances the aging
+ * epoch of the list instead of touching every packet.
  */
 void VehicleCargoList::AgeCargo()
 {
+	if (this->packets.empty()) return;
+
+	if (this->periods_in_transit_bound < UINT16_MAX) {
+		this->aging_epoch++;
+		this->periods_in_transit_bound++;
+		this->cargo_periods_in_transit += this->count;
+		return;
+	}
+
+	uint16_t bound = 0;
 	for (const auto &cp : this->packets) {
 		/* If we're at the maximum, then we can't increase no more. */
-		if (cp->periods_in_transit == UINT16_MAX) continue;
+		if (this->GetPeriodsInTransit(cp) != UINT16_MAX) {
+			cp->periods_in_transit++;
+			this->cargo_periods_in_transit += cp->count;
+		}
+		bound = std::max(bound, this->GetPeriodsInTransit(cp));
+	}
+	this->periods_in_transit_bound = bound;
+}
 
-		cp->periods_in_transit++;
-		this->cargo_periods_in_transit += cp->count;
+/**
+ * Stores the absolute age in all packets of this list, e.g. for saving them.
+ */
+void VehicleCargoList::NormaliseAging()
+{
+	if (this->aging_epoch == 0) return;
+	for (const auto &cp : this->packets) {
+		this->MakeAgeAbsolute(cp);
 	}
+	this->aging_epoch = 0;
 }
 
 /**
@@ -704,7 +749,7 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 			case MTA_TRANSFER:
 				transfer_deliver.push_front(cp);
 				/* Add feeder share here to allow reusing field for next station. */
-				share = payment->PayTransfer(cp, cp->count, current_tile);
+				share = payment->PayTransfer(cp, cp->count, this->GetPeriodsInTransit(cp), current_tile);
 				cp->AddFeederShare(share);
 				this->feeder_share += share;
 				cp->next_hop = cargo_next;
@@ -727,6 +772,11 @@ void VehicleCargoList::InvalidateCache()
 {
 	this->feeder_share = 0;
 	this->Parent::InvalidateCache();
+
+	this->periods_in_transit_bound = 0;
+	for (const auto &cp : this->packets) {
+		this->periods_in_transit_bound = std::max(this->periods_in_transit_bound, this->GetPeriodsInTransit(cp));
+	}
 }
 
 /**
@@ -57,16 +57,18 @@ private:
 		int32_t y;
 	};
 
+	/* The fields used when walking, merging and staging the packets of a list come first,
+	 * the ones only needed for payments last. */
 	uint16_t count = 0;                            ///< The amount of cargo in this packet.
 	uint16_t periods_in_transit = 0;               ///< Amount of cargo aging periods this packet has been in transit.
-	Money feeder_share = 0;                        ///< Value of feeder pickup to be paid for on delivery of cargo.
-	TileIndex source_xy = INVALID_TILE;            ///< The origin of the cargo.
-	Vector travelled = {0, 0};                     ///< If cargo is in station: the vector from the unload tile to the source tile. If in vehicle: an intermediate value.
+	StationID first_station = INVALID_STATION;     ///< The station where the cargo came from first.
+	StationID next_hop = INVALID_STATION;          ///< Station where the cargo wants to go next.
 	SourceID source_id = INVALID_SOURCE;           ///< Index of industry/town/HQ, INVALID_SOURCE if unknown/invalid.
 	SourceType source_type = SourceType::Industry; ///< Type of \c source_id.
 	uint8_t flags = 0;                             ///< NOSAVE: temporary flags
-	StationID first_station = INVALID_STATION;     ///< The station where the cargo came from first.
-	StationID next_hop = INVALID_STATION;          ///< Station where the cargo wants to go next.
+	TileIndex source_xy = INVALID_TILE;            ///< The origin of the cargo.
+	Vector travelled = {0, 0};                     ///< If cargo is in station: the vector from the unload tile to the source tile. If in vehicle: an intermediate value.
+	Money feeder_share = 0;                        ///< Value of feeder pickup to be paid for on delivery of cargo.
 
 	/** Cargo packet flag bits in CargoPacket::flags. */
 	enum CargoPacketFlags {
@@ -199,6 +201,8 @@ public:
 	 * Gets the number of days this cargo has been in transit.
 	 * This number isn't really in days, but in 2.5 days (CARGO_AGING_TICKS = 185 ticks) and
 	 * it is capped at UINT16_MAX.
+	 * @note Packets in a VehicleCargoList store their age relative to the aging epoch
+	 *       of the list; use VehicleCargoList::GetPeriodsInTransit for those.
 	 * @return Length this cargo has been in transit.
 	 */
 	inline uint16_t GetPeriodsInTransit() const
@@ -384,6 +388,8 @@ protected:
 
 	Money feeder_share;                     ///< Cache for the feeder share.
 	uint action_counts[NUM_MOVE_TO_ACTION]; ///< Counts of cargo to be transferred, delivered, kept and loaded.
+	uint16_t aging_epoch;                   ///< Number of times the cargo was aged, modulo 2^16; packets store their age relative to it.
+	uint16_t periods_in_transit_bound;      ///< Upper bound of the periods in transit of the packets in this list.
 
 	template<class Taction>
 	void ShiftCargo(Taction action);
@@ -431,6 +437,17 @@ protected:
 	void AddToMeta(const CargoPacket *cp, MoveToAction action);
 	void RemoveFromMeta(const CargoPacket *cp, MoveToAction action, uint count);
 
+	/**
+	 * Turns the age of a packet leaving this list into the absolute one.
+	 * @param cp Packet whose age is relative to the aging epoch of this list.
+	 */
+	inline void MakeAgeAbsolute(CargoPacket *cp) const
+	{
+		cp->periods_in_transit = this->GetPeriodsInTransit(cp);
+	}
+
+	void MakeAgeRelative(CargoPacket *cp);
+
 	static MoveToAction ChooseAction(const CargoPacket *cp, StationID cargo_next,
 			StationID current_station, bool accepted, StationIDStack next_station);
 
@@ -516,9 +533,20 @@ public:
 		return this->action_counts[MTA_KEEP] + this->action_counts[MTA_LOAD];
 	}
 
+	/**
+	 * Gets the number of cargo aging periods a packet in this list has been in transit.
+	 * @param cp Packet in this list.
+	 * @return Length the cargo has been in transit.
+	 */
+	inline uint16_t GetPeriodsInTransit(const CargoPacket *cp) const
+	{
+		return static_cast<uint16_t>(cp->periods_in_transit + this->aging_epoch);
+	}
+
 	void Append(CargoPacket *cp, MoveToAction action = MTA_KEEP);
 
 	void AgeCargo();
+	void NormaliseAging();
 
 	void InvalidateCache();
 
@@ -551,6 +579,7 @@ public:
 	/**
 	 * Are the two CargoPackets mergeable in the context of
 	 * a list of CargoPackets for a Vehicle?
+	 * Both packets need to have their ages relative to the same aging epoch.
 	 * @param cp1 First CargoPacket.
 	 * @param cp2 Second CargoPacket.
 	 * @return True if they are mergeable.
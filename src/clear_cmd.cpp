@@ -382,6 +382,29 @@ static void TileLoop_Clear(TileIndex tile)
 	MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE_NON_VEG);
 }
 
+/**
+ * Check whether TileLoop_Clear would leave a clear tile and the game state untouched.
+ * This only reads the map, so it may be called from worker threads whilst the map is not modified.
+ * @param tile The clear tile.
+ * @return true if the tile loop of \a tile is known to do nothing, false if it may do something.
+ */
+bool IsClearTileLoopNoOp(TileIndex tile)
+{
+	if (HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK)) return false;
+
+	switch (_settings_game.game_creation.landscape) {
+		case LT_TROPIC:
+		case LT_ARCTIC:
+			return false;
+	}
+
+	switch (GetClearGround(tile)) {
+		case CLEAR_GRASS:  return GetClearDensity(tile) == 3;
+		case CLEAR_FIELDS: return false;
+		default:           return true;
+	}
+}
+
 void GenerateClearTile()
 {
 	uint i, gi;
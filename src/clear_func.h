@@ -21,4 +21,6 @@ SpriteID GetSpriteIDForRocks(const Slope slope, const uint tile_hash);
 SpriteID GetSpriteIDForFields(const Slope slope, const uint field_type);
 SpriteID GetSpriteIDForSnowDesert(const Slope slope, const uint density);
 
+bool IsClearTileLoopNoOp(TileIndex tile);
+
 #endif /* CLEAR_FUNC_H */
@@ -796,6 +796,7 @@ bool IsCommandAllowedWhilePaused(uint32_t cmd)
 
 
 static int _docommand_recursive = 0;
+uint64_t _docommand_exec_count = 0; ///< Number of command executions with #DC_EXEC through #DoCommandEx, used to detect map changes of unknown extent.
 
 struct cmd_text_info_dumper {
 	const char *CommandTextInfo(const char *text, const CommandAuxiliaryBase *aux_data)
@@ -870,6 +871,7 @@ CommandCost DoCommandEx(TileIndex tile, uint32_t p1, uint32_t p2, uint64_t p3, D
 	/* Execute the command here. All cost-relevant functions set the expenses type
 	 * themselves to the cost object at some point */
 	if (_docommand_recursive == 1) _cleared_object_areas.clear();
+	_docommand_exec_count++;
 	res = command.Execute(tile, flags, p1, p2, p3, text, aux_data);
 	if (res.Failed()) {
 error:
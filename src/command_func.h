@@ -59,8 +59,11 @@ CommandCost DoCommandPScript(TileIndex tile, uint32_t p1, uint32_t p2, uint64_t
 CommandCost DoCommandPInternal(TileIndex tile, uint32_t p1, uint32_t p2, uint64_t p3, uint32_t cmd, CommandCallback *callback, const char *text, bool my_cmd, bool estimate_only, const CommandAuxiliaryBase *aux_data);
 
 void NetworkSendCommand(TileIndex tile, uint32_t p1, uint32_t p2, uint64_t p3, uint32_t cmd, CommandCallback *callback, const char *text, CompanyID company, const CommandAuxiliaryBase *aux_data);
+uint NetworkGetLocalCommandCount();
+void NetworkOrderLocalCommandsByCompany(uint first);
 
 extern Money _additional_cash_required;
+extern uint64_t _docommand_exec_count;
 
 bool IsValidCommand(uint32_t cmd);
 CommandFlags GetCommandFlags(uint32_t cmd);
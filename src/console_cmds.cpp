@@ -483,6 +483,28 @@ DEF_CONSOLE_CMD(ConSave)
 	return false;
 }
 
+DEF_CONSOLE_CMD(ConConsolidateSave)
+{
+	if (argc == 0) {
+		IConsoleHelp("Convert a delta autosave into a normal savegame which does not depend on its base autosave. Usage: 'consolidate_save <autosave filename> <filename>'");
+		IConsoleHelp("Delta autosaves are enabled by the setting gui.autosave_delta_count.");
+		return true;
+	}
+
+	if (argc == 3) {
+		std::string filename = stdstr_fmt("%s.sav", argv[2]);
+		std::string error;
+		if (!ConsolidateDeltaSave(argv[1], filename, error)) {
+			IConsolePrintF(CC_ERROR, "Consolidating %s failed: %s", argv[1], error.c_str());
+		} else {
+			IConsolePrintF(CC_DEFAULT, "Map successfully saved to %s", filename.c_str());
+		}
+		return true;
+	}
+
+	return false;
+}
+
 /**
  * Explicitly save the configuration.
  * @return True.
@@ -3135,6 +3157,29 @@ DEF_CONSOLE_CMD(ConSpriteCacheStats)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConYapfRailStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump rail pathfinder and segment cost cache stats. Usage: 'dump_yapf_rail_stats [reset]'");
+		return true;
+	}
+
+	if (argc > 2) return false;
+
+	if (argc == 2) {
+		if (strcmp(argv[1], "reset") != 0) return false;
+		extern void ResetYapfRailSearchStats();
+		ResetYapfRailSearchStats();
+		return true;
+	}
+
+	extern void DumpYapfRailSearchStats(char *buffer, const char *last);
+	char buffer[2048];
+	DumpYapfRailSearchStats(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConCheckCaches)
 {
 	if (argc == 0) {
@@ -3820,6 +3865,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("load",                    ConLoad);
 	IConsole::CmdRegister("rm",                      ConRemove);
 	IConsole::CmdRegister("save",                    ConSave);
+	IConsole::CmdRegister("consolidate_save",        ConConsolidateSave);
 	IConsole::CmdRegister("saveconfig",              ConSaveConfig);
 	IConsole::CmdRegister("ls",                      ConListFiles);
 	IConsole::CmdRegister("cd",                      ConChangeDirectory);
@@ -3963,6 +4009,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("dump_grf_cargo_tables",   ConDumpGrfCargoTables, nullptr, true);
 	IConsole::CmdRegister("dump_signal_styles",      ConDumpSignalStyles, nullptr, true);
 	IConsole::CmdRegister("dump_sprite_cache_stats", ConSpriteCacheStats, nullptr, true);
+	IConsole::CmdRegister("dump_yapf_rail_stats",    ConYapfRailStats,    nullptr, true);
 	IConsole::CmdRegister("check_caches",            ConCheckCaches,      nullptr, true);
 	IConsole::CmdRegister("show_town_window",        ConShowTownWindow,   nullptr, true);
 	IConsole::CmdRegister("show_station_window",     ConShowStationWindow, nullptr, true);
@@ -41,7 +41,8 @@ DEFINE_POOL_METHOD(inline)::Pool(const char *name) :
 		cleaning(false),
 		data(nullptr),
 		free_bitmap(nullptr),
-		alloc_cache(nullptr)
+		alloc_cache(nullptr),
+		alloc_slabs(nullptr)
 { }
 
 /**
@@ -100,6 +101,27 @@ DEFINE_POOL_METHOD(inline size_t)::FindFirstFree()
 	return NO_FREE_ITEM;
 }
 
+/**
+ * Allocates a slab of Tgrowth_step items and adds them to the cache of free items,
+ * such that they are handed out in the order of their addresses.
+ */
+DEFINE_POOL_METHOD(void)::AllocateSlab()
+{
+	static_assert(sizeof(Titem) >= sizeof(AllocCache));
+	static_assert(alignof(Titem) <= ALLOC_SLAB_HEADER_SIZE);
+
+	AllocSlab *slab = (AllocSlab *)MallocT<byte>(ALLOC_SLAB_HEADER_SIZE + Tgrowth_step * sizeof(Titem));
+	slab->next = this->alloc_slabs;
+	this->alloc_slabs = slab;
+
+	byte *items = (byte *)slab + ALLOC_SLAB_HEADER_SIZE;
+	for (size_t i = Tgrowth_step; i-- > 0;) {
+		AllocCache *ac = (AllocCache *)(items + i * sizeof(Titem));
+		ac->next = this->alloc_cache;
+		this->alloc_cache = ac;
+	}
+}
+
 /**
  * Makes given index valid
  * @param size size of item
@@ -115,8 +137,9 @@ DEFINE_POOL_METHOD(inline void *)::AllocateItem(size_t size, size_t index)
 	this->items++;
 
 	Titem *item;
-	if (Tcache && this->alloc_cache != nullptr) {
+	if constexpr (Tcache) {
 		dbg_assert(sizeof(Titem) == size);
+		if (this->alloc_cache == nullptr) this->AllocateSlab();
 		item = (Titem *)this->alloc_cache;
 		this->alloc_cache = this->alloc_cache->next;
 		if (Tzero) {
@@ -222,10 +245,11 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	this->cleaning = false;
 
 	if (Tcache) {
-		while (this->alloc_cache != nullptr) {
-			AllocCache *ac = this->alloc_cache;
-			this->alloc_cache = ac->next;
-			free(ac);
+		this->alloc_cache = nullptr;
+		while (this->alloc_slabs != nullptr) {
+			AllocSlab *slab = this->alloc_slabs;
+			this->alloc_slabs = slab->next;
+			free(slab);
 		}
 	}
 }
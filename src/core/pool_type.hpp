@@ -11,6 +11,7 @@
 #define POOL_TYPE_HPP
 
 #include "enum_type.hpp"
+#include <cstddef>
 #include <vector>
 
 /** Various types of a pool. */
@@ -73,7 +74,8 @@ private:
  * @tparam Tgrowth_step Size of growths; if the pool is full increase the size by this amount
  * @tparam Tmax_size    Maximum size of the pool
  * @tparam Tpool_type   Type of this pool
- * @tparam Tcache       Whether to perform 'alloc' caching, i.e. don't actually free/malloc just reuse the memory
+ * @tparam Tcache       Whether to perform 'alloc' caching, i.e. don't actually free/malloc just reuse the memory,
+ *                      and allocate the memory of the items in slabs of Tgrowth_step items
  * @tparam Tzero        Whether to zero the memory
  * @warning when Tcache is enabled *all* instances of this pool's item must be of the same size.
  */
@@ -405,9 +407,21 @@ private:
 		AllocCache *next;
 	};
 
+	/** Header of a slab of items allocated together. */
+	struct AllocSlab {
+		/** The next slab of this pool */
+		AllocSlab *next;
+	};
+
+	/** Size of the header of a slab, keeping the items after it aligned like malloc does. */
+	static constexpr size_t ALLOC_SLAB_HEADER_SIZE = alignof(std::max_align_t);
+
 	/** Cache of freed pointers */
 	AllocCache *alloc_cache;
+	/** Slabs the cached items are allocated in */
+	AllocSlab *alloc_slabs;
 
+	void AllocateSlab();
 	void *AllocateItem(size_t size, size_t index);
 	void ResizeFor(size_t index);
 	size_t FindFirstFree();
@@ -0,0 +1,93 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file spsc_queue.hpp Lock-free single producer, single consumer queue. */
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include "bitmath_func.hpp"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+/**
+ * Lock-free queue with a fixed capacity, to pass items from one producer thread to one consumer thread.
+ *
+ * Only one thread may call #push and only one (other) thread may call #pop.
+ * #size and #empty may be called from either thread, but are only exact on the consumer side.
+ */
+template <class T>
+class spsc_queue
+{
+	std::unique_ptr<T[]> items;
+	uint32_t mask;
+	alignas(64) std::atomic<uint32_t> head{0}; ///< Index of the next item to pop, only written by the consumer.
+	alignas(64) std::atomic<uint32_t> tail{0}; ///< Index of the next item to push, only written by the producer.
+
+public:
+	/**
+	 * Create a queue.
+	 * @param capacity The minimum number of items the queue can hold, it is rounded up to a power of two.
+	 */
+	spsc_queue(uint32_t capacity)
+	{
+		uint32_t size = capacity <= 2 ? 2 : 1 << (FindLastBit(capacity - 1) + 1);
+		this->items.reset(new T[size]);
+		this->mask = size - 1;
+	}
+
+	spsc_queue(const spsc_queue &other) = delete;
+	spsc_queue &operator=(const spsc_queue &other) = delete;
+
+	/**
+	 * Add an item to the queue, by the producer.
+	 * @param item The item, which is only moved from when it could be added.
+	 * @return False if the queue is full.
+	 */
+	bool push(T &&item)
+	{
+		uint32_t t = this->tail.load(std::memory_order_relaxed);
+		if (t - this->head.load(std::memory_order_acquire) > this->mask) return false;
+
+		this->items[t & this->mask] = std::move(item);
+		this->tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Remove the first item from the queue, by the consumer.
+	 * @param item Where to store the item.
+	 * @return False if the queue is empty.
+	 */
+	bool pop(T &item)
+	{
+		uint32_t h = this->head.load(std::memory_order_relaxed);
+		if (h == this->tail.load(std::memory_order_acquire)) return false;
+
+		/* Leave a default item behind, so resources held by the item are released by the consumer. */
+		item = std::exchange(this->items[h & this->mask], T{});
+		this->head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	uint32_t size() const
+	{
+		/* Load the head first, as the tail can never fall behind it. */
+		uint32_t h = this->head.load(std::memory_order_acquire);
+		return this->tail.load(std::memory_order_acquire) - h;
+	}
+
+	bool empty() const { return this->size() == 0; }
+
+	bool full() const { return this->size() > this->mask; }
+
+	uint32_t capacity() const { return this->mask + 1; }
+};
+
+#endif /* SPSC_QUEUE_HPP */
@@ -0,0 +1,253 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tile_bucket_index.hpp Spatial index of items by the tile they are on. */
+
+#ifndef TILE_BUCKET_INDEX_HPP
+#define TILE_BUCKET_INDEX_HPP
+
+#include "alloc_func.hpp"
+#include "math_func.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Spatial index of items by the tile they are on, for finding the items on a tile or in a small area.
+ *
+ * The map is split into square chunks of 2^CHUNK_BITS tiles. A dense array points every chunk to the bucket of
+ * the items in it, and a bucket is a single block holding the tiles of the items followed by the items.
+ * A lookup reads one chunk entry and scans the tiles of one bucket, so items near each other share
+ * cache lines, and no hash table spread over the whole map is probed.
+ *
+ * Tiles are indices into a map whose width is 2^log_x, as in #TileXY.
+ * Every item stores its position within its bucket in the member POS, so it can be removed in constant time.
+ * The order of the items in a bucket is not stable. Buckets are kept when they become empty, as items
+ * tend to come back to the same chunks.
+ */
+template <class T, uint32_t T::*POS>
+class tile_bucket_index
+{
+public:
+	static const uint CHUNK_BITS = 4; ///< Chunks are 2^CHUNK_BITS tiles wide and high.
+
+private:
+	/** The items in one chunk; the tiles and the items follow the header in the same allocation. */
+	struct Bucket {
+		uint32_t count;    ///< Number of items in the bucket.
+		uint32_t capacity; ///< Number of items that fit in the bucket, always even to keep the items aligned.
+
+		uint32_t *Tiles() { return reinterpret_cast<uint32_t *>(this + 1); }
+		const uint32_t *Tiles() const { return reinterpret_cast<const uint32_t *>(this + 1); }
+		T **Items() { return reinterpret_cast<T **>(this->Tiles() + this->capacity); }
+		T * const *Items() const { return reinterpret_cast<T * const *>(this->Tiles() + this->capacity); }
+
+		static Bucket *Allocate(uint32_t capacity)
+		{
+			Bucket *b = reinterpret_cast<Bucket *>(MallocT<byte>(sizeof(Bucket) + capacity * (sizeof(uint32_t) + sizeof(T *))));
+			b->count = 0;
+			b->capacity = capacity;
+			return b;
+		}
+	};
+
+	uint log_x = 0;               ///< Base 2 logarithm of the map width.
+	uint size_y = 0;              ///< Height of the map.
+	std::vector<Bucket *> chunks; ///< The bucket of each chunk, or nullptr if no item was ever in the chunk.
+	size_t count = 0;             ///< Number of items in the index.
+
+	inline uint32_t ChunkOfTile(uint32_t tile) const
+	{
+		uint x = tile & ((1U << this->log_x) - 1);
+		uint y = tile >> this->log_x;
+		return this->ChunkOfXY(x, y);
+	}
+
+	inline uint32_t ChunkOfXY(uint x, uint y) const
+	{
+		return ((y >> CHUNK_BITS) << (this->log_x - CHUNK_BITS)) | (x >> CHUNK_BITS);
+	}
+
+	void Clear()
+	{
+		for (Bucket *b : this->chunks) free(b);
+		this->chunks.clear();
+		this->count = 0;
+	}
+
+	/**
+	 * Call a function for the items of a chunk that are on a tile in an area.
+	 * The bucket is looked up again for every item, so the function may add or remove items in other chunks.
+	 */
+	template <typename F>
+	bool IterateChunk(uint32_t chunk, uint xl, uint yl, uint xu, uint yu, F &func) const
+	{
+		const uint32_t mask = (1U << this->log_x) - 1;
+		for (uint32_t i = 0; this->chunks[chunk] != nullptr && i < this->chunks[chunk]->count; i++) {
+			const Bucket *b = this->chunks[chunk];
+			uint32_t tile = b->Tiles()[i];
+			uint x = tile & mask;
+			uint y = tile >> this->log_x;
+			if (x < xl || x > xu || y < yl || y > yu) continue;
+			if (func(b->Items()[i])) return true;
+		}
+		return false;
+	}
+
+public:
+	tile_bucket_index() {}
+	tile_bucket_index(const tile_bucket_index &other) = delete;
+	tile_bucket_index &operator=(const tile_bucket_index &other) = delete;
+
+	~tile_bucket_index()
+	{
+		this->Clear();
+	}
+
+	/**
+	 * Remove all items and set the size of the map.
+	 * @param log_x Base 2 logarithm of the map width.
+	 * @param size_y Height of the map, a multiple of the chunk size.
+	 */
+	void reset(uint log_x, uint size_y)
+	{
+		assert(log_x >= CHUNK_BITS && size_y % (1U << CHUNK_BITS) == 0);
+
+		this->Clear();
+		this->log_x = log_x;
+		this->size_y = size_y;
+		this->chunks.assign((size_t(size_y) << log_x) >> (2 * CHUNK_BITS), nullptr);
+	}
+
+	/**
+	 * Check whether the index was set up for a map size.
+	 * @param log_x Base 2 logarithm of the map width.
+	 * @param size_y Height of the map.
+	 * @return True if the map size matches.
+	 */
+	bool matches(uint log_x, uint size_y) const
+	{
+		return this->log_x == log_x && this->size_y == size_y;
+	}
+
+	size_t size() const { return this->count; }
+
+	/**
+	 * Add an item on a tile.
+	 * @param tile The tile.
+	 * @param item The item, which must not be in the index yet.
+	 */
+	void insert(uint32_t tile, T *item)
+	{
+		Bucket *&b = this->chunks[this->ChunkOfTile(tile)];
+		if (b == nullptr) {
+			b = Bucket::Allocate(4);
+		} else if (b->count == b->capacity) {
+			Bucket *grown = Bucket::Allocate(b->capacity * 2);
+			grown->count = b->count;
+			std::copy_n(b->Tiles(), b->count, grown->Tiles());
+			std::copy_n(b->Items(), b->count, grown->Items());
+			free(b);
+			b = grown;
+		}
+
+		item->*POS = b->count;
+		b->Tiles()[b->count] = tile;
+		b->Items()[b->count] = item;
+		b->count++;
+		this->count++;
+	}
+
+	/**
+	 * Remove an item from a tile.
+	 * @param tile The tile the item was added on.
+	 * @param item The item.
+	 */
+	void remove(uint32_t tile, T *item)
+	{
+		Bucket *b = this->chunks[this->ChunkOfTile(tile)];
+		assert(b != nullptr);
+
+		uint32_t pos = item->*POS;
+		assert(pos < b->count && b->Items()[pos] == item && b->Tiles()[pos] == tile);
+
+		/* Move the last item into the gap. */
+		b->count--;
+		if (pos != b->count) {
+			b->Tiles()[pos] = b->Tiles()[b->count];
+			b->Items()[pos] = b->Items()[b->count];
+			b->Items()[pos]->*POS = pos;
+		}
+		this->count--;
+	}
+
+	/**
+	 * Check whether an item is in the index on a tile.
+	 * @param tile The tile.
+	 * @param item The item.
+	 * @return True if the item is on the tile.
+	 */
+	bool contains(uint32_t tile, const T *item) const
+	{
+		uint32_t chunk = this->ChunkOfTile(tile);
+		if (chunk >= this->chunks.size() || this->chunks[chunk] == nullptr) return false;
+
+		const Bucket *b = this->chunks[chunk];
+		uint32_t pos = item->*POS;
+		return pos < b->count && b->Items()[pos] == item && b->Tiles()[pos] == tile;
+	}
+
+	/**
+	 * Call a function for every item on a tile.
+	 * @param tile The tile.
+	 * @param func The function, which returns true to stop the iteration.
+	 * @return True if the iteration was stopped.
+	 */
+	template <typename F>
+	bool for_each(uint32_t tile, F func) const
+	{
+		uint32_t chunk = this->ChunkOfTile(tile);
+		if (chunk >= this->chunks.size()) return false;
+
+		for (uint32_t i = 0; this->chunks[chunk] != nullptr && i < this->chunks[chunk]->count; i++) {
+			const Bucket *b = this->chunks[chunk];
+			if (b->Tiles()[i] == tile && func(b->Items()[i])) return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Call a function for every item on a tile in an area, the area is clipped to the map.
+	 * @param xl The lowest X coordinate of the area.
+	 * @param yl The lowest Y coordinate of the area.
+	 * @param xu The highest X coordinate of the area.
+	 * @param yu The highest Y coordinate of the area.
+	 * @param func The function, which returns true to stop the iteration.
+	 * @return True if the iteration was stopped.
+	 */
+	template <typename F>
+	bool for_each_in_area(int xl, int yl, int xu, int yu, F func) const
+	{
+		if (this->chunks.empty()) return false;
+
+		xl = std::max(xl, 0);
+		yl = std::max(yl, 0);
+		xu = std::min<int>(xu, (1 << this->log_x) - 1);
+		yu = std::min<int>(yu, this->size_y - 1);
+		if (xl > xu || yl > yu) return false;
+
+		for (uint cy = (uint)yl >> CHUNK_BITS; cy <= (uint)yu >> CHUNK_BITS; cy++) {
+			for (uint cx = (uint)xl >> CHUNK_BITS; cx <= (uint)xu >> CHUNK_BITS; cx++) {
+				uint32_t chunk = this->ChunkOfXY(cx << CHUNK_BITS, cy << CHUNK_BITS);
+				if (this->IterateChunk(chunk, xl, yl, xu, yu, func)) return true;
+			}
+		}
+		return false;
+	}
+};
+
+#endif /* TILE_BUCKET_INDEX_HPP */
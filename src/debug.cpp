@@ -472,3 +472,13 @@ void DebugReconsiderSendRemoteMessages()
 
 	_debug_remote_console.store(enable);
 }
+
+/**
+ * Only write debug messages to stderr from now on.
+ * This is to be called in a child process created by fork(), which must not use the sockets and message queues of its parent.
+ */
+void DebugDetachForkedChild()
+{
+	_debug_socket = INVALID_SOCKET;
+	_debug_remote_console.store(false);
+}
@@ -146,5 +146,6 @@ char *DumpDesyncMsgLog(char *buffer, const char *last);
 
 void DebugSendRemoteMessages();
 void DebugReconsiderSendRemoteMessages();
+void DebugDetachForkedChild();
 
 #endif /* DEBUG_H */
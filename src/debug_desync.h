@@ -17,6 +17,8 @@ enum CheckCachesFlags : uint32_t {
 	CHECK_CACHE_GENERAL            = 1 <<  0,
 	CHECK_CACHE_INFRA_TOTALS       = 1 <<  1,
 	CHECK_CACHE_WATER_REGIONS      = 1 <<  2,
+	CHECK_CACHE_ROAD_REGIONS       = 1 <<  3,
+	CHECK_CACHE_RAIL_REGIONS       = 1 <<  4,
 	CHECK_CACHE_ALL                = UINT16_MAX,
 	CHECK_CACHE_EMIT_LOG           = 1 << 16,
 };
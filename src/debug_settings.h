@@ -23,6 +23,10 @@ enum ChickenBitFlags {
 	DCBF_CMD_NO_TEST_ALL               = 6,
 	DCBF_WATER_REGION_CLEAR            = 7,
 	DCBF_WATER_REGION_INIT_ALL         = 8,
+	DCBF_ROAD_REGION_CLEAR             = 9,
+	DCBF_ROAD_REGION_INIT_ALL          = 10,
+	DCBF_RAIL_REGION_CLEAR             = 11,
+	DCBF_RAIL_REGION_INIT_ALL          = 12,
 };
 
 inline bool HasChickenBit(ChickenBitFlags flag)
@@ -40,6 +44,7 @@ enum NewGRFOptimiserFlags {
 	NGOF_NO_OPT_VARACT2_INSERT_JUMPS    = 6,
 	NGOF_NO_OPT_VARACT2_CB_QUICK_EXIT   = 7,
 	NGOF_NO_OPT_VARACT2_PROC_INLINE     = 8,
+	NGOF_NO_OPT_VARACT2_BYTECODE        = 9,
 };
 
 inline bool HasGrfOptimiserFlag(NewGRFOptimiserFlags flag)
@@ -1455,16 +1455,17 @@ CargoPayment::~CargoPayment()
  * Handle payment for final delivery of the given cargo packet.
  * @param cp The cargo packet to pay for.
  * @param count The number of packets to pay for.
+ * @param periods_in_transit Number of cargo aging periods the packet has been in transit.
  * @param current_tile Current tile the payment is happening on.
  */
-void CargoPayment::PayFinalDelivery(CargoPacket *cp, uint count, TileIndex current_tile)
+void CargoPayment::PayFinalDelivery(CargoPacket *cp, uint count, uint16_t periods_in_transit, TileIndex current_tile)
 {
 	if (this->owner == nullptr) {
 		this->owner = Company::Get(this->front->owner);
 	}
 
 	/* Handle end of route payment */
-	Money profit = DeliverGoods(count, this->ct, this->current_station, cp->GetDistance(current_tile), cp->GetPeriodsInTransit(), this->owner, cp->GetSourceType(), cp->GetSourceID());
+	Money profit = DeliverGoods(count, this->ct, this->current_station, cp->GetDistance(current_tile), periods_in_transit, this->owner, cp->GetSourceType(), cp->GetSourceID());
 
 	profit -= cp->GetFeederShare(count);
 
@@ -1480,17 +1481,18 @@ void CargoPayment::PayFinalDelivery(CargoPacket *cp, uint count, TileIndex curre
  * Handle payment for transfer of the given cargo packet.
  * @param cp The cargo packet to pay for; actual payment won't be made!.
  * @param count The number of packets to pay for.
+ * @param periods_in_transit Number of cargo aging periods the packet has been in transit.
  * @param current_tile Current tile the payment is happening on.
  * @return The amount of money paid for the transfer.
  */
-Money CargoPayment::PayTransfer(CargoPacket *cp, uint count, TileIndex current_tile)
+Money CargoPayment::PayTransfer(CargoPacket *cp, uint count, uint16_t periods_in_transit, TileIndex current_tile)
 {
 	/* Pay transfer vehicle the difference between the payment for the journey from
 	 * the source to the current point, and the sum of the previous transfer payments */
 	Money profit = -cp->GetFeederShare(count) + GetTransportedGoodsIncome(
 			count,
 			cp->GetDistance(current_tile),
-			cp->GetPeriodsInTransit(),
+			periods_in_transit,
 			this->ct);
 
 	profit = profit * _settings_game.economy.feeder_payment_share / 100;
@@ -193,6 +193,17 @@ namespace {
 		PerformanceData(1),                     // PFE_ACC_GL_SHIPS
 		PerformanceData(1),                     // PFE_ACC_GL_AIRCRAFT
 		PerformanceData(1),                     // PFE_GL_LANDSCAPE
+		PerformanceData(1),                     // PFE_GL_TILE_CLEAR
+		PerformanceData(1),                     // PFE_GL_TILE_RAILWAY
+		PerformanceData(1),                     // PFE_GL_TILE_ROAD
+		PerformanceData(1),                     // PFE_GL_TILE_HOUSE
+		PerformanceData(1),                     // PFE_GL_TILE_TREES
+		PerformanceData(1),                     // PFE_GL_TILE_STATION
+		PerformanceData(1),                     // PFE_GL_TILE_WATER
+		PerformanceData(1),                     // PFE_GL_TILE_VOID
+		PerformanceData(1),                     // PFE_GL_TILE_INDUSTRY
+		PerformanceData(1),                     // PFE_GL_TILE_TUNNELBRIDGE
+		PerformanceData(1),                     // PFE_GL_TILE_OBJECT
 		PerformanceData(1),                     // PFE_GL_LINKGRAPH
 		PerformanceData(1000.0 / 30),           // PFE_DRAWING
 		PerformanceData(1),                     // PFE_ACC_DRAWWORLD
@@ -320,6 +331,16 @@ void PerformanceAccumulator::Reset(PerformanceElement elem)
 	_pf_data[elem].BeginAccumulate(GetPerformanceTimer());
 }
 
+/**
+ * Add a separately measured duration to the accumulating value.
+ * @param elem The element to add to
+ * @param duration Duration in microseconds
+ */
+/* static */ void PerformanceAccumulator::Add(PerformanceElement elem, TimingMeasurement duration)
+{
+	_pf_data[elem].AddAccumulate(duration);
+}
+
 
 void ShowFrametimeGraphWindow(PerformanceElement elem);
 
@@ -332,6 +353,17 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_GL_SHIPS,
 	PFE_GL_AIRCRAFT,
 	PFE_GL_LANDSCAPE,
+	PFE_GL_TILE_CLEAR,
+	PFE_GL_TILE_RAILWAY,
+	PFE_GL_TILE_ROAD,
+	PFE_GL_TILE_HOUSE,
+	PFE_GL_TILE_TREES,
+	PFE_GL_TILE_STATION,
+	PFE_GL_TILE_WATER,
+	PFE_GL_TILE_VOID,
+	PFE_GL_TILE_INDUSTRY,
+	PFE_GL_TILE_TUNNELBRIDGE,
+	PFE_GL_TILE_OBJECT,
 	PFE_ALLSCRIPTS,
 	PFE_GAMESCRIPT,
 	PFE_AI0,
@@ -1022,6 +1054,16 @@ void ShowFramerateWindow()
 	AllocateWindowDescFront<FramerateWindow>(&_framerate_display_desc, 0);
 }
 
+/**
+ * Check whether detailed measurements, which are too costly to always collect, should be taken.
+ * This is the case whilst any frame rate or frame time graph window is open.
+ * @return true if detailed measurements are requested.
+ */
+bool IsPerformanceBreakdownRequested()
+{
+	return FindWindowByClass(WC_FRAMERATE_DISPLAY) != nullptr || FindWindowByClass(WC_FRAMETIME_GRAPH) != nullptr;
+}
+
 /** Open a graph window for a performance element */
 void ShowFrametimeGraphWindow(PerformanceElement elem)
 {
@@ -1046,6 +1088,17 @@ void ConPrintFramerate()
 		"  GL ship ticks",
 		"  GL aircraft ticks",
 		"  GL landscape ticks",
+		"   GL clear tile loop",
+		"   GL rail tile loop",
+		"   GL road tile loop",
+		"   GL house tile loop",
+		"   GL tree tile loop",
+		"   GL station tile loop",
+		"   GL water tile loop",
+		"   GL void tile loop",
+		"   GL industry tile loop",
+		"   GL tunnel/bridge tile loop",
+		"   GL object tile loop",
 		"  GL link graph delays",
 		"Drawing",
 		"  Viewport drawing",
@@ -53,6 +53,17 @@ enum PerformanceElement {
 	PFE_GL_SHIPS,      ///< Time spent processing ships
 	PFE_GL_AIRCRAFT,   ///< Time spent processing aircraft
 	PFE_GL_LANDSCAPE,  ///< Time spent processing other world features
+	PFE_GL_TILE_CLEAR,        ///< Time spent in the tile loop of clear tiles
+	PFE_GL_TILE_RAILWAY,      ///< Time spent in the tile loop of rail tiles
+	PFE_GL_TILE_ROAD,         ///< Time spent in the tile loop of road tiles
+	PFE_GL_TILE_HOUSE,        ///< Time spent in the tile loop of house tiles
+	PFE_GL_TILE_TREES,        ///< Time spent in the tile loop of tree tiles
+	PFE_GL_TILE_STATION,      ///< Time spent in the tile loop of station tiles
+	PFE_GL_TILE_WATER,        ///< Time spent in the tile loop of water tiles
+	PFE_GL_TILE_VOID,         ///< Time spent in the tile loop of void tiles
+	PFE_GL_TILE_INDUSTRY,     ///< Time spent in the tile loop of industry tiles
+	PFE_GL_TILE_TUNNELBRIDGE, ///< Time spent in the tile loop of tunnel and bridge tiles
+	PFE_GL_TILE_OBJECT,       ///< Time spent in the tile loop of object tiles
 	PFE_GL_LINKGRAPH,  ///< Time spent waiting for link graph background jobs
 	PFE_DRAWING,       ///< Speed of drawing world and GUI.
 	PFE_DRAWWORLD,     ///< Time spent drawing world viewports in GUI
@@ -118,9 +129,11 @@ public:
 	PerformanceAccumulator(PerformanceElement elem);
 	~PerformanceAccumulator();
 	static void Reset(PerformanceElement elem);
+	static void Add(PerformanceElement elem, TimingMeasurement duration);
 };
 
 void ShowFramerateWindow();
+bool IsPerformanceBreakdownRequested();
 void ProcessPendingPerformanceMeasurements();
 
 #endif /* FRAMERATE_TYPE_H */
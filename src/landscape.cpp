@@ -29,7 +29,9 @@
 #include "object_base.h"
 #include "company_func.h"
 #include "tunnelbridge_map.h"
+#include "road_map.h"
 #include "pathfinder/npf/aystar.h"
+#include "pathfinder/road_regions.h"
 #include "sl/saveload.h"
 #include "framerate_type.h"
 #include "town.h"
@@ -37,8 +39,13 @@
 #include "scope_info.h"
 #include "core/ring_buffer.hpp"
 #include "network/network_sync.h"
+#include "clear_func.h"
+#include "settings_type.h"
+#include "worker_thread.h"
 #include <array>
+#include <chrono>
 #include <list>
+#include <optional>
 #include <set>
 
 #include "table/strings.h"
@@ -486,6 +493,8 @@ void DoClearSquare(TileIndex tile)
 	/* If the tile can have animation and we clear it, delete it from the animated tile list. */
 	if (_tile_type_procs[GetTileType(tile)]->animate_tile_proc != nullptr) DeleteAnimatedTile(tile);
 
+	if (MayHaveRoad(tile)) InvalidateRoadRegion(tile);
+
 	MakeClear(tile, CLEAR_GRASS, _generating_world ? 3 : 0);
 	MarkTileDirtyByTile(tile);
 }
@@ -746,6 +755,249 @@ void SetupTileLoopCounts()
 	if (accumulator > 0) _tile_loop_counts[0]++;
 }
 
+/** Whether the time spent in the tile loop is measured per tile type, see IsPerformanceBreakdownRequested. */
+static bool _tile_loop_type_timing = false;
+
+/**
+ * Start a new measurement cycle of the per tile type tile loop performance elements.
+ * These are only measured whilst a frame rate window is open.
+ */
+void ResetTileLoopPerformance()
+{
+	_tile_loop_type_timing = IsPerformanceBreakdownRequested();
+	for (PerformanceElement e = PFE_GL_TILE_CLEAR; e <= PFE_GL_TILE_OBJECT; e++) {
+		if (_tile_loop_type_timing) {
+			PerformanceAccumulator::Reset(e);
+		} else {
+			PerformanceMeasurer::SetInactive(e);
+		}
+	}
+}
+
+/**
+ * Accumulates the time spent in the tile loop per tile type.
+ * Time is only taken when the tile type changes between consecutive tiles, to keep the overhead low.
+ */
+class TileLoopTypeTimer {
+	using Clock = std::chrono::steady_clock;
+
+	std::array<Clock::duration, MP_OBJECT + 1> durations{};
+	Clock::time_point start;
+	TileType type = MP_VOID;
+
+public:
+	TileLoopTypeTimer() : start(Clock::now()) {}
+
+	/**
+	 * Attribute the time from now on to a tile type.
+	 * @param type The tile type.
+	 */
+	inline void Enter(TileType type)
+	{
+		if (type == this->type) return;
+		Clock::time_point now = Clock::now();
+		this->durations[this->type] += now - this->start;
+		this->start = now;
+		this->type = type;
+	}
+
+	/** Add the accumulated durations to the performance elements. */
+	~TileLoopTypeTimer()
+	{
+		this->durations[this->type] += Clock::now() - this->start;
+		for (uint type = 0; type < this->durations.size(); type++) {
+			PerformanceAccumulator::Add(static_cast<PerformanceElement>(PFE_GL_TILE_CLEAR + type),
+					std::chrono::duration_cast<std::chrono::microseconds>(this->durations[type]).count());
+		}
+	}
+};
+static_assert(PFE_GL_TILE_OBJECT - PFE_GL_TILE_CLEAR == MP_OBJECT - MP_CLEAR);
+
+/** Number of tiles of a tile loop batch which are classified by one task of the parallel tile loop. */
+static const size_t TILE_LOOP_PARALLEL_CHUNK = 4096;
+
+/**
+ * Distance from a tile within which its tile loop proc may change other tiles without executing a command.
+ * Changes of unbounded extent are only made by executing commands, see #_docommand_exec_count.
+ */
+static const uint TILE_LOOP_PROC_REACH = 2;
+
+/** Log2 of the edge length of the square areas in which changes made during a parallel tile loop batch are tracked. */
+static const uint TILE_LOOP_CHANGE_AREA_BITS = 2;
+
+/** Flag in ParallelTileLoop::classes for tiles whose tile loop proc is known to do nothing. */
+static const uint8_t TILE_LOOP_CLASS_NO_OP = 0x80;
+
+/**
+ * Check, without side effects, whether the tile loop proc of a tile would leave the tile and the game state untouched.
+ * This must only read the map, as it is called from worker threads.
+ * @param tile The tile.
+ * @return true if the tile loop proc of \a tile is known to do nothing, false if it may do something.
+ */
+static bool IsTileLoopNoOp(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case MP_CLEAR: return IsClearTileLoopNoOp(tile);
+		case MP_WATER: return IsWaterTileLoopNoOp(tile);
+		default:       return false;
+	}
+}
+
+/**
+ * Parallel tile loop engine.
+ *
+ * Each batch of the tile loop is processed in two phases:
+ * - The tiles of the batch are classified in stripes of the LFSR sequence on the worker threads,
+ *   by read-only checks of whether their tile loop proc would do nothing at all. The map is not changed whilst this happens.
+ * - The batch is committed in LFSR order on the main thread, running the tile loop procs of all tiles which were not classified as doing nothing.
+ *
+ * A tile loop proc run in the second phase may change the map such that a classification from the first phase no longer holds.
+ * Therefore the areas around all tiles whose procs were run are recorded, and tiles within these areas,
+ * or any tile after a command was executed, have their tile loop proc run as normal.
+ * The procs which are skipped neither change the map nor use the random number generator,
+ * so the resulting game state is identical to that of the serial tile loop.
+ */
+struct ParallelTileLoop {
+	std::vector<TileIndex> tiles;         ///< Tiles of the current batch, in LFSR order.
+	std::vector<uint8_t> classes;         ///< Tile type of each tile of the current batch at the start of the batch, with #TILE_LOOP_CLASS_NO_OP if its proc does nothing.
+	std::vector<uint64_t> changed;        ///< Bitmap of change areas which may have been changed during the current batch.
+	std::vector<uint32_t> changed_words;  ///< Indices of the non-zero words of #changed.
+	uint area_log_x = 0;                  ///< Log2 of the number of change areas in the x direction.
+	/** Classify all tiles of the current batch, using the general worker pool. */
+	void Classify()
+	{
+		this->classes.resize(this->tiles.size());
+
+		_general_worker_pool.ParallelFor(0, this->tiles.size(), TILE_LOOP_PARALLEL_CHUNK, [this](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				const TileIndex tile = this->tiles[i];
+				this->classes[i] = GetTileType(tile) | (IsTileLoopNoOp(tile) ? TILE_LOOP_CLASS_NO_OP : 0);
+			}
+		});
+	}
+
+	/** Prepare the change area bitmap for the current map size. */
+	void PrepareChanged()
+	{
+		this->area_log_x = MapLogX() - TILE_LOOP_CHANGE_AREA_BITS;
+		const size_t words = CeilDivT<size_t>(MapSize() >> (2 * TILE_LOOP_CHANGE_AREA_BITS), 64);
+		if (this->changed.size() != words) {
+			this->changed.assign(words, 0);
+			this->changed_words.clear();
+		}
+	}
+
+	inline uint GetArea(uint x, uint y) const
+	{
+		return ((y >> TILE_LOOP_CHANGE_AREA_BITS) << this->area_log_x) | (x >> TILE_LOOP_CHANGE_AREA_BITS);
+	}
+
+	/**
+	 * Record that the tile loop proc of a tile was run, such that all tiles whose classification may depend on tiles it changed are marked.
+	 * @param tile The tile whose tile loop proc was run.
+	 */
+	void MarkChanged(TileIndex tile)
+	{
+		/* Classifications also depend on the direct neighbours of the classified tile. */
+		const uint reach = TILE_LOOP_PROC_REACH + 1;
+		const uint x = TileX(tile);
+		const uint y = TileY(tile);
+		const uint x0 = x - std::min(x, reach);
+		const uint x1 = std::min(x + reach, MapMaxX());
+		const uint y0 = y - std::min(y, reach);
+		const uint y1 = std::min(y + reach, MapMaxY());
+		for (uint ay = y0 >> TILE_LOOP_CHANGE_AREA_BITS; ay <= y1 >> TILE_LOOP_CHANGE_AREA_BITS; ay++) {
+			for (uint ax = x0 >> TILE_LOOP_CHANGE_AREA_BITS; ax <= x1 >> TILE_LOOP_CHANGE_AREA_BITS; ax++) {
+				const uint area = (ay << this->area_log_x) | ax;
+				uint64_t &word = this->changed[area / 64];
+				if (word == 0) this->changed_words.push_back(area / 64);
+				word |= (uint64_t)1 << (area % 64);
+			}
+		}
+	}
+
+	inline bool IsChanged(TileIndex tile) const
+	{
+		const uint area = this->GetArea(TileX(tile), TileY(tile));
+		return HasBit(this->changed[area / 64], area % 64);
+	}
+
+	void ResetChanged()
+	{
+		for (uint32_t word : this->changed_words) this->changed[word] = 0;
+		this->changed_words.clear();
+	}
+};
+
+static ParallelTileLoop _parallel_tile_loop;
+
+/**
+ * Run a batch of the tile loop one tile at a time.
+ * @param tile First tile of the batch.
+ * @param count Number of tiles in the batch.
+ * @param feedback LFSR feedback term.
+ * @param timer Per tile type timer, or nullptr.
+ * @return The tile following the batch.
+ */
+static TileIndex RunSerialTileLoop(TileIndex tile, uint count, const uint32_t feedback, TileLoopTypeTimer *timer)
+{
+	while (count--) {
+		/* Get the next tile in sequence using a Galois LFSR. */
+		TileIndex next = (tile >> 1) ^ (-(int32_t)(tile & 1) & feedback);
+		if (count > 0) {
+			PREFETCH_NTA(&_m[next]);
+		}
+
+		if (timer != nullptr) timer->Enter(GetTileType(tile));
+		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+
+		tile = next;
+	}
+	return tile;
+}
+
+/**
+ * Run a batch of the tile loop using the parallel tile loop engine, see ParallelTileLoop.
+ * @param tile First tile of the batch.
+ * @param count Number of tiles in the batch.
+ * @param feedback LFSR feedback term.
+ * @param timer Per tile type timer, or nullptr.
+ * @return The tile following the batch.
+ */
+static TileIndex RunParallelTileLoop(TileIndex tile, uint count, const uint32_t feedback, TileLoopTypeTimer *timer)
+{
+	ParallelTileLoop &state = _parallel_tile_loop;
+
+	state.tiles.resize(count);
+	for (TileIndex &t : state.tiles) {
+		t = tile;
+		tile = (tile >> 1) ^ (-(int32_t)(tile & 1) & feedback);
+	}
+
+	state.Classify();
+	state.PrepareChanged();
+
+	const uint64_t exec_count = _docommand_exec_count;
+	for (uint i = 0; i < count; i++) {
+		const TileIndex t = state.tiles[i];
+		if (i + 1 < count && (state.classes[i + 1] & TILE_LOOP_CLASS_NO_OP) == 0) {
+			PREFETCH_NTA(&_m[state.tiles[i + 1]]);
+		}
+
+		if ((state.classes[i] & TILE_LOOP_CLASS_NO_OP) != 0 && _docommand_exec_count == exec_count && !state.IsChanged(t)) {
+			if (timer != nullptr) timer->Enter(static_cast<TileType>(state.classes[i] & ~TILE_LOOP_CLASS_NO_OP));
+			continue;
+		}
+
+		if (timer != nullptr) timer->Enter(GetTileType(t));
+		_tile_type_procs[GetTileType(t)]->tile_loop_proc(t);
+		state.MarkChanged(t);
+	}
+
+	state.ResetChanged();
+	return tile;
+}
+
 /**
  * Gradually iterate over all tiles on the map, calling their TileLoopProcs once every 256 ticks.
  */
@@ -776,16 +1028,13 @@ void RunTileLoop(bool apply_day_length)
 		count--;
 	}
 
-	while (count--) {
-		/* Get the next tile in sequence using a Galois LFSR. */
-		TileIndex next = (tile >> 1) ^ (-(int32_t)(tile & 1) & feedback);
-		if (count > 0) {
-			PREFETCH_NTA(&_m[next]);
-		}
-
-		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+	std::optional<TileLoopTypeTimer> timer;
+	if (_tile_loop_type_timing) timer.emplace();
 
-		tile = next;
+	if (_settings_client.gui.parallel_tile_loop && count >= 2 * TILE_LOOP_PARALLEL_CHUNK) {
+		tile = RunParallelTileLoop(tile, count, feedback, timer.has_value() ? &*timer : nullptr);
+	} else {
+		tile = RunSerialTileLoop(tile, count, feedback, timer.has_value() ? &*timer : nullptr);
 	}
 
 	_cur_tileloop_tile = tile;
@@ -170,6 +170,7 @@ void DoClearSquare(TileIndex tile);
 void SetupTileLoopCounts();
 void RunTileLoop(bool apply_day_length = false);
 void RunAuxiliaryTileLoop();
+void ResetTileLoopPerformance();
 
 void InitializeLandscape();
 void GenerateLandscape(byte mode);
@@ -3,6 +3,7 @@
 #include "../stdafx.h"
 #include "demands.h"
 #include "../core/ring_buffer_queue.hpp"
+#include "../worker_thread.h"
 #include <algorithm>
 #include <tuple>
 
@@ -347,6 +348,51 @@ void DemandCalculator::CalcDemand(LinkGraphJob &job, const std::vector<bool> &re
 	}
 }
 
+/** Possible assignment of demand from a supplying node to an accepting node. */
+struct EdgeCandidate {
+	NodeID from_id;
+	NodeID to_id;
+	uint distance;
+
+	bool operator<(const EdgeCandidate &other) const
+	{
+		return std::tie(this->distance, this->from_id, this->to_id) < std::tie(other.distance, other.from_id, other.to_id);
+	}
+};
+
+static const size_t CANDIDATE_SUPPLY_GRAIN = 64;      ///< Number of supplying nodes per task when collecting edge candidates.
+static const size_t CANDIDATE_SORT_GRAIN = 1 << 16;   ///< Number of edge candidates per task when sorting.
+
+/**
+ * Sort edge candidates by distance, using the worker pool for large numbers of candidates.
+ * Runs of candidates are sorted in parallel and then merged pairwise.
+ * No two candidates compare equal, so the result is the same as that of a single std::sort.
+ * @param candidates Candidates to sort.
+ */
+static void SortEdgeCandidates(std::vector<EdgeCandidate> &candidates)
+{
+	const size_t count = candidates.size();
+	if (count <= CANDIDATE_SORT_GRAIN || _general_worker_pool.GetWorkerCount() == 0) {
+		std::sort(candidates.begin(), candidates.end());
+		return;
+	}
+
+	_general_worker_pool.ParallelFor(0, count, CANDIDATE_SORT_GRAIN, [&](size_t begin, size_t end) {
+		std::sort(candidates.begin() + begin, candidates.begin() + end);
+	});
+	for (size_t run = CANDIDATE_SORT_GRAIN; run < count; run *= 2) {
+		const size_t merges = CeilDivT<size_t>(count, 2 * run);
+		_general_worker_pool.ParallelFor(0, merges, 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				const size_t first = i * 2 * run;
+				const size_t middle = std::min(first + run, count);
+				const size_t last = std::min(first + 2 * run, count);
+				std::inplace_merge(candidates.begin() + first, candidates.begin() + middle, candidates.begin() + last);
+			}
+		});
+	}
+}
+
 /**
  * Do the actual demand calculation, called from constructor.
  * @param job Job to calculate the demands for.
@@ -375,23 +421,30 @@ void DemandCalculator::CalcMinimisedDistanceDemand(LinkGraphJob &job, const std:
 	scaler.SetDemandPerNode((uint)demands.size());
 	scaler.AdjustDemandNodes(job, demands);
 
-	struct EdgeCandidate {
-		NodeID from_id;
-		NodeID to_id;
-		uint distance;
-	};
-	std::vector<EdgeCandidate> candidates;
-	candidates.reserve(supplies.size() * demands.size() - std::min(supplies.size(), demands.size()));
-	for (NodeID from_id : supplies) {
-		for (NodeID to_id : demands) {
-			if (from_id != to_id) {
-				candidates.push_back({ from_id, to_id, DistanceMaxPlusManhattan(job[from_id].XY(), job[to_id].XY()) });
+	/* Each supply gets its own range of candidates, so that these can be filled in parallel. */
+	std::vector<bool> is_demand(job.Size());
+	for (NodeID to_id : demands) {
+		is_demand[to_id] = true;
+	}
+	std::vector<size_t> first_candidate(supplies.size() + 1);
+	for (size_t i = 0; i < supplies.size(); i++) {
+		first_candidate[i + 1] = first_candidate[i] + demands.size() - (is_demand[supplies[i]] ? 1 : 0);
+	}
+
+	std::vector<EdgeCandidate> candidates(first_candidate.back());
+	_general_worker_pool.ParallelFor(0, supplies.size(), CANDIDATE_SUPPLY_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			const NodeID from_id = supplies[i];
+			EdgeCandidate *candidate = candidates.data() + first_candidate[i];
+			for (NodeID to_id : demands) {
+				if (from_id != to_id) {
+					*candidate++ = { from_id, to_id, DistanceMaxPlusManhattan(job[from_id].XY(), job[to_id].XY()) };
+				}
 			}
 		}
-	}
-	std::sort(candidates.begin(), candidates.end(), [](const EdgeCandidate &a, const EdgeCandidate &b) {
-		return std::tie(a.distance, a.from_id, a.to_id) < std::tie(b.distance, b.from_id, b.to_id);
 	});
+	SortEdgeCandidates(candidates);
+
 	for (const EdgeCandidate &candidate : candidates) {
 		if (job[candidate.from_id].UndeliveredSupply() == 0) continue;
 		if (!scaler.HasDemandLeft(job[candidate.to_id])) continue;
@@ -17,6 +17,9 @@
 #include "../command_func.h"
 #include "../network/network.h"
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "../safeguards.h"
 
@@ -267,8 +270,28 @@ void LinkGraphJobGroup::JoinThread()
 /* static */ void LinkGraphJobGroup::Run(void *group)
 {
 	LinkGraphJobGroup *job_group = (LinkGraphJobGroup *)group;
-	for (LinkGraphJob *job : job_group->jobs) {
-		LinkGraphSchedule::Run(job);
+	const size_t count = job_group->jobs.size();
+
+	/* The jobs of a group don't share any state, so they can be run concurrently.
+	 * Like the group itself they get their own threads rather than workers of the pool, as they can run for many ticks.
+	 * At most half of the hardware threads are used, the game loop and its worker pool need the others. */
+	const uint helpers = (uint)std::min<size_t>(std::thread::hardware_concurrency() / 2, count - 1);
+
+	std::atomic<size_t> next_job = 0;
+	auto run_jobs = [job_group, count, &next_job]() {
+		for (size_t i = next_job++; i < count; i = next_job++) {
+			LinkGraphSchedule::Run(job_group->jobs[i]);
+		}
+	};
+
+	/* If a helper can't be started, its share of the jobs is run by the other threads. */
+	std::vector<std::thread> threads(helpers);
+	for (std::thread &thread : threads) {
+		StartNewThread(&thread, "ottd:linkgraph", [&run_jobs]() { run_jobs(); });
+	}
+	run_jobs();
+	for (std::thread &thread : threads) {
+		if (thread.joinable()) thread.join();
 	}
 }
 
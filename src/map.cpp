@@ -15,6 +15,8 @@
 #include "rail_map.h"
 #include "tunnelbridge_map.h"
 #include "pathfinder/water_regions.h"
+#include "pathfinder/road_regions.h"
+#include "pathfinder/rail_regions.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 #include "core/ring_buffer.hpp"
 #include <array>
@@ -136,6 +138,8 @@ void AllocateMap(uint size_x, uint size_y)
 	_me = reinterpret_cast<TileExtended *>(buf + (_map_size * sizeof(Tile)));
 
 	InitializeWaterRegions();
+	InitializeRoadRegions();
+	InitializeRailRegions();
 }
 
 
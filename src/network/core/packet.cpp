@@ -16,8 +16,20 @@
 
 #include "packet.h"
 
+#include <mutex>
+
 #include "../../safeguards.h"
 
+/** Maximum number of sent packets that are kept for reuse by Packet::Create. */
+static const size_t PACKET_POOL_SIZE = 128;
+/** Maximum capacity of the buffer of a packet that is kept for reuse. */
+static const size_t PACKET_POOL_MAX_CAPACITY = COMPAT_MTU;
+
+/** Sent packets whose buffers can be reused. */
+static std::vector<std::unique_ptr<Packet>> _packet_pool;
+/** Mutex for #_packet_pool, as packets can also be sent by the network thread. */
+static std::mutex _packet_pool_mutex;
+
 /**
  * Create a packet that is used to read from a network socket.
  * @param cs                The socket handler associated with the socket we are reading from.
@@ -51,6 +63,59 @@ Packet::Packet(PacketType type, size_t limit) : pos(0), limit(limit), cs(nullptr
 	this->ResetState(type);
 }
 
+/**
+ * Creates a packet to send, reusing the buffer of an already sent packet when possible.
+ * @param type  The type of the packet to send.
+ * @param limit The maximum number of bytes the packet may have.
+ * @return The packet.
+ */
+/* static */ std::unique_ptr<Packet> Packet::Create(PacketType type, size_t limit)
+{
+	std::unique_ptr<Packet> packet;
+	{
+		std::lock_guard<std::mutex> lock(_packet_pool_mutex);
+		if (!_packet_pool.empty()) {
+			packet = std::move(_packet_pool.back());
+			_packet_pool.pop_back();
+		}
+	}
+	if (packet == nullptr) return std::make_unique<Packet>(type, limit);
+
+	packet->pos = 0;
+	packet->limit = limit;
+	packet->ResetState(type);
+	return packet;
+}
+
+/**
+ * Prepare a packet for sending, after which it is not modified anymore and can be
+ * queued for any number of sockets. Once the last socket has sent the packet, it
+ * is returned to the pool of Packet::Create.
+ * @param packet The packet to send.
+ * @return The shared packet.
+ */
+/* static */ SharedPacket Packet::Share(std::unique_ptr<Packet> packet)
+{
+	packet->PrepareToSend();
+	return SharedPacket(packet.release(), &Packet::Recycle);
+}
+
+/**
+ * Return a sent packet to the pool, or free it when the pool is full or its buffer is too large to keep around.
+ * @param packet The packet that is not referenced anymore.
+ */
+/* static */ void Packet::Recycle(Packet *packet)
+{
+	if (packet->buffer.capacity() <= PACKET_POOL_MAX_CAPACITY) {
+		std::lock_guard<std::mutex> lock(_packet_pool_mutex);
+		if (_packet_pool.size() < PACKET_POOL_SIZE) {
+			_packet_pool.emplace_back(packet);
+			return;
+		}
+	}
+	delete packet;
+}
+
 void Packet::ResetState(PacketType type)
 {
 	this->cs = nullptr;
@@ -72,7 +137,8 @@ void Packet::PrepareToSend()
 	this->buffer[1] = GB(this->Size(), 8, 8);
 
 	this->pos  = 0; // We start reading from here
-	this->buffer.shrink_to_fit();
+	/* Small buffers are kept as they are, so they can be reused once the packet is sent. */
+	if (this->buffer.capacity() > PACKET_POOL_MAX_CAPACITY) this->buffer.shrink_to_fit();
 }
 
 /**
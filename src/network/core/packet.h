@@ -20,11 +20,19 @@
 #include <string>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <vector>
 
 typedef uint16_t PacketSize; ///< Size of the whole packet.
 typedef uint8_t  PacketType; ///< Identifier for the packet
 
+struct Packet;
+/**
+ * A packet that has been prepared for sending, see Packet::Share.
+ * It is not modified anymore, so the same packet can be queued for several sockets.
+ */
+typedef std::shared_ptr<const Packet> SharedPacket;
+
 /**
  * Internal entity of a packet. As everything is sent as a packet,
  * all network communication will need to call the functions that
@@ -60,6 +68,10 @@ public:
 	Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size = sizeof(PacketSize));
 	Packet(PacketType type, size_t limit = COMPAT_MTU);
 
+	static std::unique_ptr<Packet> Create(PacketType type, size_t limit = COMPAT_MTU);
+	static SharedPacket Share(std::unique_ptr<Packet> packet);
+	static void Recycle(Packet *packet);
+
 	void ResetState(PacketType type);
 
 	/* Sending/writing of packets */
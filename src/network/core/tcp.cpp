@@ -13,9 +13,17 @@
 #include "../../debug.h"
 
 #include "tcp.h"
+#include "tcp_io_thread.h"
+
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#	include <sys/uio.h>
+#endif
 
 #include "../../safeguards.h"
 
+/** Maximum number of queued packets to pass to the OS in a single call. */
+static const size_t SEND_BATCH_SIZE = 32;
+
 /**
  * Construct a socket handler for a TCP connection.
  * @param s The just opened TCP connection.
@@ -38,6 +46,7 @@ NetworkTCPSocketHandler::~NetworkTCPSocketHandler()
 void NetworkTCPSocketHandler::EmptyPacketQueue()
 {
 	this->packet_queue.clear();
+	this->packet_queue_sent = 0;
 	this->packet_recv.reset();
 }
 
@@ -48,6 +57,18 @@ void NetworkTCPSocketHandler::EmptyPacketQueue()
  */
 void NetworkTCPSocketHandler::CloseSocket()
 {
+	if (this->io != nullptr) {
+		/* The network thread sends what it can and then closes the socket. */
+		this->io->close.store(true);
+		this->io.reset();
+		NetworkIOThread::Wake();
+		this->sock = INVALID_SOCKET;
+		return;
+	}
+	if (this->poller != nullptr) {
+		this->poller->RemoveSocket(this->sock);
+		this->poller = nullptr;
+	}
 	if (this->sock != INVALID_SOCKET) closesocket(this->sock);
 	this->sock = INVALID_SOCKET;
 }
@@ -74,12 +95,10 @@ NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection([[maybe_unused]] bool
  * if the OS-network-buffer is full)
  * @param packet the packet to send
  */
-void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> packet)
+void NetworkTCPSocketHandler::SendPacket(SharedPacket packet)
 {
 	assert(packet != nullptr);
 
-	packet->PrepareToSend();
-
 	this->packet_queue.push_back(std::move(packet));
 }
 
@@ -89,12 +108,10 @@ void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> packet)
  * if the OS-network-buffer is full)
  * @param packet the packet to send
  */
-void NetworkTCPSocketHandler::SendPrependPacket(std::unique_ptr<Packet> packet, int queue_after_packet_type)
+void NetworkTCPSocketHandler::SendPrependPacket(SharedPacket packet, int queue_after_packet_type)
 {
 	assert(packet != nullptr);
 
-	packet->PrepareToSend();
-
 	if (queue_after_packet_type >= 0) {
 		for (auto iter = this->packet_queue.begin(); iter != this->packet_queue.end(); ++iter) {
 			if ((*iter)->GetPacketType() == queue_after_packet_type) {
@@ -123,121 +140,237 @@ void NetworkTCPSocketHandler::ShrinkToFitSendQueue()
 }
 
 /**
- * Sends all the buffered packets out for this client. It stops when:
- *   1) all packets are send (queue is empty)
- *   2) the OS reports back that it can not send any more
- *      data right now (full network-buffer, it happens ;))
- *   3) sending took too long
- * @param closing_down Whether we are closing down the connection.
- * @return \c true if a (part of a) packet could be sent and
- *         the connection is not closed yet.
+ * Sending to the socket would block, stop sending until the socket becomes writable again.
+ * Without a poller, this is checked by #CanSendReceive anyway.
  */
-SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
+void NetworkTCPSocketHandler::OnSendBlocked()
 {
-	ssize_t res;
+	if (this->poller == nullptr) return;
 
-	/* We can not write to this socket!! */
-	if (!this->writable) return SPS_NONE_SENT;
-	if (!this->IsConnected()) return SPS_CLOSED;
+	this->writable = false;
+	this->poller->WatchWritable(this->sock, true);
+}
 
-	while (!this->packet_queue.empty()) {
-		Packet *p = this->packet_queue.front().get();
-		res = p->TransferOut<int>(send, this->sock, 0);
+/**
+ * Pass the first packets of a send queue to the OS in a single call,
+ * using sendmsg or WSASend with a buffer for each packet.
+ * @param sock The socket to send to.
+ * @param queue The queued packets.
+ * @param first_sent The number of bytes of the first packet that have already been sent.
+ * @return The number of bytes that were sent, or -1 upon errors.
+ */
+static ssize_t SendPacketQueueBatch(SOCKET sock, const ring_buffer<SharedPacket> &queue, size_t first_sent)
+{
+#if defined(_WIN32)
+	WSABUF buffers[SEND_BATCH_SIZE];
+	DWORD count = 0;
+	size_t offset = first_sent;
+	for (const SharedPacket &p : queue) {
+		buffers[count].buf = const_cast<char *>(reinterpret_cast<const char *>(p->GetBufferData() + offset));
+		buffers[count].len = static_cast<ULONG>(p->Size() - offset);
+		offset = 0;
+		if (++count == SEND_BATCH_SIZE) break;
+	}
+
+	DWORD sent;
+	if (WSASend(sock, buffers, count, &sent, 0, nullptr, nullptr) != 0) return -1;
+	return sent;
+#elif defined(UNIX) && !defined(__EMSCRIPTEN__)
+	iovec buffers[SEND_BATCH_SIZE];
+	size_t count = 0;
+	size_t offset = first_sent;
+	for (const SharedPacket &p : queue) {
+		buffers[count].iov_base = const_cast<byte *>(p->GetBufferData() + offset);
+		buffers[count].iov_len = p->Size() - offset;
+		offset = 0;
+		if (++count == SEND_BATCH_SIZE) break;
+	}
+
+	msghdr msg{};
+	msg.msg_iov = buffers;
+	msg.msg_iovlen = count;
+	return sendmsg(sock, &msg, 0);
+#else
+	const Packet &p = *queue.front();
+	return send(sock, reinterpret_cast<const char *>(p.GetBufferData() + first_sent), p.Size() - first_sent, 0);
+#endif
+}
+
+/**
+ * Send queued packets until the queue is empty or the OS reports back that it
+ * can not send any more data right now (full network-buffer, it happens ;))
+ * @param sock The socket to send to.
+ * @param queue The queued packets, completely sent packets are removed from it.
+ * @param first_sent The number of bytes of the first packet that have already been sent.
+ * @param closing_down Whether we are closing down the connection, so failures need not be logged.
+ * @param log_handler The handler to log completely sent packets with, if any.
+ * @return #SPS_ALL_SENT, #SPS_PARTLY_SENT when sending would block, or #SPS_CLOSED when the connection got closed.
+ */
+/* static */ SendPacketsState NetworkTCPSocketHandler::SendPacketQueue(SOCKET sock, ring_buffer<SharedPacket> &queue, size_t &first_sent, bool closing_down, NetworkTCPSocketHandler *log_handler)
+{
+	while (!queue.empty()) {
+		ssize_t res = SendPacketQueueBatch(sock, queue, first_sent);
 		if (res == -1) {
 			NetworkError err = NetworkError::GetLast();
 			if (!err.WouldBlock()) {
 				/* Something went wrong.. close client! */
-				if (!closing_down) {
-					DEBUG(net, 0, "Send failed: %s", err.AsString());
-					this->CloseConnection();
-				}
+				if (!closing_down) DEBUG(net, 0, "Send failed: %s", err.AsString());
 				return SPS_CLOSED;
 			}
 			return SPS_PARTLY_SENT;
 		}
 		if (res == 0) {
 			/* Client/server has left us :( */
-			if (!closing_down) this->CloseConnection();
 			return SPS_CLOSED;
 		}
 
-		/* Is this packet sent? */
-		if (p->RemainingBytesToTransfer() == 0) {
+		/* Remove the packets that have been sent completely. */
+		size_t sent = res;
+		while (sent > 0) {
+			const Packet &p = *queue.front();
+			size_t remaining = p.Size() - first_sent;
+			if (sent < remaining) {
+				first_sent += sent;
+				break;
+			}
+
 			/* Go to the next packet */
-			if (_debug_net_level >= 5) this->LogSentPacket(*p);
-			this->packet_queue.pop_front();
-		} else {
-			return SPS_PARTLY_SENT;
+			sent -= remaining;
+			if (log_handler != nullptr && _debug_net_level >= 5) log_handler->LogSentPacket(p);
+			queue.pop_front();
+			first_sent = 0;
 		}
+
+		/* The OS did not accept everything, so its buffer is full. */
+		if (first_sent != 0) return SPS_PARTLY_SENT;
 	}
 
 	return SPS_ALL_SENT;
 }
 
 /**
- * Receives a packet for the given client
- * @return The received packet (or nullptr when it didn't receive one)
+ * Sends all the buffered packets out for this client. It stops when:
+ *   1) all packets are send (queue is empty)
+ *   2) the OS reports back that it can not send any more
+ *      data right now (full network-buffer, it happens ;))
+ *   3) sending took too long
+ * @param closing_down Whether we are closing down the connection.
+ * @return \c true if a (part of a) packet could be sent and
+ *         the connection is not closed yet.
  */
-std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
+SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 {
-	ssize_t res;
+	if (this->io != nullptr) return this->SendPacketsToIOThread(closing_down);
 
-	if (!this->IsConnected()) return nullptr;
+	/* We can not write to this socket!! */
+	if (!this->writable) return SPS_NONE_SENT;
+	if (!this->IsConnected()) return SPS_CLOSED;
 
-	if (this->packet_recv == nullptr) {
-		this->packet_recv.reset(new Packet(this, SHRT_MAX));
+	SendPacketsState state = SendPacketQueue(this->sock, this->packet_queue, this->packet_queue_sent, closing_down, this);
+	if (state == SPS_CLOSED && !closing_down) this->CloseConnection();
+	if (state == SPS_PARTLY_SENT) this->OnSendBlocked();
+	return state;
+}
+
+/**
+ * Hand the buffered packets over to the network thread, as far as its queue allows.
+ * @param closing_down Whether we are closing down the connection.
+ * @return #SPS_ALL_SENT when the network thread has sent everything, #SPS_PARTLY_SENT when
+ *         packets are still waiting to be sent, or #SPS_CLOSED when the connection got closed.
+ */
+SendPacketsState NetworkTCPSocketHandler::SendPacketsToIOThread(bool closing_down)
+{
+	/* Packets that were already received have to be handled before acting on the connection being closed. */
+	if (this->io->failed.load() && this->io->received.empty()) {
+		if (!closing_down) this->CloseConnection();
+		return SPS_CLOSED;
 	}
 
-	Packet *p = this->packet_recv.get();
+	bool queued = false;
+	while (!this->packet_queue.empty() && !this->io->outgoing.full()) {
+		/* The network thread does not log, so log the packets when they are handed over. */
+		if (_debug_net_level >= 5) this->LogSentPacket(*this->packet_queue.front());
+		this->io->unsent++;
+		this->io->outgoing.push(std::move(this->packet_queue.front()));
+		this->packet_queue.pop_front();
+		queued = true;
+	}
+	if (queued) NetworkIOThread::Wake();
+
+	if (!this->packet_queue.empty() || this->io->unsent.load() != 0) return SPS_PARTLY_SENT;
+	return SPS_ALL_SENT;
+}
+
+/**
+ * Whether there is something pending in the send queue.
+ * @return true when something is pending in the send queue.
+ */
+bool NetworkTCPSocketHandler::HasSendQueue() const
+{
+	return !this->packet_queue.empty() || (this->io != nullptr && this->io->unsent.load() != 0);
+}
+
+/**
+ * Receive (the rest of) a packet from a socket.
+ * @param sock The socket to receive from.
+ * @param cs The socket handler to associate the received packet with.
+ * @param packet_recv The partially received packet, if any.
+ * @param[out] packet The received packet, or nullptr when the packet is not complete yet.
+ * @return False when the connection got closed or failed.
+ */
+/* static */ bool NetworkTCPSocketHandler::ReceivePacketFromSocket(SOCKET sock, NetworkSocketHandler *cs, std::unique_ptr<Packet> &packet_recv, std::unique_ptr<Packet> &packet)
+{
+	ssize_t res;
+
+	if (packet_recv == nullptr) {
+		packet_recv.reset(new Packet(cs, SHRT_MAX));
+	}
+
+	Packet *p = packet_recv.get();
 
 	/* Read packet size */
 	if (!p->HasPacketSizeData()) {
 		while (p->RemainingBytesToTransfer() != 0) {
-			res = p->TransferIn<int>(recv, this->sock, 0);
+			res = p->TransferIn<int>(recv, sock, 0);
 			if (res == -1) {
 				NetworkError err = NetworkError::GetLast();
 				if (!err.WouldBlock()) {
 					/* Something went wrong... */
 					if (!err.IsConnectionReset()) DEBUG(net, 0, "Recv failed: %s", err.AsString());
-					this->CloseConnection();
-					return nullptr;
+					return false;
 				}
 				/* Connection would block, so stop for now */
-				return nullptr;
+				return true;
 			}
 			if (res == 0) {
 				/* Client/server has left */
-				this->CloseConnection();
-				return nullptr;
+				return false;
 			}
 		}
 
 		/* Parse the size in the received packet and if not valid, close the connection. */
 		if (!p->ParsePacketSize()) {
 			DEBUG(net, 0, "ParsePacketSize failed, possible packet stream corruption");
-			this->CloseConnection();
-			return nullptr;
+			return false;
 		}
 	}
 
 	/* Read rest of packet */
 	while (p->RemainingBytesToTransfer() != 0) {
-		res = p->TransferIn<int>(recv, this->sock, 0);
+		res = p->TransferIn<int>(recv, sock, 0);
 		if (res == -1) {
 			NetworkError err = NetworkError::GetLast();
 			if (!err.WouldBlock()) {
 				/* Something went wrong... */
 				if (!err.IsConnectionReset()) DEBUG(net, 0, "Recv failed: %s", err.AsString());
-				this->CloseConnection();
-				return nullptr;
+				return false;
 			}
 			/* Connection would block */
-			return nullptr;
+			return true;
 		}
 		if (res == 0) {
 			/* Client/server has left */
-			this->CloseConnection();
-			return nullptr;
+			return false;
 		}
 	}
 
@@ -245,7 +378,43 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 	p->PrepareToRead();
 
 	/* Prepare for receiving a new packet */
-	return std::move(this->packet_recv);
+	packet = std::move(packet_recv);
+	return true;
+}
+
+/**
+ * Receives a packet for the given client
+ * @return The received packet (or nullptr when it didn't receive one)
+ */
+std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
+{
+	if (this->io != nullptr) return this->ReceivePacketFromIOThread();
+
+	if (!this->IsConnected()) return nullptr;
+
+	std::unique_ptr<Packet> p;
+	if (!ReceivePacketFromSocket(this->sock, this, this->packet_recv, p)) this->CloseConnection();
+	return p;
+}
+
+/**
+ * Take a packet that was received by the network thread.
+ * @return The received packet (or nullptr when there is none)
+ */
+std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacketFromIOThread()
+{
+	/* The network thread sets failed after queueing the last packet, so check it first. */
+	bool failed = this->io->failed.load();
+
+	NetworkIOReceivedPacket received;
+	if (this->io->received.pop(received)) {
+		_network_io_stats.AddPacket(std::chrono::steady_clock::now() - received.time);
+		if (this->io->receive_blocked.load()) NetworkIOThread::Wake();
+		return std::move(received.packet);
+	}
+
+	if (failed) this->CloseConnection();
+	return nullptr;
 }
 
 void NetworkTCPSocketHandler::LogSentPacket(const Packet &pkt) {}
@@ -259,18 +428,17 @@ bool NetworkTCPSocketHandler::CanSendReceive()
 {
 	assert(this->sock != INVALID_SOCKET);
 
-	fd_set read_fd, write_fd;
-	struct timeval tv;
-
-	FD_ZERO(&read_fd);
-	FD_ZERO(&write_fd);
-
-	FD_SET(this->sock, &read_fd);
-	FD_SET(this->sock, &write_fd);
+	pollfd pfd{};
+	pfd.fd = this->sock;
+	pfd.events = POLLIN | POLLOUT;
 
-	tv.tv_sec = tv.tv_usec = 0; // don't block at all.
-	if (select(FD_SETSIZE, &read_fd, &write_fd, nullptr, &tv) < 0) return false;
+	/* Don't block at all. */
+#ifdef _WIN32
+	if (WSAPoll(&pfd, 1, 0) < 0) return false;
+#else
+	if (poll(&pfd, 1, 0) < 0) return false;
+#endif
 
-	this->writable = !!FD_ISSET(this->sock, &write_fd);
-	return FD_ISSET(this->sock, &read_fd) != 0;
+	this->writable = (pfd.revents & POLLOUT) != 0;
+	return (pfd.revents & (POLLIN | POLLHUP | POLLERR)) != 0;
 }
@@ -14,6 +14,7 @@
 
 #include "address.h"
 #include "packet.h"
+#include "tcp_poll.h"
 #include "../../core/ring_buffer.hpp"
 
 #include <atomic>
@@ -31,16 +32,24 @@ enum SendPacketsState {
 	SPS_ALL_SENT,    ///< All packets in the queue are sent.
 };
 
+struct NetworkIOConnection;
+
 /** Base socket handler for all TCP sockets */
 class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
-	ring_buffer<std::unique_ptr<Packet>> packet_queue; ///< Packets that are awaiting delivery
-	std::unique_ptr<Packet> packet_recv;              ///< Partially received packet
+	ring_buffer<SharedPacket> packet_queue; ///< Packets that are awaiting delivery
+	size_t packet_queue_sent = 0;           ///< Number of bytes of the first packet in #packet_queue that have already been sent
+	std::unique_ptr<Packet> packet_recv;    ///< Partially received packet
 
 	void EmptyPacketQueue();
+	void OnSendBlocked();
+	SendPacketsState SendPacketsToIOThread(bool closing_down);
+	std::unique_ptr<Packet> ReceivePacketFromIOThread();
 public:
 	SOCKET sock;              ///< The socket currently connected to
 	bool writable;            ///< Can we write to this socket?
+	NetworkSocketPoller *poller = nullptr; ///< The poller which watches the socket, if any. Otherwise #writable is updated by #CanSendReceive.
+	std::shared_ptr<NetworkIOConnection> io; ///< The connection state shared with the network thread, if that does the I/O of the socket.
 
 	/**
 	 * Whether this socket is currently bound to a socket.
@@ -51,27 +60,35 @@ public:
 	virtual NetworkRecvStatus CloseConnection(bool error = true);
 	void CloseSocket();
 
-	void SendPacket(std::unique_ptr<Packet> packet);
-	void SendPrependPacket(std::unique_ptr<Packet> packet, int queue_after_packet_type);
+	void SendPacket(SharedPacket packet);
+	void SendPrependPacket(SharedPacket packet, int queue_after_packet_type);
 	void ShrinkToFitSendQueue();
 
+	void SendPacket(std::unique_ptr<Packet> packet)
+	{
+		this->SendPacket(Packet::Share(std::move(packet)));
+	}
+
+	void SendPrependPacket(std::unique_ptr<Packet> packet, int queue_after_packet_type)
+	{
+		this->SendPrependPacket(Packet::Share(std::move(packet)), queue_after_packet_type);
+	}
+
 	void SendPacket(Packet *packet)
 	{
 		this->SendPacket(std::unique_ptr<Packet>(packet));
 	}
 
 	SendPacketsState SendPackets(bool closing_down = false);
+	static SendPacketsState SendPacketQueue(SOCKET sock, ring_buffer<SharedPacket> &queue, size_t &first_sent, bool closing_down, NetworkTCPSocketHandler *log_handler = nullptr);
+	static bool ReceivePacketFromSocket(SOCKET sock, NetworkSocketHandler *cs, std::unique_ptr<Packet> &packet_recv, std::unique_ptr<Packet> &packet);
 
 	virtual std::unique_ptr<Packet> ReceivePacket();
 	virtual void LogSentPacket(const Packet &pkt);
 
 	bool CanSendReceive();
 
-	/**
-	 * Whether there is something pending in the send queue.
-	 * @return true when something is pending in the send queue.
-	 */
-	bool HasSendQueue() { return !this->packet_queue.empty(); }
+	bool HasSendQueue() const;
 
 	NetworkTCPSocketHandler(SOCKET s = INVALID_SOCKET);
 	~NetworkTCPSocketHandler();
@@ -60,6 +60,7 @@ enum PacketAdminType {
 	ADMIN_PACKET_SERVER_GAMESCRIPT,      ///< The server gives the admin information from the GameScript in JSON.
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
+	ADMIN_PACKET_SERVER_NETWORK_STATS,   ///< The server gives the admin timing statistics of the game loop and network thread.
 
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
@@ -83,6 +84,7 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_NETWORK_STATS,   ///< Updates about the timing of the game loop and network thread.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -481,6 +483,20 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_PONG(Packet *p);
 
+	/**
+	 * Timing statistics of the last completed period of the server.
+	 * uint32_t  Number of ticks in the period.
+	 * uint32_t  Mean interval between the starts of consecutive ticks, in microseconds.
+	 * uint32_t  Maximum interval between the starts of consecutive ticks, in microseconds.
+	 * uint32_t  Mean difference between the lengths of consecutive tick intervals (jitter), in microseconds.
+	 * uint32_t  Number of packets the network thread handed over to the game loop.
+	 * uint32_t  Mean time these packets waited for the game loop, in microseconds.
+	 * uint32_t  Maximum time these packets waited for the game loop, in microseconds.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_NETWORK_STATS(Packet *p);
+
 	/**
 	 * Notify the admin connection that the rcon command has finished.
 	 * string The command as requested by the admin connection.
@@ -0,0 +1,306 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file tcp_io_thread.cpp Socket I/O of TCP connections on a separate network thread.
+ */
+
+#include "../../stdafx.h"
+#include "../../debug.h"
+#include "../../thread.h"
+#include "tcp_io_thread.h"
+#include "tcp_poll.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../safeguards.h"
+
+NetworkIOStats _network_io_stats;
+
+#ifdef WITH_NETWORK_IO_THREAD
+
+/** Maximum time to wait for the sockets, in case a wake up gets lost. */
+static const int NETWORK_IO_POLL_TIMEOUT_MS = 1000;
+
+/** State of the network thread. */
+struct NetworkIOThreadState {
+	std::thread thread;                   ///< The network thread, if it has been started.
+	int wake_read = -1;                   ///< Read end of the pipe to wake the network thread.
+	int wake_write = -1;                  ///< Write end of the pipe to wake the network thread.
+	std::atomic<bool> wake_pending{false}; ///< Whether the network thread has been woken, but has not handled it yet.
+	std::atomic<bool> exit{false};         ///< Whether the network thread has to stop.
+
+	std::mutex mutex;                                         ///< Mutex for #attached.
+	std::vector<std::shared_ptr<NetworkIOConnection>> attached; ///< Connections to be taken over by the network thread.
+
+	/* Only used by the network thread. */
+	NetworkSocketPoller poller;                                  ///< Readiness notification for the pipe and the sockets.
+	std::vector<std::shared_ptr<NetworkIOConnection>> connections; ///< Connections whose I/O is done by the network thread.
+};
+
+static NetworkIOThreadState _io;
+
+/**
+ * The connection got closed or failed; stop doing I/O for it and tell the game thread.
+ * The socket is only closed once the game thread is done with the connection.
+ * @param conn The connection.
+ */
+static void FailConnection(NetworkIOConnection &conn)
+{
+	if (conn.failed.load()) return;
+
+	_io.poller.RemoveSocket(conn.sock);
+	conn.send_queue.clear();
+	conn.unsent.store(0);
+	conn.failed.store(true);
+}
+
+/**
+ * Receive packets from a connection, until the OS has no more data or the game thread's queue is full.
+ * @param conn The connection.
+ */
+static void ReceivePackets(NetworkIOConnection &conn)
+{
+	while (!conn.failed.load()) {
+		if (conn.received.full()) {
+			/* Stop watching the socket until the game thread caught up. */
+			conn.receive_blocked.store(true);
+			_io.poller.WatchReadable(conn.sock, false);
+			return;
+		}
+
+		std::unique_ptr<Packet> p;
+		if (!NetworkTCPSocketHandler::ReceivePacketFromSocket(conn.sock, conn.cs, conn.packet_recv, p)) {
+			FailConnection(conn);
+			return;
+		}
+		if (p == nullptr) return;
+
+		conn.received.push({ std::move(p), std::chrono::steady_clock::now() });
+	}
+}
+
+/**
+ * Send the packets the game thread handed over for a connection, until all are sent or the OS would block.
+ * @param conn The connection.
+ */
+static void SendPackets(NetworkIOConnection &conn)
+{
+	if (conn.failed.load()) return;
+
+	SharedPacket p;
+	while (conn.outgoing.pop(p)) conn.send_queue.push_back(std::move(p));
+	if (conn.send_blocked || conn.send_queue.empty()) return;
+
+	size_t queued = conn.send_queue.size();
+	SendPacketsState state = NetworkTCPSocketHandler::SendPacketQueue(conn.sock, conn.send_queue, conn.send_queue_sent, false);
+	conn.unsent -= (uint32_t)(queued - conn.send_queue.size());
+
+	switch (state) {
+		case SPS_CLOSED:
+			FailConnection(conn);
+			break;
+
+		case SPS_PARTLY_SENT:
+			conn.send_blocked = true;
+			_io.poller.WatchWritable(conn.sock, true);
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+ * Stop the I/O of a connection and close its socket.
+ * @param conn The connection.
+ */
+static void CloseConnection(NetworkIOConnection &conn)
+{
+	if (!conn.failed.load()) _io.poller.RemoveSocket(conn.sock);
+	closesocket(conn.sock);
+	conn.sock = INVALID_SOCKET;
+}
+
+/** Read all pending wake ups from the pipe. */
+static void DrainWakePipe()
+{
+	char buffer[64];
+	while (read(_io.wake_read, buffer, sizeof(buffer)) > 0) {}
+}
+
+/** Main loop of the network thread. */
+static void NetworkIOThreadLoop()
+{
+	while (!_io.exit.load()) {
+		if (!_io.poller.Poll(NETWORK_IO_POLL_TIMEOUT_MS)) {
+			DEBUG(net, 0, "[io] Polling failed: %s", NetworkError::GetLast().AsString());
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		for (const NetworkSocketEvent &event : _io.poller.GetEvents()) {
+			if (event.data == nullptr) continue;
+
+			if (event.data == &_io) {
+				/* Everything the game thread queued before this is handled below. */
+				DrainWakePipe();
+				_io.wake_pending.store(false);
+				continue;
+			}
+
+			NetworkIOConnection &conn = *static_cast<NetworkIOConnection *>(event.data);
+			if (event.writable) {
+				conn.send_blocked = false;
+				_io.poller.WatchWritable(conn.sock, false);
+			}
+			if (event.readable && !conn.receive_blocked.load()) ReceivePackets(conn);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_io.mutex);
+			for (auto &conn : _io.attached) {
+				if (!_io.poller.AddSocket(conn->sock, conn.get())) conn->failed.store(true);
+				_io.connections.push_back(std::move(conn));
+			}
+			_io.attached.clear();
+		}
+
+		for (auto it = _io.connections.begin(); it != _io.connections.end();) {
+			NetworkIOConnection &conn = **it;
+			/* Check this first, so the packets queued before closing are sent. */
+			bool closing = conn.close.load();
+
+			if (conn.receive_blocked.load() && !conn.received.full()) {
+				conn.receive_blocked.store(false);
+				if (!conn.failed.load()) {
+					_io.poller.WatchReadable(conn.sock, true);
+					ReceivePackets(conn);
+				}
+			}
+
+			SendPackets(conn);
+
+			if (closing) {
+				CloseConnection(conn);
+				it = _io.connections.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	/* Nobody uses the connections anymore, so close whatever is left. */
+	for (auto &conn : _io.connections) {
+		SendPackets(*conn);
+		CloseConnection(*conn);
+	}
+	_io.connections.clear();
+}
+
+/**
+ * Start the network thread, when it is not running yet.
+ * @return Whether the network thread is running.
+ */
+static bool StartNetworkIOThread()
+{
+	if (_io.thread.joinable()) return true;
+
+	int fds[2];
+	if (pipe(fds) != 0) {
+		DEBUG(net, 0, "[io] Could not create pipe: %s", NetworkError::GetLast().AsString());
+		return false;
+	}
+	_io.wake_read = fds[0];
+	_io.wake_write = fds[1];
+	SetNonBlocking(_io.wake_read);
+	SetNonBlocking(_io.wake_write);
+
+	_io.exit.store(false);
+	_io.wake_pending.store(false);
+	if (!_io.poller.AddSocket(_io.wake_read, &_io) || !StartNewThread(&_io.thread, "ottd:netio", &NetworkIOThreadLoop)) {
+		DEBUG(net, 0, "[io] Could not start the network thread");
+		_io.poller.RemoveSocket(_io.wake_read);
+		close(_io.wake_read);
+		close(_io.wake_write);
+		_io.wake_read = _io.wake_write = -1;
+		return false;
+	}
+
+	DEBUG(net, 3, "[io] Started the network thread");
+	return true;
+}
+
+/**
+ * Let the network thread do the socket I/O of a connection.
+ * From then on the socket handler exchanges complete packets with the network thread,
+ * and the network thread closes the socket once the socket handler closes it.
+ * @param cs The socket handler of a just accepted connection.
+ * @return Whether the network thread took over the connection.
+ */
+/* static */ bool NetworkIOThread::Attach(NetworkTCPSocketHandler *cs)
+{
+	assert(cs->io == nullptr && cs->poller == nullptr && !cs->HasSendQueue());
+
+	if (!StartNetworkIOThread()) return false;
+
+	cs->io = std::make_shared<NetworkIOConnection>(cs->sock, cs);
+	cs->writable = true;
+	{
+		std::lock_guard<std::mutex> lock(_io.mutex);
+		_io.attached.push_back(cs->io);
+	}
+	NetworkIOThread::Wake();
+	return true;
+}
+
+/**
+ * Wake the network thread, to handle packets or connections the game thread handed over.
+ */
+/* static */ void NetworkIOThread::Wake()
+{
+	if (_io.wake_write == -1 || _io.wake_pending.exchange(true)) return;
+
+	char c = 0;
+	if (write(_io.wake_write, &c, 1) < 0 && errno != EAGAIN) {
+		DEBUG(net, 0, "[io] Could not wake the network thread: %s", NetworkError::GetLast().AsString());
+	}
+}
+
+/**
+ * Stop the network thread, after the game thread is done with all connections.
+ */
+/* static */ void NetworkIOThread::Stop()
+{
+	if (!_io.thread.joinable()) return;
+
+	_io.exit.store(true);
+	_io.wake_pending.store(false);
+	NetworkIOThread::Wake();
+	_io.thread.join();
+
+	_io.poller.RemoveSocket(_io.wake_read);
+	close(_io.wake_read);
+	close(_io.wake_write);
+	_io.wake_read = _io.wake_write = -1;
+
+	DEBUG(net, 3, "[io] Stopped the network thread");
+}
+
+#else /* WITH_NETWORK_IO_THREAD */
+
+/* static */ bool NetworkIOThread::Attach(NetworkTCPSocketHandler *)
+{
+	return false;
+}
+
+/* static */ void NetworkIOThread::Wake() {}
+
+/* static */ void NetworkIOThread::Stop() {}
+
+#endif /* WITH_NETWORK_IO_THREAD */
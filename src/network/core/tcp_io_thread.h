@@ -0,0 +1,92 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file tcp_io_thread.h Socket I/O of TCP connections on a separate network thread.
+ */
+
+#ifndef NETWORK_CORE_TCP_IO_THREAD_H
+#define NETWORK_CORE_TCP_IO_THREAD_H
+
+#include "tcp.h"
+#include "../../core/spsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#	define WITH_NETWORK_IO_THREAD
+#endif
+
+/** A packet received by the network thread. */
+struct NetworkIOReceivedPacket {
+	std::unique_ptr<Packet> packet;             ///< The complete packet.
+	std::chrono::steady_clock::time_point time; ///< When the network thread finished receiving the packet.
+};
+
+/**
+ * The state of a connection whose socket is read and written by the network thread.
+ * The game thread only exchanges complete packets with the network thread, through
+ * lock-free queues, so slow or flooding clients cannot stretch the game loop.
+ */
+struct NetworkIOConnection {
+	static const uint32_t RECEIVE_QUEUE_SIZE = 256; ///< Maximum number of received packets waiting for the game thread.
+	static const uint32_t SEND_QUEUE_SIZE = 1024;   ///< Maximum number of packets waiting for the network thread.
+
+	SOCKET sock;                ///< The socket, owned by the network thread.
+	NetworkSocketHandler *cs;   ///< The socket handler to associate received packets with; the network thread does not dereference it.
+
+	spsc_queue<NetworkIOReceivedPacket> received{RECEIVE_QUEUE_SIZE}; ///< Received packets, from the network thread to the game thread.
+	spsc_queue<SharedPacket> outgoing{SEND_QUEUE_SIZE};               ///< Packets to send, from the game thread to the network thread.
+	std::atomic<uint32_t> unsent{0};          ///< Number of packets handed to the network thread that are not completely sent yet.
+	std::atomic<bool> failed{false};          ///< Whether the connection got closed or failed, set after queueing the last received packet.
+	std::atomic<bool> receive_blocked{false}; ///< Whether the network thread stopped receiving, because #received is full.
+	std::atomic<bool> close{false};           ///< Whether the game thread is done with the connection.
+
+	/* Only used by the network thread. */
+	std::unique_ptr<Packet> packet_recv;    ///< Partially received packet.
+	ring_buffer<SharedPacket> send_queue;   ///< Packets taken from #outgoing, awaiting delivery.
+	size_t send_queue_sent = 0;             ///< Number of bytes of the first packet in #send_queue that have already been sent.
+	bool send_blocked = false;              ///< Whether sending would block until the socket becomes writable.
+
+	NetworkIOConnection(SOCKET sock, NetworkSocketHandler *cs) : sock(sock), cs(cs) {}
+};
+
+/**
+ * Statistics about handing received packets over from the network thread
+ * to the game thread. Only accessed by the game thread.
+ */
+struct NetworkIOStats {
+	uint32_t packets = 0;                        ///< Number of packets handed over.
+	std::chrono::microseconds total_latency{0};  ///< Total time the packets waited for the game thread.
+	std::chrono::microseconds max_latency{0};    ///< Longest time a packet waited for the game thread.
+
+	/**
+	 * Account for a packet that was handed over.
+	 * @param latency The time the packet waited for the game thread.
+	 */
+	void AddPacket(std::chrono::steady_clock::duration latency)
+	{
+		auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+		this->packets++;
+		this->total_latency += us;
+		this->max_latency = std::max(this->max_latency, us);
+	}
+};
+
+extern NetworkIOStats _network_io_stats;
+
+/** The network thread, which does the socket I/O of the connections attached to it. */
+class NetworkIOThread {
+public:
+	static bool Attach(NetworkTCPSocketHandler *cs);
+	static void Wake();
+	static void Stop();
+};
+
+#endif /* NETWORK_CORE_TCP_IO_THREAD_H */
@@ -13,6 +13,7 @@
 #define NETWORK_CORE_TCP_LISTEN_H
 
 #include "tcp.h"
+#include "tcp_poll.h"
 #include "../network.h"
 #include "../../core/pool_type.hpp"
 #include "../../debug.h"
@@ -28,6 +29,8 @@ template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet>
 class TCPListenHandler {
 	/** List of sockets we listen on. */
 	static SocketList sockets;
+	/** Readiness notification for the sockets we listen on and the sockets of the accepted connections. */
+	static NetworkSocketPoller socket_poller;
 
 public:
 	static bool ValidateClient(SOCKET s, NetworkAddress &address)
@@ -94,43 +97,45 @@ public:
 		}
 	}
 
+	/**
+	 * Start watching the socket of an accepted connection.
+	 * The socket is writable until sending would block, and then until the poller reports it writable again.
+	 * @param cs The socket handler of the connection.
+	 */
+	static void WatchSocket(Tsocket *cs)
+	{
+		cs->writable = true;
+		if (socket_poller.AddSocket(cs->sock, cs)) cs->poller = &socket_poller;
+	}
+
 	/**
 	 * Handle the receiving of packets.
 	 * @return true if everything went okay.
 	 */
 	static bool Receive()
 	{
-		fd_set read_fd, write_fd;
-		struct timeval tv;
+		if (!socket_poller.Poll()) return false;
 
-		FD_ZERO(&read_fd);
-		FD_ZERO(&write_fd);
+		const std::vector<NetworkSocketEvent> &events = socket_poller.GetEvents();
+		for (size_t i = 0; i < events.size(); i++) {
+			const NetworkSocketEvent &event = events[i];
 
+			/* The socket got closed while handling an earlier event. */
+			if (event.data == nullptr) continue;
 
-		for (Tsocket *cs : Tsocket::Iterate()) {
-			FD_SET(cs->sock, &read_fd);
-			FD_SET(cs->sock, &write_fd);
-		}
-
-		/* take care of listener port */
-		for (auto &s : sockets) {
-			FD_SET(s.first, &read_fd);
-		}
-
-		tv.tv_sec = tv.tv_usec = 0; // don't block at all.
-		if (select(FD_SETSIZE, &read_fd, &write_fd, nullptr, &tv) < 0) return false;
-
-		/* accept clients.. */
-		for (auto &s : sockets) {
-			if (FD_ISSET(s.first, &read_fd)) AcceptClient(s.first);
-		}
+			/* Listening sockets are added with the list of listening sockets as data. */
+			if (event.data == &sockets) {
+				AcceptClient(event.sock);
+				continue;
+			}
 
-		/* read stuff from clients */
-		for (Tsocket *cs : Tsocket::Iterate()) {
-			cs->writable = !!FD_ISSET(cs->sock, &write_fd);
-			if (FD_ISSET(cs->sock, &read_fd)) {
-				cs->ReceivePackets();
+			Tsocket *cs = static_cast<Tsocket *>(event.data);
+			if (event.writable) {
+				/* The send queue gets flushed by Send, later in this network loop. */
+				cs->writable = true;
+				socket_poller.WatchWritable(cs->sock, false);
 			}
+			if (event.readable) cs->ReceivePackets();
 		}
 		return _networking;
 	}
@@ -151,6 +156,10 @@ public:
 			address.Listen(SOCK_STREAM, &sockets);
 		}
 
+		for (auto &s : sockets) {
+			socket_poller.AddSocket(s.first, &sockets);
+		}
+
 		if (sockets.empty()) {
 			DEBUG(net, 0, "Could not start network: could not create listening socket");
 			ShowNetworkError(STR_NETWORK_ERROR_SERVER_START);
@@ -164,6 +173,7 @@ public:
 	static void CloseListeners()
 	{
 		for (auto &s : sockets) {
+			socket_poller.RemoveSocket(s.first);
 			closesocket(s.first);
 		}
 		sockets.clear();
@@ -172,5 +182,6 @@ public:
 };
 
 template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> SocketList TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::sockets;
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> NetworkSocketPoller TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::socket_poller;
 
 #endif /* NETWORK_CORE_TCP_LISTEN_H */
@@ -0,0 +1,277 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file tcp_poll.cpp Readiness notification for a set of sockets.
+ */
+
+#include "../../stdafx.h"
+#include "../../debug.h"
+#include "tcp_poll.h"
+
+#include "../../safeguards.h"
+
+NetworkSocketPoller::~NetworkSocketPoller()
+{
+#ifdef WITH_EPOLL
+	if (this->epoll_fd != -1) close(this->epoll_fd);
+#endif
+}
+
+#ifdef WITH_EPOLL
+
+/**
+ * Find a socket in the set.
+ * @param s The socket.
+ * @return The index of the slot of the socket, or SIZE_MAX if it is not in the set.
+ */
+size_t NetworkSocketPoller::FindSocket(SOCKET s) const
+{
+	for (size_t i = 0; i < this->slots.size(); i++) {
+		if (this->slots[i].sock == s) return i;
+	}
+	return SIZE_MAX;
+}
+
+/**
+ * Add a socket to the set. The socket is watched for readability.
+ * @param s The socket.
+ * @param data The data to return with the events of this socket.
+ * @return Whether the socket could be added.
+ */
+bool NetworkSocketPoller::AddSocket(SOCKET s, void *data)
+{
+	if (this->epoll_fd == -1) {
+		this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (this->epoll_fd == -1) {
+			DEBUG(net, 0, "epoll_create1 failed: %s", NetworkError::GetLast().AsString());
+			return false;
+		}
+	}
+
+	uint32_t index;
+	if (this->free_slots.empty()) {
+		index = (uint32_t)this->slots.size();
+		this->slots.push_back({ INVALID_SOCKET, nullptr, 0 });
+	} else {
+		index = this->free_slots.back();
+		this->free_slots.pop_back();
+	}
+
+	epoll_event ev{};
+	ev.events = EPOLLIN;
+	ev.data.u64 = index;
+	if (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, s, &ev) != 0) {
+		DEBUG(net, 0, "epoll_ctl failed: %s", NetworkError::GetLast().AsString());
+		this->free_slots.push_back(index);
+		return false;
+	}
+	this->slots[index] = { s, data, EPOLLIN };
+	this->sockets++;
+	return true;
+}
+
+/**
+ * Remove a socket from the set. This must be done before closing the socket, as a
+ * socket stays in an epoll set for as long as a forked child process still has it open.
+ * @param s The socket.
+ */
+void NetworkSocketPoller::RemoveSocket(SOCKET s)
+{
+	size_t index = this->FindSocket(s);
+	if (index == SIZE_MAX) return;
+
+	epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, s, nullptr);
+	this->slots[index] = { INVALID_SOCKET, nullptr, 0 };
+	this->free_slots.push_back((uint32_t)index);
+	this->sockets--;
+
+	for (NetworkSocketEvent &event : this->events) {
+		if (event.sock == s) event.data = nullptr;
+	}
+}
+
+/**
+ * Change the events a socket is watched for.
+ * @param s The socket.
+ * @param events The epoll event to start or stop watching for.
+ * @param watch Whether to watch the socket for the event.
+ */
+void NetworkSocketPoller::Watch(SOCKET s, uint32_t events, bool watch)
+{
+	size_t index = this->FindSocket(s);
+	if (index == SIZE_MAX) return;
+
+	Slot &slot = this->slots[index];
+	uint32_t new_events = watch ? (slot.events | events) : (slot.events & ~events);
+	if (new_events == slot.events) return;
+	slot.events = new_events;
+
+	epoll_event ev{};
+	ev.events = new_events;
+	ev.data.u64 = index;
+	epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, s, &ev);
+}
+
+/**
+ * Wait for sockets in the set to become ready.
+ * The sockets which are ready can be retrieved with #GetEvents.
+ * @param timeout_ms The maximum time to wait in milliseconds, 0 to not wait at all.
+ * @return False if polling failed.
+ */
+bool NetworkSocketPoller::Poll(int timeout_ms)
+{
+	this->events.clear();
+	if (this->sockets == 0) return true;
+
+	this->epoll_events.resize(this->sockets);
+	int n = epoll_wait(this->epoll_fd, this->epoll_events.data(), (int)this->epoll_events.size(), timeout_ms);
+	if (n < 0) return errno == EINTR;
+
+	for (int i = 0; i < n; i++) {
+		const epoll_event &ev = this->epoll_events[i];
+		const Slot &slot = this->slots[ev.data.u64];
+		if (slot.sock == INVALID_SOCKET) continue;
+
+		NetworkSocketEvent &event = this->events.emplace_back();
+		event.sock = slot.sock;
+		event.data = slot.data;
+		event.readable = (ev.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+		event.writable = (ev.events & EPOLLOUT) != 0;
+	}
+	return true;
+}
+
+#else /* WITH_EPOLL */
+
+/**
+ * Find a socket in the set.
+ * @param s The socket.
+ * @return The index of the socket in #poll_fds, or SIZE_MAX if it is not in the set.
+ */
+size_t NetworkSocketPoller::FindSocket(SOCKET s) const
+{
+	for (size_t i = 0; i < this->poll_fds.size(); i++) {
+		if (this->poll_fds[i].fd == s) return i;
+	}
+	return SIZE_MAX;
+}
+
+/**
+ * Add a socket to the set. The socket is watched for readability.
+ * @param s The socket.
+ * @param data The data to return with the events of this socket.
+ * @return Whether the socket could be added.
+ */
+bool NetworkSocketPoller::AddSocket(SOCKET s, void *data)
+{
+	pollfd pfd{};
+	pfd.fd = s;
+	pfd.events = POLLIN;
+	this->poll_fds.push_back(pfd);
+	this->poll_data.push_back(data);
+	this->sockets++;
+	return true;
+}
+
+/**
+ * Remove a socket from the set. This must be done before closing the socket.
+ * @param s The socket.
+ */
+void NetworkSocketPoller::RemoveSocket(SOCKET s)
+{
+	size_t index = this->FindSocket(s);
+	if (index == SIZE_MAX) return;
+
+	this->poll_fds[index] = this->poll_fds.back();
+	this->poll_fds.pop_back();
+	this->poll_data[index] = this->poll_data.back();
+	this->poll_data.pop_back();
+	this->sockets--;
+
+	for (NetworkSocketEvent &event : this->events) {
+		if (event.sock == s) event.data = nullptr;
+	}
+}
+
+/**
+ * Change the events a socket is watched for.
+ * @param s The socket.
+ * @param events The poll event to start or stop watching for.
+ * @param watch Whether to watch the socket for the event.
+ */
+void NetworkSocketPoller::Watch(SOCKET s, short events, bool watch)
+{
+	size_t index = this->FindSocket(s);
+	if (index == SIZE_MAX) return;
+
+	pollfd &pfd = this->poll_fds[index];
+	pfd.events = watch ? (pfd.events | events) : (pfd.events & ~events);
+}
+
+/**
+ * Wait for sockets in the set to become ready.
+ * The sockets which are ready can be retrieved with #GetEvents.
+ * @param timeout_ms The maximum time to wait in milliseconds, 0 to not wait at all.
+ * @return False if polling failed.
+ */
+bool NetworkSocketPoller::Poll(int timeout_ms)
+{
+	this->events.clear();
+	if (this->sockets == 0) return true;
+
+#ifdef _WIN32
+	int n = WSAPoll(this->poll_fds.data(), (ULONG)this->poll_fds.size(), timeout_ms);
+#else
+	int n = poll(this->poll_fds.data(), (nfds_t)this->poll_fds.size(), timeout_ms);
+#endif
+	if (n < 0) return false;
+
+	for (size_t i = 0; i < this->poll_fds.size() && n > 0; i++) {
+		const pollfd &pfd = this->poll_fds[i];
+		if (pfd.revents == 0) continue;
+		n--;
+
+		NetworkSocketEvent &event = this->events.emplace_back();
+		event.sock = pfd.fd;
+		event.data = this->poll_data[i];
+		event.readable = (pfd.revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+		event.writable = (pfd.revents & POLLOUT) != 0;
+	}
+	return true;
+}
+
+#endif /* WITH_EPOLL */
+
+/**
+ * Start or stop watching a socket for readability.
+ * A socket that is not watched for readability may still be reported as readable when the connection is closed or has an error.
+ * @param s The socket.
+ * @param watch Whether to watch the socket for readability.
+ */
+void NetworkSocketPoller::WatchReadable(SOCKET s, bool watch)
+{
+#ifdef WITH_EPOLL
+	this->Watch(s, EPOLLIN, watch);
+#else
+	this->Watch(s, POLLIN, watch);
+#endif
+}
+
+/**
+ * Start or stop watching a socket for writability.
+ * @param s The socket.
+ * @param watch Whether to watch the socket for writability.
+ */
+void NetworkSocketPoller::WatchWritable(SOCKET s, bool watch)
+{
+#ifdef WITH_EPOLL
+	this->Watch(s, EPOLLOUT, watch);
+#else
+	this->Watch(s, POLLOUT, watch);
+#endif
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file tcp_poll.h Readiness notification for a set of sockets.
+ */
+
+#ifndef NETWORK_CORE_TCP_POLL_H
+#define NETWORK_CORE_TCP_POLL_H
+
+#include "os_abstraction.h"
+
+#include <vector>
+
+#if !defined(_WIN32)
+#	include <poll.h>
+#endif
+#if defined(__linux__)
+#	define WITH_EPOLL
+#	include <sys/epoll.h>
+#endif
+
+/** Readiness of a socket, as returned by NetworkSocketPoller::Poll. */
+struct NetworkSocketEvent {
+	SOCKET sock;   ///< The socket.
+	void *data;    ///< The data the socket was added with, or nullptr if the socket has been removed in the mean time.
+	bool readable; ///< Whether data can be received, or the connection was closed or has an error.
+	bool writable; ///< Whether data can be sent, only reported for sockets which are watched for writability.
+};
+
+/**
+ * Readiness notification for a set of sockets, using epoll on Linux and poll elsewhere.
+ * Contrary to select, this is not limited to FD_SETSIZE sockets, and with epoll the cost
+ * of a poll only depends on the number of sockets which are ready.
+ *
+ * Sockets are watched for readability, unless requested otherwise. Writability is only watched
+ * on request, i.e. after a send would have blocked, so idle sockets don't have to be reported.
+ */
+class NetworkSocketPoller {
+#ifdef WITH_EPOLL
+	/** A socket in the epoll set, the index of the slot is the data of its epoll events. */
+	struct Slot {
+		SOCKET sock;     ///< The socket, INVALID_SOCKET if the slot is free.
+		void *data;      ///< The data the socket was added with.
+		uint32_t events; ///< The epoll events the socket is watched for.
+	};
+
+	int epoll_fd = -1;                        ///< The epoll instance, -1 if not created yet.
+	std::vector<epoll_event> epoll_events;    ///< Buffer for the events returned by epoll_wait.
+	std::vector<Slot> slots;                  ///< The sockets in the set.
+	std::vector<uint32_t> free_slots;         ///< Indices of the free slots in #slots.
+#else
+	std::vector<pollfd> poll_fds;             ///< The sockets to poll.
+	std::vector<void *> poll_data;            ///< The data of each socket, in the same order as #poll_fds.
+#endif
+	std::vector<NetworkSocketEvent> events;   ///< The events of the last poll.
+	size_t sockets = 0;                       ///< Number of sockets in the set.
+
+	size_t FindSocket(SOCKET s) const;
+#ifdef WITH_EPOLL
+	void Watch(SOCKET s, uint32_t events, bool watch);
+#else
+	void Watch(SOCKET s, short events, bool watch);
+#endif
+
+public:
+	NetworkSocketPoller() {}
+	~NetworkSocketPoller();
+
+	NetworkSocketPoller(const NetworkSocketPoller &other) = delete;
+	NetworkSocketPoller &operator=(const NetworkSocketPoller &other) = delete;
+
+	bool AddSocket(SOCKET s, void *data);
+	void RemoveSocket(SOCKET s);
+	void WatchReadable(SOCKET s, bool watch);
+	void WatchWritable(SOCKET s, bool watch);
+
+	bool Poll(int timeout_ms = 0);
+
+	/**
+	 * Get the events of the last poll.
+	 * Sockets which are removed while handling these events have their data cleared.
+	 * @return The events.
+	 */
+	const std::vector<NetworkSocketEvent> &GetEvents() const { return this->events; }
+
+	/**
+	 * Get the number of sockets in the set.
+	 * @return The number of sockets.
+	 */
+	size_t Count() const { return this->sockets; }
+};
+
+#endif /* NETWORK_CORE_TCP_POLL_H */
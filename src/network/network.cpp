@@ -620,6 +620,9 @@ NetworkAddress ParseConnectionString(const std::string &connection_string, uint1
 
 	ServerNetworkGameSocketHandler *cs = new ServerNetworkGameSocketHandler(s);
 	cs->client_address = address; // Save the IP of the client
+	if (!_settings_client.network.server_io_thread || !NetworkIOThread::Attach(cs)) {
+		ServerNetworkGameSocketHandler::WatchSocket(cs);
+	}
 
 	InvalidateWindowData(WC_CLIENT_LIST, 0);
 }
@@ -662,6 +665,7 @@ void NetworkClose(bool close_admins)
 		_network_coordinator_client.CloseAllConnections();
 	}
 	NetworkGameSocketHandler::ProcessDeferredDeletions();
+	NetworkIOThread::Stop();
 
 	TCPConnecter::KillAll();
 
@@ -55,6 +55,7 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_NETWORK_STATS
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -123,6 +124,7 @@ ServerNetworkAdminSocketHandler::~ServerNetworkAdminSocketHandler()
 {
 	ServerNetworkAdminSocketHandler *as = new ServerNetworkAdminSocketHandler(s);
 	as->address = address; // Save the IP of the client
+	ServerNetworkAdminSocketHandler::WatchSocket(as);
 }
 
 /***********
@@ -574,6 +576,28 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPong(uint32_t d1)
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Send the timing statistics of the last completed period of the game loop and network thread. */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendNetworkStats()
+{
+	const NetworkServerStats &stats = _network_server_stats;
+	auto mean = [](std::chrono::microseconds total, uint32_t count) -> uint32_t {
+		return count == 0 ? 0 : ClampTo<uint32_t>(total.count() / count);
+	};
+
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_NETWORK_STATS);
+
+	p->Send_uint32(stats.ticks);
+	p->Send_uint32(mean(stats.total_tick_interval, stats.ticks));
+	p->Send_uint32(ClampTo<uint32_t>(stats.max_tick_interval.count()));
+	p->Send_uint32(mean(stats.total_tick_jitter, stats.ticks));
+	p->Send_uint32(stats.io.packets);
+	p->Send_uint32(mean(stats.io.total_latency, stats.io.packets));
+	p->Send_uint32(ClampTo<uint32_t>(stats.io.max_latency.count()));
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /** Send the names of the commands. */
 NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdNames()
 {
@@ -747,6 +771,11 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_NETWORK_STATS:
+			/* The admin is requesting the timing statistics. */
+			this->SendNetworkStats();
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			DEBUG(net, 1, "[admin] Not supported poll %d (%d) from '%s' (%s).", type, d1, this->admin_name.c_str(), this->admin_version.c_str());
@@ -1014,6 +1043,10 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 						as->SendCompanyStats();
 						break;
 
+					case ADMIN_UPDATE_NETWORK_STATS:
+						as->SendNetworkStats();
+						break;
+
 					default: NOT_REACHED();
 				}
 			}
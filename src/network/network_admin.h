@@ -69,6 +69,7 @@ public:
 	NetworkRecvStatus SendCmdNames();
 	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket *cp);
 	NetworkRecvStatus SendRconEnd(const std::string_view command);
+	NetworkRecvStatus SendNetworkStats();
 
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
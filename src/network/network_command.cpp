@@ -188,20 +188,49 @@ void NetworkSendCommand(TileIndex tile, uint32_t p1, uint32_t p2, uint64_t p3, u
 }
 
 /**
- * Sync our local command queue to the command queue of the given
- * socket. This is needed for the case where we receive a command
+ * Get the number of commands which the server queued for itself and has not yet distributed.
+ * @return The number of commands.
+ */
+uint NetworkGetLocalCommandCount()
+{
+	return _local_wait_queue.Count();
+}
+
+/**
+ * Order the commands which the server queued for itself by company, keeping the order of the commands of each company.
+ * Scripts which run concurrently queue their commands in an order which depends on timing; this puts them in the
+ * same order as when the scripts run one after another.
+ * @param first The number of commands at the front of the queue to leave in place.
+ */
+void NetworkOrderLocalCommandsByCompany(uint first)
+{
+	if (_local_wait_queue.Count() <= first + 1) return;
+
+	std::vector<std::unique_ptr<CommandPacket>> commands;
+	commands.reserve(_local_wait_queue.Count());
+	while (_local_wait_queue.Count() > 0) commands.push_back(_local_wait_queue.Pop());
+
+	std::stable_sort(commands.begin() + first, commands.end(), [](const auto &a, const auto &b) {
+		return a->company < b->company;
+	});
+	for (auto &cp : commands) _local_wait_queue.Append(std::move(*cp));
+}
+
+/**
+ * Sync our local command queue to the given command queue of a map
+ * snapshot. This is needed for the case where we receive a command
  * before saving the game for a joining client, but without the
  * execution of those commands. Not syncing those commands means
  * that the client will never get them and as such will be in a
  * desynced state from the time it started with joining.
- * @param cs The client to sync the queue to.
+ * @param queue The queue to sync to.
  */
-void NetworkSyncCommandQueue(NetworkClientSocket *cs)
+void NetworkSyncCommandQueue(CommandQueue &queue)
 {
 	for (CommandPacket *p = _local_execution_queue.Peek(); p != nullptr; p = p->next) {
 		CommandPacket c = *p;
 		c.callback = nullptr;
-		cs->outgoing_queue.Append(std::move(c));
+		queue.Append(std::move(c));
 	}
 }
 
@@ -265,15 +294,23 @@ static void DistributeCommandPacket(CommandPacket &cp, const NetworkClientSocket
 	CommandCallback *callback = cp.callback;
 	cp.frame = _frame_counter_max + 1;
 
+	/* All clients but the owner get exactly the same packet, so it is only serialised once. */
+	SharedPacket shared;
+
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
 		if (cs->status >= NetworkClientSocket::STATUS_MAP) {
 			/* Callbacks are only send back to the client who sent them in the
 			 *  first place. This filters that out. */
 			cp.callback = (cs != owner) ? nullptr : callback;
 			cp.my_cmd = (cs == owner);
+			if (cs != owner && shared == nullptr) shared = ServerNetworkGameSocketHandler::SerialiseCommand(cp);
+			cp.serialised = (cs != owner) ? shared : nullptr;
 			cs->outgoing_queue.Append(cp);
 		}
 	}
+	cp.serialised.reset();
+
+	NetworkRecordMapSnapshotCommand(cp);
 
 	cp.callback = (nullptr != owner) ? nullptr : callback;
 	cp.my_cmd = (nullptr == owner);
@@ -56,114 +56,127 @@ INSTANTIATE_POOL_METHODS(NetworkClientSocket)
 /** Instantiate the listen sockets. */
 template SocketList TCPListenHandler<ServerNetworkGameSocketHandler, PACKET_SERVER_FULL, PACKET_SERVER_BANNED>::sockets;
 
-/** Writing a savegame directly to a number of packets. */
-struct PacketWriter : SaveFilter {
-	ServerNetworkGameSocketHandler *cs; ///< Socket we are associated with.
-	std::unique_ptr<Packet> current;    ///< The packet we're currently writing to.
-	size_t total_size;                  ///< Total size of the compressed savegame.
-	std::vector<std::unique_ptr<Packet>> packets; ///< Packet queue of the savegame; send these "slowly" to the client.
-	std::unique_ptr<Packet> map_size_packet; ///< Map size packet, fast tracked to the client
-	std::mutex mutex;                   ///< Mutex for making threaded saving safe.
-	std::condition_variable exit_sig;   ///< Signal for threaded destruction of this packet writer.
+/** Maximum number of map packets to queue for a client at once. */
+static const size_t MAP_SNAPSHOT_PACKETS_PER_TRANSFER = 32;
+
+/**
+ * A compressed savegame of the game at a given frame, as packets. It is shared by all clients that start
+ * joining within [network.]map_snapshot_window ticks after it has been made; each of them is sent the same
+ * packets, and then catches up with the commands that have been distributed since the snapshot frame.
+ */
+struct NetworkMapSnapshot {
+	const uint32_t frame;               ///< The frame at which the game was saved.
+	const bool zstd;                    ///< Whether the savegame may be compressed with zstd.
+	CommandQueue commands;              ///< Commands to be executed after the snapshot frame; only accessed by the game thread.
+	std::mutex mutex;                   ///< Mutex for the fields below, which are written by the save thread.
+	std::vector<SharedPacket> packets;  ///< The map data packets written so far, ready to send and shared by the send queues of all clients.
+	size_t total_size = 0;              ///< Total size of the compressed savegame, valid once finished.
+	bool finished = false;              ///< Whether the savegame has been written completely.
+	bool failed = false;                ///< Whether writing the savegame failed.
+
+	NetworkMapSnapshot(uint32_t frame, bool zstd) : frame(frame), zstd(zstd) {}
 
 	/**
-	 * Create the packet writer.
-	 * @param cs The socket handler we're making the packets for.
+	 * Whether writing the savegame has ended, successfully or not.
+	 * @return True iff no more packets will be added.
 	 */
-	PacketWriter(ServerNetworkGameSocketHandler *cs) : SaveFilter(nullptr), cs(cs), total_size(0)
-	{
-	}
-
-	/** Make sure everything is cleaned up. */
-	~PacketWriter()
+	bool IsDone()
 	{
-		std::unique_lock<std::mutex> lock(this->mutex);
-
-		if (this->cs != nullptr) this->exit_sig.wait(lock);
-
-		/* This must all wait until the Destroy function is called. */
-
-		this->packets.clear();
-		this->map_size_packet.reset();
-		this->current.reset();
+		std::lock_guard<std::mutex> lock(this->mutex);
+		return this->finished || this->failed;
 	}
 
 	/**
-	 * Begin the destruction of this packet writer. It can happen in two ways:
-	 * in the first case the client disconnected while saving the map. In this
-	 * case the saving has not finished and killed this PacketWriter. In that
-	 * case we simply set cs to nullptr, triggering the appending to fail due to
-	 * the connection problem and eventually triggering the destructor. In the
-	 * second case the destructor is already called, and it is waiting for our
-	 * signal which we will send. Only then the packets will be removed by the
-	 * destructor.
+	 * Whether new joining clients may still use this snapshot.
+	 * @param cs The client that wants to join.
+	 * @return True iff the client can be sent this snapshot.
 	 */
-	void Destroy()
+	bool IsUsableFor(const NetworkClientSocket *cs)
 	{
-		std::unique_lock<std::mutex> lock(this->mutex);
-
-		this->cs = nullptr;
-
-		this->exit_sig.notify_all();
-		lock.unlock();
+		if (this->zstd && !cs->supports_zstd) return false;
+		if (_frame_counter - this->frame > _settings_client.network.map_snapshot_window) return false;
 
-		/* Make sure the saving is completely cancelled. Yes,
-		 * we need to handle the save finish as well as the
-		 * next connection might just be requesting a map. */
-		WaitTillSaved();
+		std::lock_guard<std::mutex> lock(this->mutex);
+		return !this->failed;
 	}
 
 	/**
-	 * Transfer all packets from here to the network's queue while holding
-	 * the lock on our mutex.
-	 * @param socket The network socket to write to.
-	 * @return True iff the last packet of the map has been sent.
+	 * Queue the next packets of the snapshot at a client.
+	 * @param cs The client to send the packets to.
+	 * @return The status of the transfer.
 	 */
-	bool TransferToNetworkQueue(ServerNetworkGameSocketHandler *socket)
+	ServerNetworkGameSocketHandler::MapTransferStatus TransferToNetworkQueue(ServerNetworkGameSocketHandler *cs)
 	{
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		if (this->map_size_packet) {
+		if (this->failed) return ServerNetworkGameSocketHandler::MTS_FAILED;
+
+		if (this->finished && !cs->map_size_sent) {
 			/* Don't queue the PACKET_SERVER_MAP_SIZE before the corresponding PACKET_SERVER_MAP_BEGIN */
-			socket->SendPrependPacket(std::move(this->map_size_packet), PACKET_SERVER_MAP_BEGIN);
+			Packet *p = new Packet(PACKET_SERVER_MAP_SIZE, SHRT_MAX);
+			p->Send_uint32((uint32_t)this->total_size);
+			cs->SendPrependPacket(std::unique_ptr<Packet>(p), PACKET_SERVER_MAP_BEGIN);
+			cs->map_size_sent = true;
 		}
-		bool last_packet = false;
-		for (auto &p : this->packets) {
-			if (p->GetPacketType() == PACKET_SERVER_MAP_DONE) last_packet = true;
-			socket->SendPacket(std::move(p));
 
+		/* Only queue a limited number of packets at once, so a dozen joining clients do not each hold a copy of the map. */
+		if (!cs->HasSendQueue()) {
+			size_t end = std::min(this->packets.size(), cs->map_packets_sent + MAP_SNAPSHOT_PACKETS_PER_TRANSFER);
+			for (; cs->map_packets_sent < end; cs->map_packets_sent++) {
+				cs->SendPacket(this->packets[cs->map_packets_sent]);
+			}
 		}
-		this->packets.clear();
 
-		return last_packet;
+		if (!this->finished || cs->map_packets_sent < this->packets.size()) return ServerNetworkGameSocketHandler::MTS_IN_PROGRESS;
+
+		cs->SendPacket(new Packet(PACKET_SERVER_MAP_DONE, SHRT_MAX));
+		return ServerNetworkGameSocketHandler::MTS_DONE;
 	}
+};
 
-	/** Append the current packet to the queue. */
-	void AppendQueue()
-	{
-		if (this->current == nullptr) return;
+/** The most recent map snapshot, if it can still be used by joining clients or is still being written. */
+static std::shared_ptr<NetworkMapSnapshot> _network_map_snapshot;
 
-		this->packets.push_back(std::move(this->current));
+/** Writing a savegame directly into the packets of a map snapshot. */
+struct NetworkMapSnapshotWriter : SaveFilter {
+	std::shared_ptr<NetworkMapSnapshot> snapshot; ///< The snapshot we are writing.
+	std::unique_ptr<Packet> current;              ///< The packet we're currently writing to.
+	size_t total_size = 0;                        ///< Total size of the compressed savegame so far.
+
+	/**
+	 * Create the writer.
+	 * @param snapshot The snapshot to write to.
+	 */
+	NetworkMapSnapshotWriter(std::shared_ptr<NetworkMapSnapshot> snapshot) : SaveFilter(nullptr), snapshot(std::move(snapshot))
+	{
 	}
 
-	void Write(byte *buf, size_t size) override
+	/** Mark the snapshot as failed, when the saving was aborted. */
+	~NetworkMapSnapshotWriter()
 	{
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
+		std::lock_guard<std::mutex> lock(this->snapshot->mutex);
+		if (!this->snapshot->finished) this->snapshot->failed = true;
+	}
 
-		if (this->current == nullptr) this->current.reset(new Packet(PACKET_SERVER_MAP_DATA, SHRT_MAX));
+	/** Append the current packet to the snapshot. */
+	void AppendPacket()
+	{
+		SharedPacket packet = Packet::Share(std::move(this->current));
 
-		std::lock_guard<std::mutex> lock(this->mutex);
+		std::lock_guard<std::mutex> lock(this->snapshot->mutex);
+		this->snapshot->packets.push_back(std::move(packet));
+	}
 
+	void Write(byte *buf, size_t size) override
+	{
 		byte *bufe = buf + size;
 		while (buf != bufe) {
+			if (this->current == nullptr) this->current.reset(new Packet(PACKET_SERVER_MAP_DATA, SHRT_MAX));
+
 			size_t written = this->current->Send_binary_until_full(buf, bufe);
 			buf += written;
 
-			if (!this->current->CanWriteToPacket(1)) {
-				this->AppendQueue();
-				if (buf != bufe) this->current.reset(new Packet(PACKET_SERVER_MAP_DATA, SHRT_MAX));
-			}
+			if (!this->current->CanWriteToPacket(1)) this->AppendPacket();
 		}
 
 		this->total_size += size;
@@ -171,24 +184,28 @@ struct PacketWriter : SaveFilter {
 
 	void Finish() override
 	{
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
-
-		std::lock_guard<std::mutex> lock(this->mutex);
+		if (this->current != nullptr) this->AppendPacket();
 
-		/* Make sure the last packet is flushed. */
-		this->AppendQueue();
-
-		/* Add a packet stating that this is the end to the queue. */
-		this->current.reset(new Packet(PACKET_SERVER_MAP_DONE, SHRT_MAX));
-		this->AppendQueue();
-
-		/* Fast-track the size to the client. */
-		this->map_size_packet.reset(new Packet(PACKET_SERVER_MAP_SIZE, SHRT_MAX));
-		this->map_size_packet->Send_uint32((uint32_t)this->total_size);
+		std::lock_guard<std::mutex> lock(this->snapshot->mutex);
+		this->snapshot->total_size = this->total_size;
+		this->snapshot->finished = true;
 	}
 };
 
+/**
+ * Record a command which has been distributed to the clients, so clients which join using the current map snapshot get it as well.
+ * @param cp The command.
+ */
+void NetworkRecordMapSnapshotCommand(const CommandPacket &cp)
+{
+	if (_network_map_snapshot == nullptr || _frame_counter - _network_map_snapshot->frame > _settings_client.network.map_snapshot_window) return;
+
+	CommandPacket c = cp;
+	c.callback = nullptr;
+	c.my_cmd = false;
+	_network_map_snapshot->commands.Append(std::move(c));
+}
+
 
 /**
  * Create a new socket for the server side of the game connection.
@@ -218,11 +235,6 @@ ServerNetworkGameSocketHandler::~ServerNetworkGameSocketHandler()
 
 	extern void RemoveVirtualTrainsOfUser(uint32_t user);
 	RemoveVirtualTrainsOfUser(this->client_id);
-
-	if (this->savegame != nullptr) {
-		this->savegame->Destroy();
-		this->savegame = nullptr;
-	}
 }
 
 bool ServerNetworkGameSocketHandler::ParseKeyPasswordPacket(Packet *p, NetworkSharedSecrets &ss, const std::string &password, std::string *payload, size_t length)
@@ -321,12 +333,9 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 		}
 	}
 
-	/* If we were transfering a map to this client, stop the savegame creation
-	 * process and queue the next client to receive the map. */
+	/* If we were transfering a map to this client, queue the next client to receive the map. */
 	if (this->status == STATUS_MAP) {
-		/* Ensure the saving of the game is stopped too. */
-		this->savegame->Destroy();
-		this->savegame = nullptr;
+		this->map_snapshot.reset();
 
 		this->CheckNextClientToSendMap(this);
 	}
@@ -364,6 +373,18 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 	return accept;
 }
 
+/**
+ * Handle the packets received by the network thread, and the sockets watched by this thread.
+ * @return true if everything went okay.
+ */
+/* static */ bool ServerNetworkGameSocketHandler::Receive()
+{
+	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+		if (cs->io != nullptr && !cs->IsPendingDeletion()) cs->ReceivePackets();
+	}
+	return TCPListenHandler::Receive();
+}
+
 /** Send the packets for the server sockets. */
 /* static */ void ServerNetworkGameSocketHandler::Send()
 {
@@ -602,28 +623,48 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendWait()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Whether a client can be sent the map now, either using the current map snapshot or a new one.
+ * @param cs The client that wants to join.
+ * @return True iff the client does not need to wait.
+ */
+static bool CanSendMapTo(NetworkClientSocket *cs)
+{
+	return _network_map_snapshot == nullptr || _network_map_snapshot->IsUsableFor(cs) || _network_map_snapshot->IsDone();
+}
+
 void ServerNetworkGameSocketHandler::CheckNextClientToSendMap(NetworkClientSocket *ignore_cs)
 {
-	/* Find the best candidate for joining, i.e. the first joiner. */
-	NetworkClientSocket *best = nullptr;
-	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
-		if (ignore_cs == new_cs) continue;
+	/* Forget the snapshot once it is complete and too old for new clients; the clients still downloading it keep it alive. */
+	if (_network_map_snapshot != nullptr && _frame_counter - _network_map_snapshot->frame > _settings_client.network.map_snapshot_window && _network_map_snapshot->IsDone()) {
+		_network_map_snapshot.reset();
+	}
 
-		if (new_cs->status == STATUS_MAP_WAIT) {
-			if (best == nullptr || best->GetInfo()->join_date > new_cs->GetInfo()->join_date || (best->GetInfo()->join_date == new_cs->GetInfo()->join_date && best->client_id > new_cs->client_id)) {
-				best = new_cs;
-			}
-		}
+	/* Collect the waiting clients, the first joiner first. */
+	std::vector<NetworkClientSocket *> waiting;
+	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
+		if (ignore_cs != new_cs && new_cs->status == STATUS_MAP_WAIT) waiting.push_back(new_cs);
 	}
+	if (waiting.empty()) return;
 
-	/* Is there someone else to join? */
-	if (best != nullptr) {
-		/* Let the first start joining. */
-		best->status = STATUS_AUTHORIZED;
-		best->SendMap();
+	std::sort(waiting.begin(), waiting.end(), [](const NetworkClientSocket *a, const NetworkClientSocket *b) {
+		if (a->GetInfo()->join_date != b->GetInfo()->join_date) return a->GetInfo()->join_date < b->GetInfo()->join_date;
+		return a->client_id < b->client_id;
+	});
 
-		/* And update the rest. */
-		for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
+	/* Let everyone join who can share the current snapshot, or start a new one. */
+	bool started = false;
+	for (NetworkClientSocket *new_cs : waiting) {
+		if (!CanSendMapTo(new_cs)) continue;
+
+		new_cs->status = STATUS_AUTHORIZED;
+		new_cs->SendMap();
+		started = true;
+	}
+
+	/* And update the rest. */
+	if (started) {
+		for (NetworkClientSocket *new_cs : waiting) {
 			if (new_cs->status == STATUS_MAP_WAIT) new_cs->SendWait();
 		}
 	}
@@ -638,38 +679,54 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 	}
 
 	if (this->status == STATUS_AUTHORIZED) {
-		WaitTillSaved();
-		this->savegame = new PacketWriter(this);
+		if (_network_map_snapshot == nullptr || !_network_map_snapshot->IsUsableFor(this)) {
+			WaitTillSaved();
+			_network_map_snapshot = std::make_shared<NetworkMapSnapshot>(_frame_counter, this->supports_zstd);
+			NetworkSyncCommandQueue(_network_map_snapshot->commands);
+
+			/* Make a dump of the current game */
+			SaveModeFlags flags = SMF_NET_SERVER;
+			if (this->supports_zstd) flags |= SMF_ZSTD_OK;
+			if (SaveWithFilter(new NetworkMapSnapshotWriter(_network_map_snapshot), true, flags) != SL_OK) usererror("network savedump failed");
+		} else {
+			DEBUG(net, 3, "[%s] Client #%u shares the map snapshot of frame %u", ServerNetworkGameSocketHandler::GetName(), this->client_id, _network_map_snapshot->frame);
+		}
+		this->map_snapshot = _network_map_snapshot;
+		this->map_packets_sent = 0;
+		this->map_size_sent = false;
 
-		/* Now send the _frame_counter and how many packets are coming */
+		/* Now send the frame of the snapshot and how many packets are coming */
 		Packet *p = new Packet(PACKET_SERVER_MAP_BEGIN, SHRT_MAX);
-		p->Send_uint32(_frame_counter);
+		p->Send_uint32(this->map_snapshot->frame);
 		this->SendPacket(p);
 
-		NetworkSyncCommandQueue(this);
+		/* The commands after the snapshot frame, the ones distributed from now on are queued as for every other client. */
+		for (CommandPacket *cp = this->map_snapshot->commands.Peek(); cp != nullptr; cp = cp->next) {
+			this->outgoing_queue.Append(*cp);
+		}
 		this->status = STATUS_MAP;
 		/* Mark the start of download */
 		this->last_frame = _frame_counter;
 		this->last_frame_server = _frame_counter;
-
-		/* Make a dump of the current game */
-		SaveModeFlags flags = SMF_NET_SERVER;
-		if (this->supports_zstd) flags |= SMF_ZSTD_OK;
-		if (SaveWithFilter(this->savegame, true, flags) != SL_OK) usererror("network savedump failed");
 	}
 
 	if (this->status == STATUS_MAP) {
-		bool last_packet = this->savegame->TransferToNetworkQueue(this);
-		if (last_packet) {
-			/* Done reading, make sure saving is done as well */
-			this->savegame->Destroy();
-			this->savegame = nullptr;
+		switch (this->map_snapshot->TransferToNetworkQueue(this)) {
+			case MTS_IN_PROGRESS:
+				break;
 
-			/* Set the status to DONE_MAP, no we will wait for the client
-			 *  to send it is ready (maybe that happens like never ;)) */
-			this->status = STATUS_DONE_MAP;
+			case MTS_DONE:
+				this->map_snapshot.reset();
+
+				/* Set the status to DONE_MAP, no we will wait for the client
+				 *  to send it is ready (maybe that happens like never ;)) */
+				this->status = STATUS_DONE_MAP;
+
+				this->CheckNextClientToSendMap();
+				break;
 
-			this->CheckNextClientToSendMap();
+			case MTS_FAILED:
+				return this->SendError(NETWORK_ERROR_GENERAL);
 		}
 	}
 	return NETWORK_RECV_STATUS_OKAY;
@@ -692,7 +749,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 /** Tell the client that they may run to a particular frame. */
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 {
-	Packet *p = new Packet(PACKET_SERVER_FRAME, SHRT_MAX);
+	std::unique_ptr<Packet> p = Packet::Create(PACKET_SERVER_FRAME, SHRT_MAX);
 	p->Send_uint32(_frame_counter);
 	p->Send_uint32(_frame_counter_max);
 #ifdef ENABLE_NETWORK_SYNC_EVERY_FRAME
@@ -706,35 +763,45 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 		p->Send_uint8(this->last_token);
 	}
 
-	this->SendPacket(p);
+	this->SendPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
 /** Request the client to sync. */
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
 {
-	Packet *p = new Packet(PACKET_SERVER_SYNC, SHRT_MAX);
+	std::unique_ptr<Packet> p = Packet::Create(PACKET_SERVER_SYNC, SHRT_MAX);
 	p->Send_uint32(_frame_counter);
 	p->Send_uint32(_sync_seed_1);
 
 	p->Send_uint64(_sync_state_checksum);
-	this->SendPacket(p);
+	this->SendPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Serialise a command for the clients to execute.
+ * @param cp The command to serialise.
+ * @return The packet, which can be queued for every client that should receive this exact command.
+ */
+/* static */ SharedPacket ServerNetworkGameSocketHandler::SerialiseCommand(const CommandPacket &cp)
+{
+	std::unique_ptr<Packet> p = Packet::Create(PACKET_SERVER_COMMAND, SHRT_MAX);
+
+	NetworkGameSocketHandler::SendCommand(p.get(), &cp);
+	p->Send_uint32(cp.frame);
+	p->Send_bool  (cp.my_cmd);
+
+	return Packet::Share(std::move(p));
+}
+
 /**
  * Send a command to the client to execute.
  * @param cp The command to send.
  */
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacket *cp)
 {
-	Packet *p = new Packet(PACKET_SERVER_COMMAND, SHRT_MAX);
-
-	this->NetworkGameSocketHandler::SendCommand(p, cp);
-	p->Send_uint32(cp->frame);
-	p->Send_bool  (cp->my_cmd);
-
-	this->SendPacket(p);
+	this->SendPacket(cp->serialised != nullptr ? cp->serialised : SerialiseCommand(*cp));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -1119,13 +1186,11 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_GETMAP(Packet *
 
 	this->supports_zstd = p->Recv_bool();
 
-	/* Check if someone else is receiving the map */
-	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
-		if (new_cs->status == STATUS_MAP) {
-			/* Tell the new client to wait */
-			this->status = STATUS_MAP_WAIT;
-			return this->SendWait();
-		}
+	/* Check if someone else is receiving a map snapshot this client can not use */
+	if (!CanSendMapTo(this)) {
+		/* Tell the new client to wait */
+		this->status = STATUS_MAP_WAIT;
+		return this->SendWait();
 	}
 
 	/* We receive a request to upload the map.. give it to the client! */
@@ -2005,12 +2070,42 @@ static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
 	}
 }
 
+NetworkServerStats _network_server_stats; ///< The statistics of the last completed period.
+
+/** Account for the start of a new tick in the timing statistics. */
+static void UpdateNetworkServerStats()
+{
+	static NetworkServerStats current;
+	static std::chrono::steady_clock::time_point last_tick;
+	static std::chrono::microseconds last_interval{0};
+
+	auto now = std::chrono::steady_clock::now();
+	if (last_tick != std::chrono::steady_clock::time_point{}) {
+		auto interval = std::chrono::duration_cast<std::chrono::microseconds>(now - last_tick);
+		current.ticks++;
+		current.total_tick_interval += interval;
+		current.max_tick_interval = std::max(current.max_tick_interval, interval);
+		if (last_interval.count() != 0) current.total_tick_jitter += std::chrono::abs(interval - last_interval);
+		last_interval = interval;
+	}
+	last_tick = now;
+
+	if (current.ticks == NetworkServerStats::PERIOD_TICKS) {
+		current.io = _network_io_stats;
+		_network_io_stats = {};
+		_network_server_stats = current;
+		current = {};
+	}
+}
+
 /**
  * This is called every tick if this is a _network_server
  * @param send_frame Whether to send the frame to the clients.
  */
 void NetworkServer_Tick(bool send_frame)
 {
+	UpdateNetworkServerStats();
+
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 	bool send_sync = false;
 #endif
@@ -2022,6 +2117,9 @@ void NetworkServer_Tick(bool send_frame)
 	}
 #endif
 
+	/* Start sending the map to waiting clients, once the map snapshot they had to wait for is complete. */
+	ServerNetworkGameSocketHandler::CheckNextClientToSendMap();
+
 	/* Now we are done with the frame, inform the clients that they can
 	 *  do their frame! */
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
@@ -12,6 +12,7 @@
 
 #include "network_internal.h"
 #include "core/tcp_listen.h"
+#include "core/tcp_io_thread.h"
 
 class ServerNetworkGameSocketHandler;
 /** Make the code look slightly nicer/simpler. */
@@ -76,6 +77,13 @@ public:
 
 	static const char *GetClientStatusName(ClientStatus status);
 
+	/** Status of the transfer of a map snapshot to a client. */
+	enum MapTransferStatus {
+		MTS_IN_PROGRESS, ///< Not all packets have been queued yet.
+		MTS_DONE,        ///< All packets, including the final one, have been queued.
+		MTS_FAILED,      ///< Writing the map snapshot failed.
+	};
+
 	byte lag_test;               ///< Byte used for lag-testing the client
 	byte last_token;             ///< The last random token we did send to verify the client is listening
 	uint32_t last_token_frame;   ///< The last frame we received the right token
@@ -85,7 +93,9 @@ public:
 	bool settings_authed = false;///< Authorised to control all game settings
 	bool supports_zstd = false;  ///< Client supports zstd compression
 
-	struct PacketWriter *savegame; ///< Writer used to write the savegame.
+	std::shared_ptr<struct NetworkMapSnapshot> map_snapshot; ///< The map snapshot being sent to the client.
+	size_t map_packets_sent = 0;   ///< Number of packets of the map snapshot queued for sending.
+	bool map_size_sent = false;    ///< Whether the size of the map snapshot has been queued for sending.
 	NetworkAddress client_address; ///< IP-address of the client (so they can be banned)
 
 	std::string desync_log;
@@ -101,7 +111,7 @@ public:
 	NetworkRecvStatus CloseConnection(NetworkRecvStatus status) override;
 	void GetClientName(char *client_name, const char *last) const;
 
-	void CheckNextClientToSendMap(NetworkClientSocket *ignore_cs = nullptr);
+	static void CheckNextClientToSendMap(NetworkClientSocket *ignore_cs = nullptr);
 
 	NetworkRecvStatus SendWait();
 	NetworkRecvStatus SendMap();
@@ -122,6 +132,7 @@ public:
 	NetworkRecvStatus SendFrame();
 	NetworkRecvStatus SendSync();
 	NetworkRecvStatus SendCommand(const CommandPacket *cp);
+	static SharedPacket SerialiseCommand(const CommandPacket &cp);
 	NetworkRecvStatus SendCompanyUpdate();
 	NetworkRecvStatus SendConfigUpdate();
 	NetworkRecvStatus SendSettingsAccessUpdate(bool ok);
@@ -136,6 +147,7 @@ public:
 		return this->intl_keys;
 	}
 
+	static bool Receive();
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
 	static bool AllowConnection();
@@ -154,6 +166,19 @@ public:
 	static ServerNetworkGameSocketHandler *GetByClientID(ClientID client_id);
 };
 
+/** Timing statistics of the server's game loop and network thread, reported to the admin port. */
+struct NetworkServerStats {
+	static const uint32_t PERIOD_TICKS = 256;       ///< Number of ticks over which the statistics are collected.
+
+	uint32_t ticks = 0;                             ///< Number of ticks in the period.
+	std::chrono::microseconds total_tick_interval{0}; ///< Total wall clock time between the starts of consecutive ticks.
+	std::chrono::microseconds max_tick_interval{0};   ///< Longest wall clock time between the starts of consecutive ticks.
+	std::chrono::microseconds total_tick_jitter{0};   ///< Total difference between the lengths of consecutive tick intervals.
+	NetworkIOStats io;                              ///< Packets handed over by the network thread during the period.
+};
+
+extern NetworkServerStats _network_server_stats;
+
 void NetworkServer_Tick(bool send_frame);
 void NetworkServerSetCompanyPassword(CompanyID company_id, const std::string &password, bool already_hashed = true);
 void NetworkServerUpdateCompanyPassworded(CompanyID company_id, bool passworded);
@@ -28,8 +28,7 @@
 #include "fios.h"
 
 #include "thread.h"
-#include <mutex>
-#include <condition_variable>
+#include "worker_thread.h"
 
 #include "safeguards.h"
 
@@ -288,13 +287,11 @@ struct GRFMD5SumState {
 	FILE *f;
 };
 
-static uint _grf_md5_parallel = 0;
-static uint _grf_md5_threads = 0;
-static std::mutex _grf_md5_lock;
-static std::vector<GRFMD5SumState> _grf_md5_pending;
-static std::condition_variable _grf_md5_full_cv;
-static std::condition_variable _grf_md5_empty_cv;
-static std::condition_variable _grf_md5_done_cv;
+/** Tasks calculating MD5 sums of NewGRFs whilst scanning, or nullptr when these are calculated by the scanning thread. */
+static std::unique_ptr<WorkerTaskGroup> _grf_md5_tasks;
+/** Number of NewGRF files which are open for outstanding MD5 sum calculations. */
+static std::atomic<uint> _grf_md5_pending = 0;
+/** Maximum number of NewGRF files which are open for outstanding MD5 sum calculations. */
 static const uint GRF_MD5_PENDING_MAX = 8;
 
 static void CalcGRFMD5SumFromState(const GRFMD5SumState &state)
@@ -312,42 +309,14 @@ static void CalcGRFMD5SumFromState(const GRFMD5SumState &state)
 	FioFCloseFile(state.f);
 }
 
-void CalcGRFMD5Thread()
-{
-	std::unique_lock<std::mutex> lk(_grf_md5_lock);
-	while (_grf_md5_parallel > 0 || !_grf_md5_pending.empty()) {
-		if (_grf_md5_pending.empty()) {
-			_grf_md5_empty_cv.wait(lk);
-		} else {
-			const bool full = _grf_md5_pending.size() == GRF_MD5_PENDING_MAX;
-			GRFMD5SumState state = _grf_md5_pending.back();
-			_grf_md5_pending.pop_back();
-			lk.unlock();
-			if (full) _grf_md5_full_cv.notify_one();
-			if (!_exit_game) CalcGRFMD5SumFromState(state);
-			lk.lock();
-		}
-	}
-	_grf_md5_threads--;
-	if (_grf_md5_threads == 0) {
-		_grf_md5_done_cv.notify_all();
-	}
-}
-
 void CalcGRFMD5ThreadingStart()
 {
-	_grf_md5_parallel = std::thread::hardware_concurrency();
-	if (_grf_md5_parallel <= 1) _grf_md5_parallel = 0;
+	if (_general_worker_pool.GetWorkerCount() > 0) _grf_md5_tasks = std::make_unique<WorkerTaskGroup>(_general_worker_pool);
 }
 
 void CalcGRFMD5ThreadingEnd()
 {
-	if (_grf_md5_parallel) {
-		std::unique_lock<std::mutex> lk(_grf_md5_lock);
-		_grf_md5_parallel = 0;
-		_grf_md5_empty_cv.notify_all();
-		_grf_md5_done_cv.wait(lk, []() { return _grf_md5_threads == 0; });
-	}
+	_grf_md5_tasks.reset();
 }
 
 /**
@@ -374,28 +343,21 @@ static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 
 	/* calculate md5sum */
 	GRFMD5SumState state { config, size, f };
-	if (_grf_md5_parallel == 0) {
+	if (_grf_md5_tasks == nullptr || _grf_md5_pending.load() >= GRF_MD5_PENDING_MAX) {
+		/* Also calculate it here when too many files are already open. */
 		CalcGRFMD5SumFromState(state);
 		return true;
 	}
 
-	std::unique_lock<std::mutex> lk(_grf_md5_lock);
-	if (_grf_md5_pending.size() >= GRF_MD5_PENDING_MAX) {
-		_grf_md5_full_cv.wait(lk);
-	}
-	_grf_md5_pending.push_back(state);
-	bool notify_reader = (_grf_md5_pending.size() == 1); // queue was empty
-	if ((_grf_md5_threads == 0) || ((_grf_md5_pending.size() > 1) && (_grf_md5_threads < _grf_md5_parallel))) {
-		_grf_md5_threads++;
-		if (!StartNewThread(nullptr, "ottd:grf-md5", &CalcGRFMD5Thread)) {
-			_grf_md5_parallel = 0;
-			lk.unlock();
-			CalcGRFMD5Thread();
-			return true;
+	_grf_md5_pending++;
+	_grf_md5_tasks->Run([state]() {
+		if (!_exit_game) {
+			CalcGRFMD5SumFromState(state);
+		} else {
+			FioFCloseFile(state.f);
 		}
-	}
-	lk.unlock();
-	if (notify_reader) _grf_md5_empty_cv.notify_one();
+		_grf_md5_pending--;
+	});
 	return true;
 }
 
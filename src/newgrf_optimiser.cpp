@@ -2618,6 +2618,113 @@ static void PopulateRegistersUsedByNewGRFSpriteLayout(const NewGRFSpriteLayout &
 	}
 }
 
+static DeterministicSpriteGroupOpcode GetDeterministicSpriteGroupFetchOpcode(uint16_t variable)
+{
+	switch (variable) {
+		case 0x0C: return DSGI_FETCH_CALLBACK;
+		case 0x10: return DSGI_FETCH_PARAM1;
+		case 0x18: return DSGI_FETCH_PARAM2;
+		case 0x1C: return DSGI_FETCH_LAST_VALUE;
+		case 0x5F: return DSGI_FETCH_RANDOM;
+		case 0x7B: return DSGI_FETCH_INDIRECT;
+		case 0x7D: return DSGI_FETCH_TEMP;
+		case 0x7E: return DSGI_CALL;
+		case 0x7F: return DSGI_FETCH_GRF_PARAM;
+		default:   return variable < 0x40 ? DSGI_FETCH_GLOBAL : DSGI_FETCH_SCOPE;
+	}
+}
+
+/**
+ * Lower the adjusts of a group to bytecode, once they are not changed anymore.
+ * Constant operands are evaluated, variable fetches are specialised by the kind of variable, operand types
+ * are only applied when present, and jumps and skips are resolved to instruction indices.
+ */
+void OptimiseVarAction2DeterministicSpriteGroupLowerBytecode(DeterministicSpriteGroup *group)
+{
+	group->bytecode.clear();
+	if (HasGrfOptimiserFlag(NGOF_NO_OPT_VARACT2_BYTECODE)) return;
+
+	std::vector<DeterministicSpriteGroupInstruction> &code = group->bytecode;
+	std::vector<uint32_t> adjust_starts;
+	std::vector<std::pair<size_t, size_t>> targets; ///< Instructions whose target is the start of an adjust.
+	adjust_starts.reserve(group->adjusts.size() + 1);
+
+	auto emit = [&](DeterministicSpriteGroupOpcode opcode, uint16_t variable = 0, uint8_t shift_num = 0, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0) {
+		code.push_back({ opcode, shift_num, variable, a, b, c });
+	};
+
+	for (size_t i = 0; i < group->adjusts.size(); i++) {
+		const DeterministicSpriteGroupAdjust &adjust = group->adjusts[i];
+		adjust_starts.push_back((uint32_t)code.size());
+
+		DeterministicSpriteGroupOpcode op_opcode;
+		DeterministicSpriteGroupOpcode imm_opcode;
+		switch (adjust.operation) {
+#define DSGI_OP_OPCODES(name) case DSGA_OP_##name: op_opcode = DSGI_OP_##name; imm_opcode = DSGI_IMM_##name; break;
+			DSGA_OP_LIST(DSGI_OP_OPCODES)
+#undef DSGI_OP_OPCODES
+			default:
+				/* Unknown operation, keep evaluating the adjusts */
+				code.clear();
+				return;
+		}
+
+		if (adjust.adjust_flags & DSGAF_SKIP_ON_ZERO) {
+			targets.emplace_back(code.size(), i + 1);
+			emit(DSGI_SKIP_ON_ZERO);
+		}
+		if (adjust.adjust_flags & DSGAF_SKIP_ON_LSB_SET) {
+			targets.emplace_back(code.size(), i + 1);
+			emit(DSGI_SKIP_ON_LSB_SET);
+		}
+
+		const bool is_jump = (adjust.operation >= DSGA_OP_JZ && adjust.operation <= DSGA_OP_JNZ_LV);
+		const uint32_t c = is_jump ? 0 : adjust.divmod_val;
+
+		if (adjust.variable == 0x1A) {
+			emit(imm_opcode, adjust.variable, 0, EvaluateDeterministicSpriteGroupAdjustOperand(group->size, adjust, UINT_MAX), adjust.add_val, c);
+		} else {
+			const DeterministicSpriteGroupOpcode fetch = GetDeterministicSpriteGroupFetchOpcode(adjust.variable);
+			switch (fetch) {
+				case DSGI_CALL:
+					emit(fetch, adjust.variable, adjust.shift_num, (uint32_t)i, adjust.and_mask);
+					break;
+
+				case DSGI_FETCH_INDIRECT:
+					emit(fetch, adjust.parameter, adjust.shift_num, 0, adjust.and_mask, adjust.and_mask << adjust.shift_num);
+					break;
+
+				default:
+					emit(fetch, adjust.variable, adjust.shift_num, adjust.parameter, adjust.and_mask, adjust.and_mask << adjust.shift_num);
+					break;
+			}
+			switch (adjust.type) {
+				case DSGA_TYPE_DIV: emit(DSGI_DIV, 0, 0, adjust.add_val, adjust.divmod_val); break;
+				case DSGA_TYPE_MOD: emit(DSGI_MOD, 0, 0, adjust.add_val, adjust.divmod_val); break;
+				case DSGA_TYPE_EQ:  emit(DSGI_EQ,  0, 0, adjust.add_val, adjust.divmod_val); break;
+				case DSGA_TYPE_NEQ: emit(DSGI_NEQ, 0, 0, adjust.add_val, adjust.divmod_val); break;
+				case DSGA_TYPE_NONE: break;
+			}
+			emit(op_opcode, 0, 0, 0, adjust.add_val, c);
+		}
+
+		/* Jumps skip the given number of following adjusts */
+		if (is_jump) targets.emplace_back(code.size() - 1, i + 1 + adjust.jump);
+	}
+	adjust_starts.push_back((uint32_t)code.size());
+	emit(DSGI_END);
+
+	for (const auto &it : targets) {
+		if (it.second >= adjust_starts.size()) {
+			/* Jump past the end, keep evaluating the adjusts */
+			code.clear();
+			return;
+		}
+		code[it.first].c = adjust_starts[it.second];
+	}
+	code.shrink_to_fit();
+}
+
 void OptimiseVarAction2DeterministicSpriteGroup(VarAction2OptimiseState &state, const VarAction2AdjustInfo info, DeterministicSpriteGroup *group, std::vector<DeterministicSpriteGroupAdjust> &saved_adjusts)
 {
 	if (unlikely(HasGrfOptimiserFlag(NGOF_NO_OPT_VARACT2))) return;
@@ -2822,7 +2929,10 @@ void OptimiseVarAction2DeterministicSpriteGroup(VarAction2OptimiseState &state,
 		}
 	}
 
-	if (!dse_candidate) group->adjusts.shrink_to_fit();
+	if (!dse_candidate) {
+		group->adjusts.shrink_to_fit();
+		OptimiseVarAction2DeterministicSpriteGroupLowerBytecode(group);
+	}
 }
 
 static std::bitset<256> HandleVarAction2DeadStoreElimination(DeterministicSpriteGroup *group, VarAction2GroupVariableTracking *var_tracking, bool no_changes)
@@ -3219,6 +3329,7 @@ void HandleVarAction2OptimisationPasses()
 		}
 
 		group->adjusts.shrink_to_fit();
+		OptimiseVarAction2DeterministicSpriteGroupLowerBytecode(group);
 	}
 }
 
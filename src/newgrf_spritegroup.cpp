@@ -167,44 +167,38 @@ static inline uint32_t GetVariable(const ResolverObject &object, ScopeResolver *
 	return &this->default_scope;
 }
 
-/* Evaluate an adjustment for a variable of the given size.
+/* Apply the type of an adjustment to its shifted and masked variable value.
  * U is the unsigned type and S is the signed type to use. */
 template <typename U, typename S>
-static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, U last_value, uint32_t value, const DeterministicSpriteGroupAdjust **adjust_iter = nullptr)
+static inline uint32_t EvalAdjustTypeT(DeterministicSpriteGroupAdjustType type, uint32_t value, uint32_t add_val, uint32_t divmod_val)
 {
-	value >>= adjust.shift_num;
-	value  &= adjust.and_mask;
-
-	switch (adjust.type) {
-		case DSGA_TYPE_DIV:  value = ((S)value + (S)adjust.add_val) / (S)adjust.divmod_val; break;
-		case DSGA_TYPE_MOD:  value = ((S)value + (S)adjust.add_val) % (S)adjust.divmod_val; break;
-		case DSGA_TYPE_EQ:   value = (value == adjust.add_val) ? 1 : 0; break;
-		case DSGA_TYPE_NEQ:  value = (value != adjust.add_val) ? 1 : 0; break;
+	switch (type) {
+		case DSGA_TYPE_DIV:  return ((S)value + (S)add_val) / (S)divmod_val;
+		case DSGA_TYPE_MOD:  return ((S)value + (S)add_val) % (S)divmod_val;
+		case DSGA_TYPE_EQ:   return (value == add_val) ? 1 : 0;
+		case DSGA_TYPE_NEQ:  return (value != add_val) ? 1 : 0;
 		case DSGA_TYPE_NONE: break;
 	}
+	return value;
+}
 
-	auto handle_jump = [&](bool jump, U jump_return_value) -> U {
-		if (jump && adjust_iter != nullptr) {
-			/* Jump */
-			(*adjust_iter) += adjust.jump;
-			return jump_return_value;
-		} else {
-			/* Don't jump */
-			return last_value;
-		}
-	};
-
-	switch (adjust.operation) {
+/* Evaluate the operation OP of an adjustment.
+ * U is the unsigned type and S is the signed type to use.
+ * Jump operations set jump if they jump, the result is then the value to continue with. */
+template <typename U, typename S, DeterministicSpriteGroupAdjustOperation OP>
+static inline U EvalAdjustOperationT(ScopeResolver *scope, U last_value, uint32_t value, uint32_t add_val, uint32_t divmod_val, bool &jump)
+{
+	switch (OP) {
 		case DSGA_OP_ADD:  return last_value + value;
 		case DSGA_OP_SUB:  return last_value - value;
 		case DSGA_OP_SMIN: return std::min<S>(last_value, value);
 		case DSGA_OP_SMAX: return std::max<S>(last_value, value);
 		case DSGA_OP_UMIN: return std::min<U>(last_value, value);
 		case DSGA_OP_UMAX: return std::max<U>(last_value, value);
-		case DSGA_OP_SDIV: return value == 0 ? (S)last_value : (S)last_value / (S)value;
-		case DSGA_OP_SMOD: return value == 0 ? (S)last_value : (S)last_value % (S)value;
-		case DSGA_OP_UDIV: return value == 0 ? (U)last_value : (U)last_value / (U)value;
-		case DSGA_OP_UMOD: return value == 0 ? (U)last_value : (U)last_value % (U)value;
+		case DSGA_OP_SDIV: return (U)value == 0 ? (S)last_value : (S)last_value / (S)value;
+		case DSGA_OP_SMOD: return (U)value == 0 ? (S)last_value : (S)last_value % (S)value;
+		case DSGA_OP_UDIV: return (U)value == 0 ? (U)last_value : (U)last_value / (U)value;
+		case DSGA_OP_UMOD: return (U)value == 0 ? (U)last_value : (U)last_value % (U)value;
 		case DSGA_OP_MUL:  return last_value * value;
 		case DSGA_OP_AND:  return last_value & value;
 		case DSGA_OP_OR:   return last_value | value;
@@ -218,24 +212,50 @@ static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver
 		case DSGA_OP_SHL:  return (uint32_t)(U)last_value << ((U)value & 0x1F); // Same behaviour as in ParamSet, mask 'value' to 5 bits, which should behave the same on all architectures.
 		case DSGA_OP_SHR:  return (uint32_t)(U)last_value >> ((U)value & 0x1F);
 		case DSGA_OP_SAR:  return (int32_t)(S)last_value >> ((U)value & 0x1F);
-		case DSGA_OP_TERNARY: return (last_value != 0) ? value : adjust.add_val;
+		case DSGA_OP_TERNARY: return (last_value != 0) ? value : add_val;
 		case DSGA_OP_EQ:   return (last_value == value) ? 1 : 0;
 		case DSGA_OP_SLT:  return ((S)last_value <  (S)value) ? 1 : 0;
 		case DSGA_OP_SGE:  return ((S)last_value >= (S)value) ? 1 : 0;
 		case DSGA_OP_SLE:  return ((S)last_value <= (S)value) ? 1 : 0;
 		case DSGA_OP_SGT:  return ((S)last_value >  (S)value) ? 1 : 0;
 		case DSGA_OP_RSUB: return value - last_value;
-		case DSGA_OP_STO_NC: _temp_store.StoreValue(adjust.divmod_val, (S)value); return last_value;
+		case DSGA_OP_STO_NC: _temp_store.StoreValue(divmod_val, (S)value); return last_value;
 		case DSGA_OP_ABS:  return ((S)last_value < 0) ? -((S)last_value) : (S)last_value;
-		case DSGA_OP_JZ:     return handle_jump(value == 0, value);
-		case DSGA_OP_JNZ:    return handle_jump(value != 0, value);
-		case DSGA_OP_JZ_LV:  return handle_jump(last_value == 0, last_value);
-		case DSGA_OP_JNZ_LV: return handle_jump(last_value != 0, last_value);
+		case DSGA_OP_JZ:     jump = (value == 0); return jump ? (U)value : last_value;
+		case DSGA_OP_JNZ:    jump = (value != 0); return jump ? (U)value : last_value;
+		case DSGA_OP_JZ_LV:  jump = (last_value == 0); return last_value;
+		case DSGA_OP_JNZ_LV: jump = (last_value != 0); return last_value;
 		case DSGA_OP_NOOP: return last_value;
 		default:           return value;
 	}
 }
 
+/* Evaluate an adjustment for a variable of the given size.
+ * U is the unsigned type and S is the signed type to use. */
+template <typename U, typename S>
+static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, U last_value, uint32_t value, const DeterministicSpriteGroupAdjust **adjust_iter = nullptr)
+{
+	value >>= adjust.shift_num;
+	value  &= adjust.and_mask;
+	value = EvalAdjustTypeT<U, S>(adjust.type, value, adjust.add_val, adjust.divmod_val);
+
+	bool jump = false;
+	U result;
+	switch (adjust.operation) {
+#define DSGA_OP_CASE(name) case DSGA_OP_##name: result = EvalAdjustOperationT<U, S, DSGA_OP_##name>(scope, last_value, value, adjust.add_val, adjust.divmod_val, jump); break;
+		DSGA_OP_LIST(DSGA_OP_CASE)
+#undef DSGA_OP_CASE
+		default: return value;
+	}
+
+	if (jump) {
+		/* Without an adjust iterator, don't jump */
+		if (adjust_iter == nullptr) return last_value;
+		(*adjust_iter) += adjust.jump;
+	}
+	return result;
+}
+
 uint32_t EvaluateDeterministicSpriteGroupAdjust(DeterministicSpriteGroupSize size, const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, uint32_t last_value, uint32_t value)
 {
 	switch (size) {
@@ -246,6 +266,194 @@ uint32_t EvaluateDeterministicSpriteGroupAdjust(DeterministicSpriteGroupSize siz
 	}
 }
 
+/**
+ * Evaluate the operand of an adjustment: the shifted and masked variable value, with the adjust type applied.
+ * @param size Size of the group.
+ * @param adjust The adjustment.
+ * @param value The variable value.
+ * @return The operand of the operation of the adjustment.
+ */
+uint32_t EvaluateDeterministicSpriteGroupAdjustOperand(DeterministicSpriteGroupSize size, const DeterministicSpriteGroupAdjust &adjust, uint32_t value)
+{
+	value >>= adjust.shift_num;
+	value  &= adjust.and_mask;
+	switch (size) {
+		case DSG_SIZE_BYTE:  return EvalAdjustTypeT<uint8_t,  int8_t> (adjust.type, value, adjust.add_val, adjust.divmod_val);
+		case DSG_SIZE_WORD:  return EvalAdjustTypeT<uint16_t, int16_t>(adjust.type, value, adjust.add_val, adjust.divmod_val);
+		case DSG_SIZE_DWORD: return EvalAdjustTypeT<uint32_t, int32_t>(adjust.type, value, adjust.add_val, adjust.divmod_val);
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Call a procedure (var 7E) of a deterministic sprite group.
+ * @param group The calling group.
+ * @param subroutine The procedure.
+ * @param object The resolver object.
+ * @return The callback result of the procedure.
+ */
+static uint32_t ResolveProcedure(const DeterministicSpriteGroup *group, const SpriteGroup *subroutine, ResolverObject &object)
+{
+	const Vehicle *relative_scope_vehicle = nullptr;
+	VarSpriteGroupScopeOffset relative_scope_cached_count = 0;
+	if (group->var_scope == VSG_SCOPE_RELATIVE) {
+		/* Save relative scope vehicle in case it will be changed during the procedure */
+		VehicleResolverObject *veh_object = dynamic_cast<VehicleResolverObject *>(&object);
+		if (veh_object != nullptr) {
+			relative_scope_vehicle = veh_object->relative_scope.v;
+			relative_scope_cached_count = veh_object->cached_relative_count;
+		}
+	}
+
+	uint32_t value;
+	const SpriteGroup *subgroup = SpriteGroup::Resolve(subroutine, object, false);
+	if (subgroup == nullptr) {
+		value = CALLBACK_FAILED;
+	} else {
+		value = subgroup->GetCallbackResult();
+	}
+
+	if (relative_scope_vehicle != nullptr) {
+		/* Reset relative scope vehicle in case it was changed during the procedure */
+		VehicleResolverObject *veh_object = static_cast<VehicleResolverObject *>(&object);
+		veh_object->relative_scope.v = relative_scope_vehicle;
+		veh_object->cached_relative_count = relative_scope_cached_count;
+	}
+
+	/* Note: 'last_value' and 'reseed' are shared between the main chain and the procedure */
+	return value;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+/* Dispatch every instruction with an indirect jump from the end of the previous one, using labels as values. */
+#	define WITH_DSG_THREADED_DISPATCH
+#endif
+
+/**
+ * Run the bytecode of a deterministic sprite group.
+ * U is the unsigned type and S is the signed type to use.
+ * @param group The group.
+ * @param object The resolver object.
+ * @param scope The scope of the group.
+ * @param[out] result The last value when done.
+ * @return False if a variable is not available.
+ */
+template <typename U, typename S>
+static bool RunDeterministicSpriteGroupBytecode(const DeterministicSpriteGroup *group, ResolverObject &object, ScopeResolver *scope, uint32_t &result)
+{
+	const DeterministicSpriteGroupInstruction *code = group->bytecode.data();
+	const DeterministicSpriteGroupInstruction *ip = code;
+	uint32_t last_value = 0;
+	uint32_t value = 0;
+
+#ifdef WITH_DSG_THREADED_DISPATCH
+#	define DSGI_OP_LABELS(name) &&L_OP_##name, &&L_IMM_##name,
+	static const void * const labels[] = {
+		&&L_END, &&L_SKIP_ON_ZERO, &&L_SKIP_ON_LSB_SET,
+		&&L_FETCH_CALLBACK, &&L_FETCH_PARAM1, &&L_FETCH_PARAM2, &&L_FETCH_LAST_VALUE, &&L_FETCH_RANDOM, &&L_FETCH_TEMP,
+		&&L_FETCH_GRF_PARAM, &&L_FETCH_GLOBAL, &&L_FETCH_SCOPE, &&L_FETCH_INDIRECT, &&L_CALL,
+		&&L_DIV, &&L_MOD, &&L_EQ, &&L_NEQ,
+		DSGA_OP_LIST(DSGI_OP_LABELS)
+	};
+#	undef DSGI_OP_LABELS
+	static_assert(lengthof(labels) == DSGI_OPCODE_END);
+
+#	define DSGI_CASE(name) L_##name
+#	define DSGI_NEXT() goto *labels[ip->opcode]
+#	define DSGI_FALLTHROUGH
+	DSGI_NEXT();
+#else
+#	define DSGI_CASE(name) case DSGI_##name
+#	define DSGI_NEXT() goto dispatch
+#	define DSGI_FALLTHROUGH [[fallthrough]]
+dispatch:
+	switch (ip->opcode) {
+#endif
+
+	/* Shift and mask a fetched variable value, and continue with the next instruction */
+#define DSGI_FETCHED(fetched) { \
+		value = ((fetched) >> ip->shift_num) & ip->b; \
+		ip++; \
+		DSGI_NEXT(); \
+	}
+
+	DSGI_CASE(END):
+		result = last_value;
+		return true;
+
+	DSGI_CASE(SKIP_ON_ZERO):
+		ip = (last_value == 0) ? code + ip->c : ip + 1;
+		DSGI_NEXT();
+
+	DSGI_CASE(SKIP_ON_LSB_SET):
+		ip = ((last_value & 1) != 0) ? code + ip->c : ip + 1;
+		DSGI_NEXT();
+
+	DSGI_CASE(FETCH_CALLBACK):   DSGI_FETCHED(object.callback)
+	DSGI_CASE(FETCH_PARAM1):     DSGI_FETCHED(object.callback_param1)
+	DSGI_CASE(FETCH_PARAM2):     DSGI_FETCHED(object.callback_param2)
+	DSGI_CASE(FETCH_LAST_VALUE): DSGI_FETCHED(object.last_value)
+	DSGI_CASE(FETCH_RANDOM):     DSGI_FETCHED((scope->GetRandomBits() << 8) | scope->GetTriggers())
+	DSGI_CASE(FETCH_TEMP):       DSGI_FETCHED((uint32_t)_temp_store.GetValue(ip->a))
+	DSGI_CASE(FETCH_GRF_PARAM):  DSGI_FETCHED(object.grffile == nullptr ? 0 : object.grffile->GetParam(ip->a))
+
+	DSGI_CASE(FETCH_GLOBAL): {
+		uint32_t fetched;
+		if (!GetGlobalVariable(ip->variable, &fetched, object.grffile)) {
+			GetVariableExtra extra(ip->c);
+			fetched = scope->GetVariable(ip->variable, ip->a, &extra);
+			if (!extra.available) return false;
+		}
+		DSGI_FETCHED(fetched)
+	}
+
+	DSGI_CASE(FETCH_SCOPE): {
+		GetVariableExtra extra(ip->c);
+		uint32_t fetched = scope->GetVariable(ip->variable, ip->a, &extra);
+		if (!extra.available) return false;
+		DSGI_FETCHED(fetched)
+	}
+
+	DSGI_CASE(FETCH_INDIRECT): {
+		_sprite_group_resolve_check_veh_check = false;
+		GetVariableExtra extra(ip->c);
+		uint32_t fetched = GetVariable(object, scope, ip->variable, last_value, &extra);
+		if (!extra.available) return false;
+		DSGI_FETCHED(fetched)
+	}
+
+	DSGI_CASE(CALL): DSGI_FETCHED(ResolveProcedure(group, group->adjusts[ip->a].subroutine, object))
+
+#undef DSGI_FETCHED
+
+	DSGI_CASE(DIV): value = EvalAdjustTypeT<U, S>(DSGA_TYPE_DIV, value, ip->a, ip->b); ip++; DSGI_NEXT();
+	DSGI_CASE(MOD): value = EvalAdjustTypeT<U, S>(DSGA_TYPE_MOD, value, ip->a, ip->b); ip++; DSGI_NEXT();
+	DSGI_CASE(EQ):  value = EvalAdjustTypeT<U, S>(DSGA_TYPE_EQ,  value, ip->a, ip->b); ip++; DSGI_NEXT();
+	DSGI_CASE(NEQ): value = EvalAdjustTypeT<U, S>(DSGA_TYPE_NEQ, value, ip->a, ip->b); ip++; DSGI_NEXT();
+
+#define DSGI_OP_HANDLERS(name) \
+	DSGI_CASE(IMM_##name): \
+		value = ip->a; \
+		DSGI_FALLTHROUGH; \
+	DSGI_CASE(OP_##name): { \
+		bool jump = false; \
+		last_value = EvalAdjustOperationT<U, S, DSGA_OP_##name>(scope, last_value, value, ip->b, ip->c, jump); \
+		ip = jump ? code + ip->c : ip + 1; \
+		DSGI_NEXT(); \
+	}
+	DSGA_OP_LIST(DSGI_OP_HANDLERS)
+#undef DSGI_OP_HANDLERS
+
+#ifndef WITH_DSG_THREADED_DISPATCH
+		default: NOT_REACHED();
+	}
+#endif
+
+#undef DSGI_CASE
+#undef DSGI_NEXT
+#undef DSGI_FALLTHROUGH
+}
+
 static bool RangeHighComparator(const DeterministicSpriteGroupRange &range, uint32_t value)
 {
 	return range.high < value;
@@ -263,62 +471,50 @@ const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) con
 
 	ScopeResolver *scope = object.GetScope(this->var_scope, this->var_scope_count);
 
-	const DeterministicSpriteGroupAdjust *end = this->adjusts.data() + this->adjusts.size();
-	for (const DeterministicSpriteGroupAdjust *iter = this->adjusts.data(); iter != end; ++iter) {
-		const DeterministicSpriteGroupAdjust &adjust = *iter;
-
-		if ((adjust.adjust_flags & DSGAF_SKIP_ON_ZERO) && (last_value == 0)) continue;
-		if ((adjust.adjust_flags & DSGAF_SKIP_ON_LSB_SET) && (last_value & 1) != 0) continue;
-
-		/* Try to get the variable. We shall assume it is available, unless told otherwise. */
-		GetVariableExtra extra(adjust.and_mask << adjust.shift_num);
-		if (adjust.variable == 0x7E) {
-			const Vehicle *relative_scope_vehicle = nullptr;
-			VarSpriteGroupScopeOffset relative_scope_cached_count = 0;
-			if (this->var_scope == VSG_SCOPE_RELATIVE) {
-				/* Save relative scope vehicle in case it will be changed during the procedure */
-				VehicleResolverObject *veh_object = dynamic_cast<VehicleResolverObject *>(&object);
-				if (veh_object != nullptr) {
-					relative_scope_vehicle = veh_object->relative_scope.v;
-					relative_scope_cached_count = veh_object->cached_relative_count;
-				}
-			}
-
-			const SpriteGroup *subgroup = SpriteGroup::Resolve(adjust.subroutine, object, false);
-			if (subgroup == nullptr) {
-				value = CALLBACK_FAILED;
+	if (!this->bytecode.empty()) {
+		bool available;
+		switch (this->size) {
+			case DSG_SIZE_BYTE:  available = RunDeterministicSpriteGroupBytecode<uint8_t,  int8_t> (this, object, scope, last_value); break;
+			case DSG_SIZE_WORD:  available = RunDeterministicSpriteGroupBytecode<uint16_t, int16_t>(this, object, scope, last_value); break;
+			case DSG_SIZE_DWORD: available = RunDeterministicSpriteGroupBytecode<uint32_t, int32_t>(this, object, scope, last_value); break;
+			default: NOT_REACHED();
+		}
+		/* Unsupported variable: return either the group from the first range or the default group. */
+		if (!available) return SpriteGroup::Resolve(this->error_group, object, false);
+		value = last_value;
+	} else {
+		const DeterministicSpriteGroupAdjust *end = this->adjusts.data() + this->adjusts.size();
+		for (const DeterministicSpriteGroupAdjust *iter = this->adjusts.data(); iter != end; ++iter) {
+			const DeterministicSpriteGroupAdjust &adjust = *iter;
+
+			if ((adjust.adjust_flags & DSGAF_SKIP_ON_ZERO) && (last_value == 0)) continue;
+			if ((adjust.adjust_flags & DSGAF_SKIP_ON_LSB_SET) && (last_value & 1) != 0) continue;
+
+			/* Try to get the variable. We shall assume it is available, unless told otherwise. */
+			GetVariableExtra extra(adjust.and_mask << adjust.shift_num);
+			if (adjust.variable == 0x7E) {
+				value = ResolveProcedure(this, adjust.subroutine, object);
+			} else if (adjust.variable == 0x7B) {
+				_sprite_group_resolve_check_veh_check = false;
+				value = GetVariable(object, scope, adjust.parameter, last_value, &extra);
 			} else {
-				value = subgroup->GetCallbackResult();
+				value = GetVariable(object, scope, adjust.variable, adjust.parameter, &extra);
 			}
 
-			if (relative_scope_vehicle != nullptr) {
-				/* Reset relative scope vehicle in case it was changed during the procedure */
-				VehicleResolverObject *veh_object = static_cast<VehicleResolverObject *>(&object);
-				veh_object->relative_scope.v = relative_scope_vehicle;
-				veh_object->cached_relative_count = relative_scope_cached_count;
+			if (!extra.available) {
+				/* Unsupported variable: skip further processing and return either
+				 * the group from the first range or the default group. */
+				return SpriteGroup::Resolve(this->error_group, object, false);
 			}
 
-			/* Note: 'last_value' and 'reseed' are shared between the main chain and the procedure */
-		} else if (adjust.variable == 0x7B) {
-			_sprite_group_resolve_check_veh_check = false;
-			value = GetVariable(object, scope, adjust.parameter, last_value, &extra);
-		} else {
-			value = GetVariable(object, scope, adjust.variable, adjust.parameter, &extra);
-		}
-
-		if (!extra.available) {
-			/* Unsupported variable: skip further processing and return either
-			 * the group from the first range or the default group. */
-			return SpriteGroup::Resolve(this->error_group, object, false);
-		}
-
-		switch (this->size) {
-			case DSG_SIZE_BYTE:  value = EvalAdjustT<uint8_t,  int8_t> (adjust, scope, last_value, value, &iter); break;
-			case DSG_SIZE_WORD:  value = EvalAdjustT<uint16_t, int16_t>(adjust, scope, last_value, value, &iter); break;
-			case DSG_SIZE_DWORD: value = EvalAdjustT<uint32_t, int32_t>(adjust, scope, last_value, value, &iter); break;
-			default: NOT_REACHED();
+			switch (this->size) {
+				case DSG_SIZE_BYTE:  value = EvalAdjustT<uint8_t,  int8_t> (adjust, scope, last_value, value, &iter); break;
+				case DSG_SIZE_WORD:  value = EvalAdjustT<uint16_t, int16_t>(adjust, scope, last_value, value, &iter); break;
+				case DSG_SIZE_DWORD: value = EvalAdjustT<uint32_t, int32_t>(adjust, scope, last_value, value, &iter); break;
+				default: NOT_REACHED();
+			}
+			last_value = value;
 		}
-		last_value = value;
 	}
 
 	object.last_value = last_value;
@@ -211,6 +211,12 @@ enum DeterministicSpriteGroupAdjustOperation : uint8_t {
 	DSGA_OP_SPECIAL_END,
 };
 
+/** Call X(name) for all adjust operations, without the DSGA_OP_ prefix. */
+#define DSGA_OP_LIST(X) \
+	X(ADD) X(SUB) X(SMIN) X(SMAX) X(UMIN) X(UMAX) X(SDIV) X(SMOD) X(UDIV) X(UMOD) X(MUL) X(AND) X(OR) X(XOR) \
+	X(STO) X(RST) X(STOP) X(ROR) X(SCMP) X(UCMP) X(SHL) X(SHR) X(SAR) \
+	X(TERNARY) X(EQ) X(SLT) X(SGE) X(SLE) X(SGT) X(RSUB) X(STO_NC) X(ABS) X(JZ) X(JNZ) X(JZ_LV) X(JNZ_LV) X(NOOP)
+
 static_assert((DSGA_OP_SLT ^ 1) == DSGA_OP_SGE);
 static_assert((DSGA_OP_SLE ^ 1) == DSGA_OP_SGT);
 
@@ -483,6 +489,57 @@ enum DeterministicSpriteGroupFlags : uint8_t {
 };
 DECLARE_ENUM_AS_BIT_SET(DeterministicSpriteGroupFlags)
 
+/**
+ * Opcodes of the bytecode of deterministic sprite groups.
+ * Every adjust is lowered to a fetch of its operand and an operation on it, or to a single operation on a constant.
+ */
+enum DeterministicSpriteGroupOpcode : uint8_t {
+	DSGI_END,              ///< End of the group.
+	DSGI_SKIP_ON_ZERO,     ///< Continue at target if the last value is zero.
+	DSGI_SKIP_ON_LSB_SET,  ///< Continue at target if the lowest bit of the last value is set.
+
+	DSGI_FETCH_CALLBACK,   ///< Operand is the callback (var 0C).
+	DSGI_FETCH_PARAM1,     ///< Operand is the first callback parameter (var 10).
+	DSGI_FETCH_PARAM2,     ///< Operand is the second callback parameter (var 18).
+	DSGI_FETCH_LAST_VALUE, ///< Operand is the result of the last procedure or group (var 1C).
+	DSGI_FETCH_RANDOM,     ///< Operand is the random bits and triggers (var 5F).
+	DSGI_FETCH_TEMP,       ///< Operand is a temporary storage register (var 7D).
+	DSGI_FETCH_GRF_PARAM,  ///< Operand is a GRF parameter (var 7F).
+	DSGI_FETCH_GLOBAL,     ///< Operand is a global variable, or a scope variable below 40.
+	DSGI_FETCH_SCOPE,      ///< Operand is a variable of the scope.
+	DSGI_FETCH_INDIRECT,   ///< Operand is a variable whose parameter is the last value (var 7B).
+	DSGI_CALL,             ///< Operand is the result of a procedure call (var 7E).
+
+	DSGI_DIV,              ///< Operand is (operand + add_val) / divmod_val.
+	DSGI_MOD,              ///< Operand is (operand + add_val) % divmod_val.
+	DSGI_EQ,               ///< Operand is operand == add_val.
+	DSGI_NEQ,              ///< Operand is operand != add_val.
+
+#define DSGI_OP_OPCODES(name) DSGI_OP_##name, DSGI_IMM_##name,
+	DSGA_OP_LIST(DSGI_OP_OPCODES) ///< Operations on the fetched operand, and on a constant operand.
+#undef DSGI_OP_OPCODES
+
+	DSGI_OPCODE_END,
+};
+
+/**
+ * Instruction of the bytecode of a deterministic sprite group.
+ * The meaning of the operands depends on the opcode:
+ *  - fetches: a = variable parameter, or the adjust index for #DSGI_CALL, b = and mask, c = mask for #GetVariableExtra,
+ *  - operand types: a = add_val, b = divmod_val,
+ *  - operations: a = constant operand of DSGI_IMM_*, b = add_val, c = divmod_val or jump target,
+ *  - skips: c = target.
+ */
+struct DeterministicSpriteGroupInstruction {
+	DeterministicSpriteGroupOpcode opcode;
+	uint8_t shift_num;
+	uint16_t variable;
+	uint32_t a;
+	uint32_t b;
+	uint32_t c;
+};
+static_assert(sizeof(DeterministicSpriteGroupInstruction) == 16);
+
 struct DeterministicSpriteGroupShadowCopy {
 	std::vector<DeterministicSpriteGroupAdjust> adjusts;
 	std::vector<DeterministicSpriteGroupRange> ranges;
@@ -499,6 +556,7 @@ struct DeterministicSpriteGroup : SpriteGroup {
 	bool calculated_result;
 	DeterministicSpriteGroupFlags dsg_flags = DSGF_NONE;
 	std::vector<DeterministicSpriteGroupAdjust> adjusts;
+	std::vector<DeterministicSpriteGroupInstruction> bytecode; ///< Adjusts lowered to bytecode, if not empty this is used instead of adjusts
 	std::vector<DeterministicSpriteGroupRange> ranges; // Dynamically allocated
 
 	/* Dynamically allocated, this is the sole owner */
@@ -804,5 +862,6 @@ public:
 };
 
 uint32_t EvaluateDeterministicSpriteGroupAdjust(DeterministicSpriteGroupSize size, const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, uint32_t last_value, uint32_t value);
+uint32_t EvaluateDeterministicSpriteGroupAdjustOperand(DeterministicSpriteGroupSize size, const DeterministicSpriteGroupAdjust &adjust, uint32_t value);
 
 #endif /* NEWGRF_SPRITEGROUP_H */
@@ -1086,7 +1086,7 @@ int openttd_main(int argc, char *argv[])
 	/* ScanNewGRFFiles now has control over the scanner. */
 	RequestNewGRFScan(scanner.release());
 
-	_general_worker_pool.Start("ottd:worker", 8);
+	_general_worker_pool.Start("ottd:worker", UINT_MAX);
 
 	VideoDriver::GetInstance()->MainLoop();
 
@@ -2057,6 +2057,16 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log, CheckC
 		WaterRegionCheckCaches(log);
 	}
 
+	if (flags & CHECK_CACHE_ROAD_REGIONS) {
+		extern void RoadRegionCheckCaches(std::function<void(const char *)> log);
+		RoadRegionCheckCaches(log);
+	}
+
+	if (flags & CHECK_CACHE_RAIL_REGIONS) {
+		extern void RailRegionCheckCaches(std::function<void(const char *)> log);
+		RailRegionCheckCaches(log);
+	}
+
 	if ((flags & CHECK_CACHE_EMIT_LOG) && !saved_messages.empty()) {
 		InconsistencyExtraInfo info;
 		info.check_caches_result = std::move(saved_messages);
@@ -2119,6 +2129,7 @@ void StateGameLoop()
 
 	PerformanceMeasurer framerate(PFE_GAMELOOP);
 	PerformanceAccumulator::Reset(PFE_GL_LANDSCAPE);
+	ResetTileLoopPerformance();
 
 	Layouter::ReduceLineCache();
 
@@ -2249,7 +2260,7 @@ static void DoAutosave()
 	if (_settings_client.gui.max_num_autosaves > 0) {
 		lt_counter = &GetLongTermAutoSaveFiosNumberedSaveName();
 	}
-	DoAutoOrNetsave(GetAutoSaveFiosNumberedSaveName(), true, lt_counter);
+	DoAutoOrNetsave(GetAutoSaveFiosNumberedSaveName(), true, lt_counter, _settings_client.gui.autosave_delta_count > 0 ? SMF_DELTA : SMF_NONE);
 }
 
 /** Interval for regular autosaves. Initialized at zero to disable till settings are loaded. */
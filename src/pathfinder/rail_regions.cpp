@@ -0,0 +1,582 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file rail_regions.cpp Handles dividing the rail network in the map into square regions to assist pathfinding. */
+
+#include "stdafx.h"
+#include "rail_regions.h"
+#include "map_func.h"
+#include "rail_map.h"
+#include "road_map.h"
+#include "station_map.h"
+#include "tunnelbridge_map.h"
+#include "bridge_map.h"
+#include "track_func.h"
+#include "debug.h"
+#include "string_func.h"
+
+#include <array>
+#include <vector>
+
+#include "safeguards.h"
+
+using TRailRegionTraversabilityBits = uint16_t;
+constexpr TRailRegionPatchLabel FIRST_REGION_LABEL = 1;
+constexpr TRailRegionPatchLabel INVALID_RAIL_REGION_PATCH = 0;
+
+static_assert(sizeof(TRailRegionTraversabilityBits) * 8 == RAIL_REGION_EDGE_LENGTH);
+
+/** Set of tile sides, bit N is set for DiagDirection N. */
+using TRailRegionTileSides = uint8_t;
+
+static inline uint32_t GetRailRegionX(TileIndex tile) { return TileX(tile) / RAIL_REGION_EDGE_LENGTH; }
+static inline uint32_t GetRailRegionY(TileIndex tile) { return TileY(tile) / RAIL_REGION_EDGE_LENGTH; }
+
+static inline uint32_t GetRailRegionYShift() { return MapLogX() - RAIL_REGION_EDGE_LENGTH_LOG; }
+
+static inline TRailRegionIndex GetRailRegionIndex(uint32_t region_x, uint32_t region_y) { return (region_y << GetRailRegionYShift()) + region_x; }
+
+/**
+ * Get the sides of a tile touched by the given track bits.
+ * @param tracks The track bits.
+ * @return The sides of the tile which are touched by any of the tracks.
+ */
+static TRailRegionTileSides TrackBitsToRailRegionTileSides(TrackBits tracks)
+{
+	TRailRegionTileSides sides = 0;
+	for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+		/* Tracks which can be entered when moving into the tile through the given side. */
+		if ((tracks & DiagdirReachesTracks(ReverseDiagDir(dir))) != TRACK_BIT_NONE) SetBit(sides, dir);
+	}
+	return sides;
+}
+
+/**
+ * Get the sides of a tile through which trains can pass to the adjacent tile.
+ * This only depends on the layout of the track, not on signals, rail types, owners or the state of level crossings,
+ * such that the rail regions only need to be invalidated when the layout of the track changes.
+ * The far end of tunnels and bridges is not a side, see IsRailRegionTunnelBridge().
+ * @param tile The tile.
+ * @return The passable sides.
+ */
+static TRailRegionTileSides GetRailRegionTileSides(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case MP_RAILWAY:
+			if (IsRailDepot(tile)) return 1 << GetRailDepotDirection(tile);
+			return TrackBitsToRailRegionTileSides(GetTrackBits(tile));
+
+		case MP_ROAD:
+			if (!IsLevelCrossing(tile)) return 0;
+			return TrackBitsToRailRegionTileSides(GetCrossingRailBits(tile));
+
+		case MP_STATION:
+			if (!HasStationTileRail(tile)) return 0;
+			return TrackBitsToRailRegionTileSides(GetRailStationTrackBits(tile));
+
+		case MP_TUNNELBRIDGE: {
+			if (GetTunnelBridgeTransportType(tile) != TRANSPORT_RAIL) return 0;
+			const DiagDirection dir = GetTunnelBridgeDirection(tile);
+			if (IsTunnel(tile)) return 1 << ReverseDiagDir(dir);
+			TRailRegionTileSides sides = TrackBitsToRailRegionTileSides(GetCustomBridgeHeadTrackBits(tile));
+			ClrBit(sides, dir);
+			return sides;
+		}
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Check whether trains can pass through a tunnel or over a bridge from this tile.
+ * @param tile The tile.
+ * @return True if the tile is the entrance of a passable rail tunnel or bridge.
+ */
+static bool IsRailRegionTunnelBridge(TileIndex tile)
+{
+	if (!IsTileType(tile, MP_TUNNELBRIDGE) || GetTunnelBridgeTransportType(tile) != TRANSPORT_RAIL) return false;
+	if (IsTunnel(tile)) return true;
+	return GetAcrossTunnelBridgeTrackBits(tile) != TRACK_BIT_NONE && GetAcrossTunnelBridgeTrackBits(GetOtherTunnelBridgeEnd(tile)) != TRACK_BIT_NONE;
+}
+
+struct RailRegionTileIterator {
+	uint32_t x;
+	uint32_t y;
+
+	inline operator TileIndex () const
+	{
+		return TileXY(this->x, this->y);
+	}
+
+	inline TileIndex operator *() const
+	{
+		return TileXY(this->x, this->y);
+	}
+
+	RailRegionTileIterator& operator ++()
+	{
+		this->x++;
+		if ((this->x & RAIL_REGION_EDGE_MASK) == 0)  {
+			/* reached end of row */
+			this->x -= RAIL_REGION_EDGE_LENGTH;
+			this->y++;
+		}
+		return *this;
+	}
+};
+
+using TRailRegionPatchLabelArray = std::array<TRailRegionPatchLabel, RAIL_REGION_NUMBER_OF_TILES>;
+
+/**
+ * Represents a square section of the map of a fixed size. Within this square individual unconnected patches of track
+ * are identified using a Connected Component Labeling (CCL) algorithm, in the same way as for water regions.
+ * Each patch condenses the junctions, signal blocks and plain track within the region which are connected with each other
+ * into a single node of the rail region graph.
+ * Connections are symmetric: two adjacent tiles are connected if both have track touching their shared edge, and the two
+ * ends of a tunnel or bridge are connected with each other. All track on a tile is considered to be connected, and signals,
+ * rail types, owners and 90 degree turns are disregarded, which makes the region graph a safe over-approximation for pathfinding.
+ */
+class RailRegion
+{
+	friend class RailRegionReference;
+
+	std::array<TRailRegionTraversabilityBits, DIAGDIR_END> edge_traversability_bits{};
+	bool initialized = false;
+	bool has_cross_region_tunnelbridges = false;
+	TRailRegionPatchLabel number_of_patches = 0; // 0 = no track, 1 = one single patch of track, etc...
+	std::unique_ptr<TRailRegionPatchLabelArray> tile_patch_labels;
+};
+
+static std::unique_ptr<TRailRegionPatchLabelArray> _spare_rail_labels;
+
+class RailRegionReference {
+	const uint32_t tile_x;
+	const uint32_t tile_y;
+	RailRegion &rr;
+
+	inline bool ContainsTile(TileIndex tile) const
+	{
+		const uint32_t x = TileX(tile);
+		const uint32_t y = TileY(tile);
+		return x >= this->tile_x && x < this->tile_x + RAIL_REGION_EDGE_LENGTH
+				&& y >= this->tile_y && y < this->tile_y + RAIL_REGION_EDGE_LENGTH;
+	}
+
+	/**
+	 * Returns the local index of the tile within the region. The N corner represents 0,
+	 * the x direction is positive in the SW direction, and Y is positive in the SE direction.
+	 * @param tile Tile within the rail region.
+	 * @returns The local index.
+	 */
+	inline int GetLocalIndex(TileIndex tile) const
+	{
+		assert(this->ContainsTile(tile));
+		return (TileX(tile) - this->tile_x) + RAIL_REGION_EDGE_LENGTH * (TileY(tile) - this->tile_y);
+	}
+
+	inline bool HasNonMatchingPatchLabel(TRailRegionPatchLabel expected_label) const
+	{
+		for (TRailRegionPatchLabel label : *this->rr.tile_patch_labels) {
+			if (label != expected_label) return true;
+		}
+		return false;
+	}
+
+public:
+	RailRegionReference(uint32_t region_x, uint32_t region_y, RailRegion &rr)
+		: tile_x(region_x * RAIL_REGION_EDGE_LENGTH), tile_y(region_y * RAIL_REGION_EDGE_LENGTH), rr(rr)
+	{}
+
+	RailRegionTileIterator begin() const { return { this->tile_x, this->tile_y }; }
+	RailRegionTileIterator end() const { return { this->tile_x, this->tile_y + RAIL_REGION_EDGE_LENGTH }; }
+
+	bool IsInitialized() const { return this->rr.initialized; }
+
+	void Invalidate() { this->rr.initialized = false; }
+
+	/**
+	 * Returns a set of bits indicating whether an edge tile on a particular side has track leading out of the region.
+	 * @see GetLocalIndex() for a description of the coordinate system used.
+	 * @param side Which side of the region we want to know the edge traversability of.
+	 * @returns A value holding the edge traversability bits.
+	 */
+	TRailRegionTraversabilityBits GetEdgeTraversabilityBits(DiagDirection side) const { return this->rr.edge_traversability_bits[side]; }
+
+	/**
+	 * @returns The amount of individual track patches present within the rail region. A value of
+	 * 0 means there is no track present in the rail region at all.
+	 */
+	int NumberOfPatches() const { return this->rr.number_of_patches; }
+
+	/**
+	 * @returns Whether the rail region contains tunnels or bridges that cross the region boundaries.
+	 */
+	bool HasCrossRegionTunnelBridges() const { return this->rr.has_cross_region_tunnelbridges; }
+
+	/**
+	 * Returns the patch label that was assigned to the tile.
+	 * @param tile The tile of which we want to retrieve the label.
+	 * @returns The label assigned to the tile.
+	 */
+	TRailRegionPatchLabel GetLabel(TileIndex tile) const
+	{
+		assert(this->ContainsTile(tile));
+		if (this->rr.tile_patch_labels == nullptr) {
+			return this->NumberOfPatches() == 0 ? INVALID_RAIL_REGION_PATCH : FIRST_REGION_LABEL;
+		}
+		return (*this->rr.tile_patch_labels)[this->GetLocalIndex(tile)];
+	}
+
+	/**
+	 * Performs the connected component labeling and other data gathering.
+	 * @see RailRegion
+	 */
+	void ForceUpdate()
+	{
+		this->rr.has_cross_region_tunnelbridges = false;
+
+		if (this->rr.tile_patch_labels == nullptr) {
+			if (_spare_rail_labels != nullptr) {
+				this->rr.tile_patch_labels = std::move(_spare_rail_labels);
+			} else {
+				this->rr.tile_patch_labels = std::make_unique<TRailRegionPatchLabelArray>();
+			}
+		}
+
+		this->rr.tile_patch_labels->fill(INVALID_RAIL_REGION_PATCH);
+
+		TRailRegionPatchLabel current_label = FIRST_REGION_LABEL;
+		TRailRegionPatchLabel highest_assigned_label = 0;
+
+		/* Perform connected component labeling. This uses a flooding algorithm that expands until no
+		 * additional tiles can be added. Only tiles inside the rail region are considered. */
+		for (const TileIndex start_tile : *this) {
+			static std::vector<TileIndex> tiles_to_check;
+			tiles_to_check.clear();
+			tiles_to_check.push_back(start_tile);
+
+			bool increase_label = false;
+			while (!tiles_to_check.empty()) {
+				const TileIndex tile = tiles_to_check.back();
+				tiles_to_check.pop_back();
+
+				const TRailRegionTileSides sides = GetRailRegionTileSides(tile);
+				const bool is_tunnelbridge = IsRailRegionTunnelBridge(tile);
+				if (sides == 0 && !is_tunnelbridge) continue;
+
+				TRailRegionPatchLabel &tile_patch = (*this->rr.tile_patch_labels)[GetLocalIndex(tile)];
+				if (tile_patch != INVALID_RAIL_REGION_PATCH) continue;
+
+				tile_patch = current_label;
+				highest_assigned_label = current_label;
+				increase_label = true;
+
+				for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+					if (!HasBit(sides, dir)) continue;
+					const TileIndex neighbour = TileAddByDiagDir(tile, dir);
+					if (!this->ContainsTile(neighbour)) continue;
+					if (HasBit(GetRailRegionTileSides(neighbour), ReverseDiagDir(dir))) tiles_to_check.push_back(neighbour);
+				}
+
+				if (is_tunnelbridge) {
+					const TileIndex other_end = GetOtherTunnelBridgeEnd(tile);
+					if (this->ContainsTile(other_end)) {
+						tiles_to_check.push_back(other_end);
+					} else {
+						this->rr.has_cross_region_tunnelbridges = true;
+					}
+				}
+			}
+
+			if (increase_label) current_label++;
+		}
+
+		this->rr.number_of_patches = highest_assigned_label;
+		this->rr.initialized = true;
+
+		/* Calculate the traversability (whether the tile can be entered / exited) for all edges. Note that
+		 * we always follow the same X and Y scanning direction, this is important for comparisons later on! */
+		this->rr.edge_traversability_bits.fill(0);
+		const uint32_t top_x = this->tile_x;
+		const uint32_t top_y = this->tile_y;
+		for (uint32_t i = 0; i < RAIL_REGION_EDGE_LENGTH; ++i) {
+			if (HasBit(GetRailRegionTileSides(TileXY(top_x + i, top_y)), DIAGDIR_NW)) SetBit(this->rr.edge_traversability_bits[DIAGDIR_NW], i); // NW edge
+			if (HasBit(GetRailRegionTileSides(TileXY(top_x + i, top_y + RAIL_REGION_EDGE_LENGTH - 1)), DIAGDIR_SE)) SetBit(this->rr.edge_traversability_bits[DIAGDIR_SE], i); // SE edge
+			if (HasBit(GetRailRegionTileSides(TileXY(top_x, top_y + i)), DIAGDIR_NE)) SetBit(this->rr.edge_traversability_bits[DIAGDIR_NE], i); // NE edge
+			if (HasBit(GetRailRegionTileSides(TileXY(top_x + RAIL_REGION_EDGE_LENGTH - 1, top_y + i)), DIAGDIR_SW)) SetBit(this->rr.edge_traversability_bits[DIAGDIR_SW], i); // SW edge
+		}
+
+		if (this->rr.number_of_patches == 0 || (this->rr.number_of_patches == 1 && !this->HasNonMatchingPatchLabel(FIRST_REGION_LABEL))) {
+			/* No need for patch storage: trivial cases */
+			_spare_rail_labels = std::move(this->rr.tile_patch_labels);
+		}
+	}
+
+	/**
+	 * Updates the patch labels and other data, but only if the region is not yet initialized.
+	 */
+	inline void UpdateIfNotInitialized()
+	{
+		if (!this->rr.initialized) this->ForceUpdate();
+	}
+
+	inline bool HasPatchStorage() const
+	{
+		return this->rr.tile_patch_labels != nullptr;
+	}
+
+	TRailRegionPatchLabelArray CopyPatchLabelArray() const
+	{
+		TRailRegionPatchLabelArray out;
+		if (this->HasPatchStorage()) {
+			out = *this->rr.tile_patch_labels;
+		} else {
+			out.fill(this->NumberOfPatches() == 0 ? INVALID_RAIL_REGION_PATCH : FIRST_REGION_LABEL);
+		}
+		return out;
+	}
+};
+
+static std::unique_ptr<RailRegion[]> _rail_regions;
+
+static TileIndex GetTileIndexFromLocalCoordinate(uint32_t region_x, uint32_t region_y, uint32_t local_x, uint32_t local_y)
+{
+	assert(local_x < RAIL_REGION_EDGE_LENGTH);
+	assert(local_y < RAIL_REGION_EDGE_LENGTH);
+	return TileXY(RAIL_REGION_EDGE_LENGTH * region_x + local_x, RAIL_REGION_EDGE_LENGTH * region_y + local_y);
+}
+
+static TileIndex GetEdgeTileCoordinate(uint32_t region_x, uint32_t region_y, DiagDirection side, uint32_t x_or_y)
+{
+	assert(x_or_y < RAIL_REGION_EDGE_LENGTH);
+	switch (side) {
+		case DIAGDIR_NE: return GetTileIndexFromLocalCoordinate(region_x, region_y, 0, x_or_y);
+		case DIAGDIR_SW: return GetTileIndexFromLocalCoordinate(region_x, region_y, RAIL_REGION_EDGE_LENGTH - 1, x_or_y);
+		case DIAGDIR_NW: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, 0);
+		case DIAGDIR_SE: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, RAIL_REGION_EDGE_LENGTH - 1);
+		default: NOT_REACHED();
+	}
+}
+
+static inline RailRegionReference GetRailRegionRef(uint32_t region_x, uint32_t region_y)
+{
+	return RailRegionReference(region_x, region_y, _rail_regions[GetRailRegionIndex(region_x, region_y)]);
+}
+
+static RailRegionReference GetUpdatedRailRegion(uint32_t region_x, uint32_t region_y)
+{
+	RailRegionReference ref = GetRailRegionRef(region_x, region_y);
+	ref.UpdateIfNotInitialized();
+	return ref;
+}
+
+uint32_t GetRailRegionMapSizeX() { return MapSizeX() / RAIL_REGION_EDGE_LENGTH; }
+uint32_t GetRailRegionMapSizeY() { return MapSizeY() / RAIL_REGION_EDGE_LENGTH; }
+
+/**
+ * Returns the index of the rail region
+ * @param rail_region The rail region to return the index for
+ */
+TRailRegionIndex GetRailRegionIndex(const RailRegionDesc &rail_region)
+{
+	return GetRailRegionIndex(rail_region.x, rail_region.y);
+}
+
+/**
+ * Returns the index of the rail region that a tile is part of.
+ * @param tile The tile.
+ */
+TRailRegionIndex GetRailRegionIndex(TileIndex tile)
+{
+	return GetRailRegionIndex(GetRailRegionX(tile), GetRailRegionY(tile));
+}
+
+/**
+ * Returns basic rail region information for the provided tile.
+ * @param tile The tile for which the information will be calculated.
+ */
+RailRegionDesc GetRailRegionInfo(TileIndex tile)
+{
+	return RailRegionDesc{ GetRailRegionX(tile), GetRailRegionY(tile) };
+}
+
+/**
+ * Returns basic rail region patch information for the provided tile.
+ * @param tile The tile for which the information will be calculated.
+ */
+RailRegionPatchDesc GetRailRegionPatchInfo(TileIndex tile)
+{
+	RailRegionReference region = GetUpdatedRailRegion(GetRailRegionX(tile), GetRailRegionY(tile));
+	return RailRegionPatchDesc{ GetRailRegionX(tile), GetRailRegionY(tile), region.GetLabel(tile) };
+}
+
+/**
+ * Marks the rail region that tile is part of as invalid.
+ * This is called via YapfNotifyTrackLayoutChange() whenever the track layout of the tile changes.
+ * @param tile Tile within the rail region that we wish to invalidate.
+ */
+void InvalidateRailRegion(TileIndex tile)
+{
+	if (_rail_regions == nullptr || tile >= MapSize()) return;
+
+	GetRailRegionRef(GetRailRegionX(tile), GetRailRegionY(tile)).Invalidate();
+}
+
+/**
+ * Marks all rail regions as invalid.
+ */
+void InvalidateAllRailRegions()
+{
+	if (_rail_regions == nullptr) return;
+
+	const uint32_t size_x = GetRailRegionMapSizeX();
+	const uint32_t size_y = GetRailRegionMapSizeY();
+	for (uint32_t y = 0; y < size_y; y++) {
+		for (uint32_t x = 0; x < size_x; x++) {
+			GetRailRegionRef(x, y).Invalidate();
+		}
+	}
+}
+
+/**
+ * Calls the provided callback function for all rail region patches
+ * accessible from one particular side of the starting patch.
+ * @param rail_region_patch Track patch within the rail region to start searching from
+ * @param side Side of the rail region to look for neighbouring patches of track
+ * @param func The function that will be called for each neighbour that is found
+ */
+static inline void VisitAdjacentRailRegionPatchNeighbors(const RailRegionPatchDesc &rail_region_patch, DiagDirection side, TVisitRailRegionPatchCallBack &func)
+{
+	const RailRegionReference current_region = GetUpdatedRailRegion(rail_region_patch.x, rail_region_patch.y);
+
+	const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+	/* Unsigned underflow is allowed here, not UB */
+	const uint32_t nx = rail_region_patch.x + (uint32_t)offset.x;
+	const uint32_t ny = rail_region_patch.y + (uint32_t)offset.y;
+
+	if (nx >= GetRailRegionMapSizeX() || ny >= GetRailRegionMapSizeY()) return;
+
+	const RailRegionReference neighbouring_region = GetUpdatedRailRegion(nx, ny);
+	const DiagDirection opposite_side = ReverseDiagDir(side);
+
+	/* Indicates via which local x or y coordinates (depends on the "side" parameter) we can cross over into the adjacent region. */
+	const TRailRegionTraversabilityBits traversability_bits = current_region.GetEdgeTraversabilityBits(side)
+		& neighbouring_region.GetEdgeTraversabilityBits(opposite_side);
+	if (traversability_bits == 0) return;
+
+	if (current_region.NumberOfPatches() == 1 && neighbouring_region.NumberOfPatches() == 1) {
+		func(RailRegionPatchDesc{ nx, ny, FIRST_REGION_LABEL }); // No further checks needed because we know there is just one patch for both adjacent regions
+		return;
+	}
+
+	/* Multiple track patches can be reached from the current patch. Check each edge tile individually. */
+	static std::vector<TRailRegionPatchLabel> unique_labels; // static and vector-instead-of-map for performance reasons
+	unique_labels.clear();
+	for (uint32_t x_or_y = 0; x_or_y < RAIL_REGION_EDGE_LENGTH; ++x_or_y) {
+		if (!HasBit(traversability_bits, x_or_y)) continue;
+
+		const TileIndex current_edge_tile = GetEdgeTileCoordinate(rail_region_patch.x, rail_region_patch.y, side, x_or_y);
+		const TRailRegionPatchLabel current_label = current_region.GetLabel(current_edge_tile);
+		if (current_label != rail_region_patch.label) continue;
+
+		const TileIndex neighbour_edge_tile = GetEdgeTileCoordinate(nx, ny, opposite_side, x_or_y);
+		const TRailRegionPatchLabel neighbour_label = neighbouring_region.GetLabel(neighbour_edge_tile);
+		if (std::find(unique_labels.begin(), unique_labels.end(), neighbour_label) == unique_labels.end()) unique_labels.push_back(neighbour_label);
+	}
+	for (TRailRegionPatchLabel unique_label : unique_labels) func(RailRegionPatchDesc{ nx, ny, unique_label });
+}
+
+/**
+ * Calls the provided callback function on all accessible rail region patches in
+ * each cardinal direction, plus any others that are reachable via tunnels and bridges.
+ * @param rail_region_patch Track patch within the rail region to start searching from
+ * @param callback The function that will be called for each accessible track patch that is found
+ */
+void VisitRailRegionPatchNeighbors(const RailRegionPatchDesc &rail_region_patch, TVisitRailRegionPatchCallBack &callback)
+{
+	const RailRegionReference current_region = GetUpdatedRailRegion(rail_region_patch.x, rail_region_patch.y);
+
+	/* Visit adjacent rail region patches in each cardinal direction */
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) VisitAdjacentRailRegionPatchNeighbors(rail_region_patch, side, callback);
+
+	/* Visit neighbouring track patches accessible via cross-region tunnels and bridges */
+	if (current_region.HasCrossRegionTunnelBridges()) {
+		for (const TileIndex tile : current_region) {
+			if (current_region.GetLabel(tile) != rail_region_patch.label || !IsRailRegionTunnelBridge(tile)) continue;
+
+			const TileIndex other_end_tile = GetOtherTunnelBridgeEnd(tile);
+			if (GetRailRegionIndex(tile) != GetRailRegionIndex(other_end_tile)) callback(GetRailRegionPatchInfo(other_end_tile));
+		}
+	}
+}
+
+/**
+ * Initializes all rail regions. Regions are updated lazily when they are first used by the pathfinder.
+ */
+void InitializeRailRegions()
+{
+	_rail_regions.reset(new RailRegion[GetRailRegionMapSizeX() * GetRailRegionMapSizeY()]);
+}
+
+void DebugInitAllRailRegions()
+{
+	const uint32_t size_x = GetRailRegionMapSizeX();
+	const uint32_t size_y = GetRailRegionMapSizeY();
+	for (uint32_t y = 0; y < size_y; y++) {
+		for (uint32_t x = 0; x < size_x; x++) {
+			GetRailRegionRef(x, y).UpdateIfNotInitialized();
+		}
+	}
+}
+
+void RailRegionCheckCaches(std::function<void(const char *)> log)
+{
+	char cclog_buffer[1024];
+#define CCLOG(...) { \
+	char *cc_log_pos = cclog_buffer + seprintf(cclog_buffer, lastof(cclog_buffer), "Rail region: %u x %u to %u x %u: ", \
+			x * RAIL_REGION_EDGE_LENGTH, y * RAIL_REGION_EDGE_LENGTH, (x * RAIL_REGION_EDGE_LENGTH) + RAIL_REGION_EDGE_MASK, (y * RAIL_REGION_EDGE_LENGTH) + RAIL_REGION_EDGE_MASK); \
+	seprintf(cc_log_pos, lastof(cclog_buffer), __VA_ARGS__); \
+	DEBUG(desync, 0, "%s", cclog_buffer); \
+	if (log) log(cclog_buffer); \
+}
+
+	const uint32_t size_x = GetRailRegionMapSizeX();
+	const uint32_t size_y = GetRailRegionMapSizeY();
+	for (uint32_t y = 0; y < size_y; y++) {
+		for (uint32_t x = 0; x < size_x; x++) {
+			RailRegionReference rr = GetRailRegionRef(x, y);
+			if (!rr.IsInitialized()) continue;
+
+			const bool old_has_cross_region_tunnelbridges = rr.HasCrossRegionTunnelBridges();
+			const int old_number_of_patches = rr.NumberOfPatches();
+			const TRailRegionPatchLabelArray old_patch_labels = rr.CopyPatchLabelArray();
+			const TRailRegionTraversabilityBits old_edges[DIAGDIR_END] = {
+				rr.GetEdgeTraversabilityBits(DIAGDIR_NE), rr.GetEdgeTraversabilityBits(DIAGDIR_SE),
+				rr.GetEdgeTraversabilityBits(DIAGDIR_SW), rr.GetEdgeTraversabilityBits(DIAGDIR_NW)
+			};
+
+			rr.ForceUpdate();
+
+			if (old_has_cross_region_tunnelbridges != rr.HasCrossRegionTunnelBridges()) {
+				CCLOG("Has cross region tunnels/bridges mismatch: %u -> %u", old_has_cross_region_tunnelbridges, rr.HasCrossRegionTunnelBridges());
+			}
+			if (old_number_of_patches != rr.NumberOfPatches()) {
+				CCLOG("Number of patches mismatch: %u -> %u", old_number_of_patches, rr.NumberOfPatches());
+			}
+			if (old_patch_labels != rr.CopyPatchLabelArray()) {
+				CCLOG("Patch label mismatch");
+			}
+			for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+				if (old_edges[side] != rr.GetEdgeTraversabilityBits(side)) {
+					CCLOG("Edge traversability mismatch: side %u: %X -> %X", side, old_edges[side], rr.GetEdgeTraversabilityBits(side));
+				}
+			}
+		}
+	}
+#undef CCLOG
+}
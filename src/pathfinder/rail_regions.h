@@ -0,0 +1,82 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file rail_regions.h Handles dividing the rail network in the map into regions to assist pathfinding. */
+
+#ifndef RAIL_REGIONS_H
+#define RAIL_REGIONS_H
+
+#include "tile_type.h"
+#include "map_func.h"
+
+#include <functional>
+
+using TRailRegionPatchLabel = uint16_t;
+using TRailRegionIndex = uint32_t;
+
+constexpr uint32_t RAIL_REGION_EDGE_LENGTH = 16;
+constexpr uint32_t RAIL_REGION_EDGE_LENGTH_LOG = 4;
+static_assert(1 << RAIL_REGION_EDGE_LENGTH_LOG == RAIL_REGION_EDGE_LENGTH);
+
+constexpr uint32_t RAIL_REGION_EDGE_MASK = RAIL_REGION_EDGE_LENGTH - 1;
+static_assert((RAIL_REGION_EDGE_LENGTH & RAIL_REGION_EDGE_MASK) == 0);
+
+constexpr uint32_t RAIL_REGION_NUMBER_OF_TILES = RAIL_REGION_EDGE_LENGTH * RAIL_REGION_EDGE_LENGTH;
+
+/**
+ * Describes a single interconnected patch of rail track within a particular rail region.
+ */
+struct RailRegionPatchDesc
+{
+	uint32_t x; ///< The X coordinate of the rail region, i.e. X=2 is the 3rd rail region along the X-axis
+	uint32_t y; ///< The Y coordinate of the rail region, i.e. Y=2 is the 3rd rail region along the Y-axis
+	TRailRegionPatchLabel label; ///< Unique label identifying the patch within the region
+
+	bool operator==(const RailRegionPatchDesc &other) const { return x == other.x && y == other.y && label == other.label; }
+	bool operator!=(const RailRegionPatchDesc &other) const { return !(*this == other); }
+};
+
+/**
+ * Describes a single square rail region.
+ */
+struct RailRegionDesc
+{
+	uint32_t x; ///< The X coordinate of the rail region, i.e. X=2 is the 3rd rail region along the X-axis
+	uint32_t y; ///< The Y coordinate of the rail region, i.e. Y=2 is the 3rd rail region along the Y-axis
+
+	RailRegionDesc(const uint32_t x, const uint32_t y) : x(x), y(y) {}
+	RailRegionDesc(const RailRegionPatchDesc &rail_region_patch) : x(rail_region_patch.x), y(rail_region_patch.y) {}
+
+	bool operator==(const RailRegionDesc &other) const { return x == other.x && y == other.y; }
+	bool operator!=(const RailRegionDesc &other) const { return !(*this == other); }
+};
+
+TRailRegionIndex GetRailRegionIndex(const RailRegionDesc &rail_region);
+TRailRegionIndex GetRailRegionIndex(TileIndex tile);
+uint32_t GetRailRegionMapSizeX();
+uint32_t GetRailRegionMapSizeY();
+
+RailRegionDesc GetRailRegionInfo(TileIndex tile);
+RailRegionPatchDesc GetRailRegionPatchInfo(TileIndex tile);
+
+/**
+ * Check whether a rail region patch describes rail track, as opposed to the absence of it.
+ * @param rail_region_patch The patch to check.
+ * @return True if the patch contains rail track.
+ */
+inline bool IsValidRailRegionPatch(const RailRegionPatchDesc &rail_region_patch) { return rail_region_patch.label != 0; }
+
+void InvalidateRailRegion(TileIndex tile);
+void InvalidateAllRailRegions();
+void DebugInitAllRailRegions();
+
+using TVisitRailRegionPatchCallBack = std::function<void(const RailRegionPatchDesc &)>;
+void VisitRailRegionPatchNeighbors(const RailRegionPatchDesc &rail_region_patch, TVisitRailRegionPatchCallBack &callback);
+
+void InitializeRailRegions();
+
+#endif /* RAIL_REGIONS_H */
@@ -0,0 +1,588 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file road_regions.cpp Handles dividing the road network in the map into square regions to assist pathfinding. */
+
+#include "stdafx.h"
+#include "road_regions.h"
+#include "map_func.h"
+#include "road_map.h"
+#include "road_func.h"
+#include "station_map.h"
+#include "tunnelbridge_map.h"
+#include "bridge_map.h"
+#include "debug.h"
+#include "string_func.h"
+
+#include <array>
+#include <vector>
+
+#include "safeguards.h"
+
+using TRoadRegionTraversabilityBits = uint16_t;
+constexpr TRoadRegionPatchLabel FIRST_REGION_LABEL = 1;
+constexpr TRoadRegionPatchLabel INVALID_ROAD_REGION_PATCH = 0;
+
+static_assert(sizeof(TRoadRegionTraversabilityBits) * 8 == ROAD_REGION_EDGE_LENGTH);
+
+static inline uint32_t GetRoadRegionX(TileIndex tile) { return TileX(tile) / ROAD_REGION_EDGE_LENGTH; }
+static inline uint32_t GetRoadRegionY(TileIndex tile) { return TileY(tile) / ROAD_REGION_EDGE_LENGTH; }
+
+static inline uint32_t GetRoadRegionYShift() { return MapLogX() - ROAD_REGION_EDGE_LENGTH_LOG; }
+
+static inline TRoadRegionIndex GetRoadRegionIndex(uint32_t region_x, uint32_t region_y) { return (region_y << GetRoadRegionYShift()) + region_x; }
+
+/**
+ * Get the sides of a tile through which road vehicles of the given road/tram type can pass to the adjacent tile.
+ * This only depends on the layout of the road, not on one-way roads, road works or level crossing states,
+ * such that the road regions only need to be invalidated when the layout of the road changes.
+ * The far end of tunnels and bridges is not a side, see IsRoadRegionTunnelBridge().
+ * @param tile The tile.
+ * @param rtt Road/tram type.
+ * @return The passable sides as road bits.
+ */
+static RoadBits GetRoadRegionTileSides(TileIndex tile, RoadTramType rtt)
+{
+	if (!MayHaveRoad(tile)) return ROAD_NONE;
+
+	switch (GetTileType(tile)) {
+		case MP_ROAD:
+			if (!HasTileRoadType(tile, rtt)) return ROAD_NONE;
+			switch (GetRoadTileType(tile)) {
+				case ROAD_TILE_NORMAL:   return GetRoadBits(tile, rtt);
+				case ROAD_TILE_CROSSING: return AxisToRoadBits(GetCrossingRoadAxis(tile));
+				case ROAD_TILE_DEPOT:    return DiagDirToRoadBits(GetRoadDepotDirection(tile));
+				default: NOT_REACHED();
+			}
+
+		case MP_STATION:
+			if (!IsAnyRoadStop(tile) || !HasTileRoadType(tile, rtt)) return ROAD_NONE;
+			if (IsDriveThroughStopTile(tile)) return AxisToRoadBits(DiagDirToAxis(GetRoadStopDir(tile)));
+			return DiagDirToRoadBits(GetRoadStopDir(tile));
+
+		case MP_TUNNELBRIDGE: {
+			if (!HasTileRoadType(tile, rtt)) return ROAD_NONE;
+			const DiagDirection dir = GetTunnelBridgeDirection(tile);
+			if (IsTunnel(tile)) return DiagDirToRoadBits(ReverseDiagDir(dir));
+			return GetCustomBridgeHeadRoadBits(tile, rtt) & ~DiagDirToRoadBits(dir);
+		}
+
+		default:
+			return ROAD_NONE;
+	}
+}
+
+/**
+ * Check whether road vehicles of the given road/tram type can pass through a tunnel or over a bridge from this tile.
+ * @param tile The tile.
+ * @param rtt Road/tram type.
+ * @return True if the tile is the entrance of a passable road tunnel or bridge.
+ */
+static bool IsRoadRegionTunnelBridge(TileIndex tile, RoadTramType rtt)
+{
+	if (!IsTileType(tile, MP_TUNNELBRIDGE) || GetTunnelBridgeTransportType(tile) != TRANSPORT_ROAD || !HasTileRoadType(tile, rtt)) return false;
+	if (IsTunnel(tile)) return true;
+	const RoadBits entrance = DiagDirToRoadBits(GetTunnelBridgeDirection(tile));
+	return (GetCustomBridgeHeadRoadBits(tile, rtt) & entrance) != ROAD_NONE &&
+			(GetCustomBridgeHeadRoadBits(GetOtherTunnelBridgeEnd(tile), rtt) & MirrorRoadBits(entrance)) != ROAD_NONE;
+}
+
+struct RoadRegionTileIterator {
+	uint32_t x;
+	uint32_t y;
+
+	inline operator TileIndex () const
+	{
+		return TileXY(this->x, this->y);
+	}
+
+	inline TileIndex operator *() const
+	{
+		return TileXY(this->x, this->y);
+	}
+
+	RoadRegionTileIterator& operator ++()
+	{
+		this->x++;
+		if ((this->x & ROAD_REGION_EDGE_MASK) == 0)  {
+			/* reached end of row */
+			this->x -= ROAD_REGION_EDGE_LENGTH;
+			this->y++;
+		}
+		return *this;
+	}
+};
+
+using TRoadRegionPatchLabelArray = std::array<TRoadRegionPatchLabel, ROAD_REGION_NUMBER_OF_TILES>;
+
+/**
+ * Represents a square section of the map of a fixed size, for one road/tram type. Within this square individual unconnected
+ * patches of road are identified using a Connected Component Labeling (CCL) algorithm, in the same way as for water regions.
+ * Connections are symmetric: two adjacent tiles are connected if both have road on their shared edge, and the two ends of a
+ * tunnel or bridge are connected with each other. Patches therefore describe which tiles can reach each other by road,
+ * disregarding road types, owners and one-way roads, which makes the region graph a safe over-approximation for pathfinding.
+ */
+class RoadRegion
+{
+	friend class RoadRegionReference;
+
+	std::array<TRoadRegionTraversabilityBits, DIAGDIR_END> edge_traversability_bits{};
+	bool initialized = false;
+	bool has_cross_region_tunnelbridges = false;
+	TRoadRegionPatchLabel number_of_patches = 0; // 0 = no road, 1 = one single patch of road, etc...
+	std::unique_ptr<TRoadRegionPatchLabelArray> tile_patch_labels;
+};
+
+static std::unique_ptr<TRoadRegionPatchLabelArray> _spare_road_labels;
+
+class RoadRegionReference {
+	const uint32_t tile_x;
+	const uint32_t tile_y;
+	const RoadTramType rtt;
+	RoadRegion &rr;
+
+	inline bool ContainsTile(TileIndex tile) const
+	{
+		const uint32_t x = TileX(tile);
+		const uint32_t y = TileY(tile);
+		return x >= this->tile_x && x < this->tile_x + ROAD_REGION_EDGE_LENGTH
+				&& y >= this->tile_y && y < this->tile_y + ROAD_REGION_EDGE_LENGTH;
+	}
+
+	/**
+	 * Returns the local index of the tile within the region. The N corner represents 0,
+	 * the x direction is positive in the SW direction, and Y is positive in the SE direction.
+	 * @param tile Tile within the road region.
+	 * @returns The local index.
+	 */
+	inline int GetLocalIndex(TileIndex tile) const
+	{
+		assert(this->ContainsTile(tile));
+		return (TileX(tile) - this->tile_x) + ROAD_REGION_EDGE_LENGTH * (TileY(tile) - this->tile_y);
+	}
+
+	inline bool HasNonMatchingPatchLabel(TRoadRegionPatchLabel expected_label) const
+	{
+		for (TRoadRegionPatchLabel label : *this->rr.tile_patch_labels) {
+			if (label != expected_label) return true;
+		}
+		return false;
+	}
+
+public:
+	RoadRegionReference(uint32_t region_x, uint32_t region_y, RoadTramType rtt, RoadRegion &rr)
+		: tile_x(region_x * ROAD_REGION_EDGE_LENGTH), tile_y(region_y * ROAD_REGION_EDGE_LENGTH), rtt(rtt), rr(rr)
+	{}
+
+	RoadRegionTileIterator begin() const { return { this->tile_x, this->tile_y }; }
+	RoadRegionTileIterator end() const { return { this->tile_x, this->tile_y + ROAD_REGION_EDGE_LENGTH }; }
+
+	bool IsInitialized() const { return this->rr.initialized; }
+
+	void Invalidate() { this->rr.initialized = false; }
+
+	/**
+	 * Returns a set of bits indicating whether an edge tile on a particular side has road leading out of the region.
+	 * @see GetLocalIndex() for a description of the coordinate system used.
+	 * @param side Which side of the region we want to know the edge traversability of.
+	 * @returns A value holding the edge traversability bits.
+	 */
+	TRoadRegionTraversabilityBits GetEdgeTraversabilityBits(DiagDirection side) const { return this->rr.edge_traversability_bits[side]; }
+
+	/**
+	 * @returns The amount of individual road patches present within the road region. A value of
+	 * 0 means there is no road of this road/tram type present in the road region at all.
+	 */
+	int NumberOfPatches() const { return this->rr.number_of_patches; }
+
+	/**
+	 * @returns Whether the road region contains tunnels or bridges that cross the region boundaries.
+	 */
+	bool HasCrossRegionTunnelBridges() const { return this->rr.has_cross_region_tunnelbridges; }
+
+	/**
+	 * Returns the patch label that was assigned to the tile.
+	 * @param tile The tile of which we want to retrieve the label.
+	 * @returns The label assigned to the tile.
+	 */
+	TRoadRegionPatchLabel GetLabel(TileIndex tile) const
+	{
+		assert(this->ContainsTile(tile));
+		if (this->rr.tile_patch_labels == nullptr) {
+			return this->NumberOfPatches() == 0 ? INVALID_ROAD_REGION_PATCH : FIRST_REGION_LABEL;
+		}
+		return (*this->rr.tile_patch_labels)[this->GetLocalIndex(tile)];
+	}
+
+	/**
+	 * Performs the connected component labeling and other data gathering.
+	 * @see RoadRegion
+	 */
+	void ForceUpdate()
+	{
+		this->rr.has_cross_region_tunnelbridges = false;
+
+		if (this->rr.tile_patch_labels == nullptr) {
+			if (_spare_road_labels != nullptr) {
+				this->rr.tile_patch_labels = std::move(_spare_road_labels);
+			} else {
+				this->rr.tile_patch_labels = std::make_unique<TRoadRegionPatchLabelArray>();
+			}
+		}
+
+		this->rr.tile_patch_labels->fill(INVALID_ROAD_REGION_PATCH);
+
+		TRoadRegionPatchLabel current_label = FIRST_REGION_LABEL;
+		TRoadRegionPatchLabel highest_assigned_label = 0;
+
+		/* Perform connected component labeling. This uses a flooding algorithm that expands until no
+		 * additional tiles can be added. Only tiles inside the road region are considered. */
+		for (const TileIndex start_tile : *this) {
+			static std::vector<TileIndex> tiles_to_check;
+			tiles_to_check.clear();
+			tiles_to_check.push_back(start_tile);
+
+			bool increase_label = false;
+			while (!tiles_to_check.empty()) {
+				const TileIndex tile = tiles_to_check.back();
+				tiles_to_check.pop_back();
+
+				const RoadBits sides = GetRoadRegionTileSides(tile, this->rtt);
+				const bool is_tunnelbridge = IsRoadRegionTunnelBridge(tile, this->rtt);
+				if (sides == ROAD_NONE && !is_tunnelbridge) continue;
+
+				TRoadRegionPatchLabel &tile_patch = (*this->rr.tile_patch_labels)[GetLocalIndex(tile)];
+				if (tile_patch != INVALID_ROAD_REGION_PATCH) continue;
+
+				tile_patch = current_label;
+				highest_assigned_label = current_label;
+				increase_label = true;
+
+				for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+					if ((sides & DiagDirToRoadBits(dir)) == ROAD_NONE) continue;
+					const TileIndex neighbour = TileAddByDiagDir(tile, dir);
+					if (!this->ContainsTile(neighbour)) continue;
+					if ((GetRoadRegionTileSides(neighbour, this->rtt) & DiagDirToRoadBits(ReverseDiagDir(dir))) != ROAD_NONE) tiles_to_check.push_back(neighbour);
+				}
+
+				if (is_tunnelbridge) {
+					const TileIndex other_end = GetOtherTunnelBridgeEnd(tile);
+					if (this->ContainsTile(other_end)) {
+						tiles_to_check.push_back(other_end);
+					} else {
+						this->rr.has_cross_region_tunnelbridges = true;
+					}
+				}
+			}
+
+			if (increase_label) current_label++;
+		}
+
+		this->rr.number_of_patches = highest_assigned_label;
+		this->rr.initialized = true;
+
+		/* Calculate the traversability (whether the tile can be entered / exited) for all edges. Note that
+		 * we always follow the same X and Y scanning direction, this is important for comparisons later on! */
+		this->rr.edge_traversability_bits.fill(0);
+		const uint32_t top_x = this->tile_x;
+		const uint32_t top_y = this->tile_y;
+		for (uint32_t i = 0; i < ROAD_REGION_EDGE_LENGTH; ++i) {
+			if (GetRoadRegionTileSides(TileXY(top_x + i, top_y), this->rtt) & ROAD_NW) SetBit(this->rr.edge_traversability_bits[DIAGDIR_NW], i); // NW edge
+			if (GetRoadRegionTileSides(TileXY(top_x + i, top_y + ROAD_REGION_EDGE_LENGTH - 1), this->rtt) & ROAD_SE) SetBit(this->rr.edge_traversability_bits[DIAGDIR_SE], i); // SE edge
+			if (GetRoadRegionTileSides(TileXY(top_x, top_y + i), this->rtt) & ROAD_NE) SetBit(this->rr.edge_traversability_bits[DIAGDIR_NE], i); // NE edge
+			if (GetRoadRegionTileSides(TileXY(top_x + ROAD_REGION_EDGE_LENGTH - 1, top_y + i), this->rtt) & ROAD_SW) SetBit(this->rr.edge_traversability_bits[DIAGDIR_SW], i); // SW edge
+		}
+
+		if (this->rr.number_of_patches == 0 || (this->rr.number_of_patches == 1 && !this->HasNonMatchingPatchLabel(FIRST_REGION_LABEL))) {
+			/* No need for patch storage: trivial cases */
+			_spare_road_labels = std::move(this->rr.tile_patch_labels);
+		}
+	}
+
+	/**
+	 * Updates the patch labels and other data, but only if the region is not yet initialized.
+	 */
+	inline void UpdateIfNotInitialized()
+	{
+		if (!this->rr.initialized) this->ForceUpdate();
+	}
+
+	inline bool HasPatchStorage() const
+	{
+		return this->rr.tile_patch_labels != nullptr;
+	}
+
+	TRoadRegionPatchLabelArray CopyPatchLabelArray() const
+	{
+		TRoadRegionPatchLabelArray out;
+		if (this->HasPatchStorage()) {
+			out = *this->rr.tile_patch_labels;
+		} else {
+			out.fill(this->NumberOfPatches() == 0 ? INVALID_ROAD_REGION_PATCH : FIRST_REGION_LABEL);
+		}
+		return out;
+	}
+};
+
+/** Road regions, one set for road and one set for tram track. */
+static std::unique_ptr<RoadRegion[]> _road_regions[lengthof(_roadtramtypes)];
+
+static TileIndex GetTileIndexFromLocalCoordinate(uint32_t region_x, uint32_t region_y, uint32_t local_x, uint32_t local_y)
+{
+	assert(local_x < ROAD_REGION_EDGE_LENGTH);
+	assert(local_y < ROAD_REGION_EDGE_LENGTH);
+	return TileXY(ROAD_REGION_EDGE_LENGTH * region_x + local_x, ROAD_REGION_EDGE_LENGTH * region_y + local_y);
+}
+
+static TileIndex GetEdgeTileCoordinate(uint32_t region_x, uint32_t region_y, DiagDirection side, uint32_t x_or_y)
+{
+	assert(x_or_y < ROAD_REGION_EDGE_LENGTH);
+	switch (side) {
+		case DIAGDIR_NE: return GetTileIndexFromLocalCoordinate(region_x, region_y, 0, x_or_y);
+		case DIAGDIR_SW: return GetTileIndexFromLocalCoordinate(region_x, region_y, ROAD_REGION_EDGE_LENGTH - 1, x_or_y);
+		case DIAGDIR_NW: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, 0);
+		case DIAGDIR_SE: return GetTileIndexFromLocalCoordinate(region_x, region_y, x_or_y, ROAD_REGION_EDGE_LENGTH - 1);
+		default: NOT_REACHED();
+	}
+}
+
+static inline RoadRegionReference GetRoadRegionRef(uint32_t region_x, uint32_t region_y, RoadTramType rtt)
+{
+	return RoadRegionReference(region_x, region_y, rtt, _road_regions[rtt][GetRoadRegionIndex(region_x, region_y)]);
+}
+
+static RoadRegionReference GetUpdatedRoadRegion(uint32_t region_x, uint32_t region_y, RoadTramType rtt)
+{
+	RoadRegionReference ref = GetRoadRegionRef(region_x, region_y, rtt);
+	ref.UpdateIfNotInitialized();
+	return ref;
+}
+
+uint32_t GetRoadRegionMapSizeX() { return MapSizeX() / ROAD_REGION_EDGE_LENGTH; }
+uint32_t GetRoadRegionMapSizeY() { return MapSizeY() / ROAD_REGION_EDGE_LENGTH; }
+
+/**
+ * Returns the index of the road region
+ * @param road_region The road region to return the index for
+ */
+TRoadRegionIndex GetRoadRegionIndex(const RoadRegionDesc &road_region)
+{
+	return GetRoadRegionIndex(road_region.x, road_region.y);
+}
+
+/**
+ * Returns the index of the road region that a tile is part of.
+ * @param tile The tile.
+ */
+TRoadRegionIndex GetRoadRegionIndex(TileIndex tile)
+{
+	return GetRoadRegionIndex(GetRoadRegionX(tile), GetRoadRegionY(tile));
+}
+
+/**
+ * Returns the center tile of a particular road region.
+ * @param road_region The road region to find the center tile for.
+ * @returns The center tile of the road region.
+ */
+TileIndex GetRoadRegionCenterTile(const RoadRegionDesc &road_region)
+{
+	return TileXY(road_region.x * ROAD_REGION_EDGE_LENGTH + (ROAD_REGION_EDGE_LENGTH / 2), road_region.y * ROAD_REGION_EDGE_LENGTH + (ROAD_REGION_EDGE_LENGTH / 2));
+}
+
+/**
+ * Returns basic road region information for the provided tile.
+ * @param tile The tile for which the information will be calculated.
+ */
+RoadRegionDesc GetRoadRegionInfo(TileIndex tile)
+{
+	return RoadRegionDesc{ GetRoadRegionX(tile), GetRoadRegionY(tile) };
+}
+
+/**
+ * Returns basic road region patch information for the provided tile.
+ * @param tile The tile for which the information will be calculated.
+ * @param rtt Road/tram type.
+ */
+RoadRegionPatchDesc GetRoadRegionPatchInfo(TileIndex tile, RoadTramType rtt)
+{
+	RoadRegionReference region = GetUpdatedRoadRegion(GetRoadRegionX(tile), GetRoadRegionY(tile), rtt);
+	return RoadRegionPatchDesc{ GetRoadRegionX(tile), GetRoadRegionY(tile), region.GetLabel(tile) };
+}
+
+/**
+ * Marks the road regions that tile is part of as invalid, for both road and tram track.
+ * This must be called whenever road or tram track is added to or removed from the tile,
+ * or when the tile becomes or stops being a road stop, depot, level crossing, tunnel or bridge.
+ * @param tile Tile within the road region that we wish to invalidate.
+ */
+void InvalidateRoadRegion(TileIndex tile)
+{
+	if (tile >= MapSize()) return;
+
+	for (RoadTramType rtt : _roadtramtypes) {
+		if (_road_regions[rtt] != nullptr) GetRoadRegionRef(GetRoadRegionX(tile), GetRoadRegionY(tile), rtt).Invalidate();
+	}
+}
+
+/**
+ * Calls the provided callback function for all road region patches
+ * accessible from one particular side of the starting patch.
+ * @param road_region_patch Road patch within the road region to start searching from
+ * @param rtt Road/tram type.
+ * @param side Side of the road region to look for neighbouring patches of road
+ * @param func The function that will be called for each neighbour that is found
+ */
+static inline void VisitAdjacentRoadRegionPatchNeighbors(const RoadRegionPatchDesc &road_region_patch, RoadTramType rtt, DiagDirection side, TVisitRoadRegionPatchCallBack &func)
+{
+	const RoadRegionReference current_region = GetUpdatedRoadRegion(road_region_patch.x, road_region_patch.y, rtt);
+
+	const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+	/* Unsigned underflow is allowed here, not UB */
+	const uint32_t nx = road_region_patch.x + (uint32_t)offset.x;
+	const uint32_t ny = road_region_patch.y + (uint32_t)offset.y;
+
+	if (nx >= GetRoadRegionMapSizeX() || ny >= GetRoadRegionMapSizeY()) return;
+
+	const RoadRegionReference neighbouring_region = GetUpdatedRoadRegion(nx, ny, rtt);
+	const DiagDirection opposite_side = ReverseDiagDir(side);
+
+	/* Indicates via which local x or y coordinates (depends on the "side" parameter) we can cross over into the adjacent region. */
+	const TRoadRegionTraversabilityBits traversability_bits = current_region.GetEdgeTraversabilityBits(side)
+		& neighbouring_region.GetEdgeTraversabilityBits(opposite_side);
+	if (traversability_bits == 0) return;
+
+	if (current_region.NumberOfPatches() == 1 && neighbouring_region.NumberOfPatches() == 1) {
+		func(RoadRegionPatchDesc{ nx, ny, FIRST_REGION_LABEL }); // No further checks needed because we know there is just one patch for both adjacent regions
+		return;
+	}
+
+	/* Multiple road patches can be reached from the current patch. Check each edge tile individually. */
+	static std::vector<TRoadRegionPatchLabel> unique_labels; // static and vector-instead-of-map for performance reasons
+	unique_labels.clear();
+	for (uint32_t x_or_y = 0; x_or_y < ROAD_REGION_EDGE_LENGTH; ++x_or_y) {
+		if (!HasBit(traversability_bits, x_or_y)) continue;
+
+		const TileIndex current_edge_tile = GetEdgeTileCoordinate(road_region_patch.x, road_region_patch.y, side, x_or_y);
+		const TRoadRegionPatchLabel current_label = current_region.GetLabel(current_edge_tile);
+		if (current_label != road_region_patch.label) continue;
+
+		const TileIndex neighbour_edge_tile = GetEdgeTileCoordinate(nx, ny, opposite_side, x_or_y);
+		const TRoadRegionPatchLabel neighbour_label = neighbouring_region.GetLabel(neighbour_edge_tile);
+		if (std::find(unique_labels.begin(), unique_labels.end(), neighbour_label) == unique_labels.end()) unique_labels.push_back(neighbour_label);
+	}
+	for (TRoadRegionPatchLabel unique_label : unique_labels) func(RoadRegionPatchDesc{ nx, ny, unique_label });
+}
+
+/**
+ * Calls the provided callback function on all accessible road region patches in
+ * each cardinal direction, plus any others that are reachable via tunnels and bridges.
+ * @param road_region_patch Road patch within the road region to start searching from
+ * @param rtt Road/tram type.
+ * @param callback The function that will be called for each accessible road patch that is found
+ */
+void VisitRoadRegionPatchNeighbors(const RoadRegionPatchDesc &road_region_patch, RoadTramType rtt, TVisitRoadRegionPatchCallBack &callback)
+{
+	const RoadRegionReference current_region = GetUpdatedRoadRegion(road_region_patch.x, road_region_patch.y, rtt);
+
+	/* Visit adjacent road region patches in each cardinal direction */
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) VisitAdjacentRoadRegionPatchNeighbors(road_region_patch, rtt, side, callback);
+
+	/* Visit neighbouring road patches accessible via cross-region tunnels and bridges */
+	if (current_region.HasCrossRegionTunnelBridges()) {
+		for (const TileIndex tile : current_region) {
+			if (current_region.GetLabel(tile) != road_region_patch.label || !IsRoadRegionTunnelBridge(tile, rtt)) continue;
+
+			const TileIndex other_end_tile = GetOtherTunnelBridgeEnd(tile);
+			if (GetRoadRegionIndex(tile) != GetRoadRegionIndex(other_end_tile)) callback(GetRoadRegionPatchInfo(other_end_tile, rtt));
+		}
+	}
+}
+
+/**
+ * Initializes all road regions. Regions are updated lazily when they are first used by the pathfinder.
+ */
+void InitializeRoadRegions()
+{
+	for (RoadTramType rtt : _roadtramtypes) {
+		_road_regions[rtt].reset(new RoadRegion[GetRoadRegionMapSizeX() * GetRoadRegionMapSizeY()]);
+	}
+}
+
+void DebugInvalidateAllRoadRegions()
+{
+	const uint32_t size_x = GetRoadRegionMapSizeX();
+	const uint32_t size_y = GetRoadRegionMapSizeY();
+	for (RoadTramType rtt : _roadtramtypes) {
+		for (uint32_t y = 0; y < size_y; y++) {
+			for (uint32_t x = 0; x < size_x; x++) {
+				GetRoadRegionRef(x, y, rtt).Invalidate();
+			}
+		}
+	}
+}
+
+void DebugInitAllRoadRegions()
+{
+	const uint32_t size_x = GetRoadRegionMapSizeX();
+	const uint32_t size_y = GetRoadRegionMapSizeY();
+	for (RoadTramType rtt : _roadtramtypes) {
+		for (uint32_t y = 0; y < size_y; y++) {
+			for (uint32_t x = 0; x < size_x; x++) {
+				GetRoadRegionRef(x, y, rtt).UpdateIfNotInitialized();
+			}
+		}
+	}
+}
+
+void RoadRegionCheckCaches(std::function<void(const char *)> log)
+{
+	char cclog_buffer[1024];
+#define CCLOG(...) { \
+	char *cc_log_pos = cclog_buffer + seprintf(cclog_buffer, lastof(cclog_buffer), "Road region (%s): %u x %u to %u x %u: ", rtt == RTT_TRAM ? "tram" : "road", \
+			x * ROAD_REGION_EDGE_LENGTH, y * ROAD_REGION_EDGE_LENGTH, (x * ROAD_REGION_EDGE_LENGTH) + ROAD_REGION_EDGE_MASK, (y * ROAD_REGION_EDGE_LENGTH) + ROAD_REGION_EDGE_MASK); \
+	seprintf(cc_log_pos, lastof(cclog_buffer), __VA_ARGS__); \
+	DEBUG(desync, 0, "%s", cclog_buffer); \
+	if (log) log(cclog_buffer); \
+}
+
+	const uint32_t size_x = GetRoadRegionMapSizeX();
+	const uint32_t size_y = GetRoadRegionMapSizeY();
+	for (RoadTramType rtt : _roadtramtypes) {
+		for (uint32_t y = 0; y < size_y; y++) {
+			for (uint32_t x = 0; x < size_x; x++) {
+				RoadRegionReference rr = GetRoadRegionRef(x, y, rtt);
+				if (!rr.IsInitialized()) continue;
+
+				const bool old_has_cross_region_tunnelbridges = rr.HasCrossRegionTunnelBridges();
+				const int old_number_of_patches = rr.NumberOfPatches();
+				const TRoadRegionPatchLabelArray old_patch_labels = rr.CopyPatchLabelArray();
+				const TRoadRegionTraversabilityBits old_edges[DIAGDIR_END] = {
+					rr.GetEdgeTraversabilityBits(DIAGDIR_NE), rr.GetEdgeTraversabilityBits(DIAGDIR_SE),
+					rr.GetEdgeTraversabilityBits(DIAGDIR_SW), rr.GetEdgeTraversabilityBits(DIAGDIR_NW)
+				};
+
+				rr.ForceUpdate();
+
+				if (old_has_cross_region_tunnelbridges != rr.HasCrossRegionTunnelBridges()) {
+					CCLOG("Has cross region tunnels/bridges mismatch: %u -> %u", old_has_cross_region_tunnelbridges, rr.HasCrossRegionTunnelBridges());
+				}
+				if (old_number_of_patches != rr.NumberOfPatches()) {
+					CCLOG("Number of patches mismatch: %u -> %u", old_number_of_patches, rr.NumberOfPatches());
+				}
+				if (old_patch_labels != rr.CopyPatchLabelArray()) {
+					CCLOG("Patch label mismatch");
+				}
+				for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+					if (old_edges[side] != rr.GetEdgeTraversabilityBits(side)) {
+						CCLOG("Edge traversability mismatch: side %u: %X -> %X", side, old_edges[side], rr.GetEdgeTraversabilityBits(side));
+					}
+				}
+			}
+		}
+	}
+#undef CCLOG
+}
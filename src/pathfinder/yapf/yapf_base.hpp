@@ -12,6 +12,10 @@
 
 #include "../../debug.h"
 #include "../../settings_type.h"
+#include <chrono>
+#include <type_traits>
+
+void RecordYapfRailSearchStats(int nodes, int cost_calcs, int cache_hits, std::chrono::steady_clock::duration time);
 
 /**
  * CYapfBaseT - A-star type path finder base class.
@@ -110,6 +114,10 @@ public:
 	{
 		m_veh = v;
 
+		constexpr bool record_rail_stats = std::is_same<VehicleType, Train>::value;
+		std::chrono::steady_clock::time_point start_time;
+		if constexpr (record_rail_stats) start_time = std::chrono::steady_clock::now();
+
 		Yapf().PfSetStartupNodes();
 		bool bDestFound = true;
 
@@ -139,6 +147,10 @@ public:
 
 		bDestFound &= (m_pBestDestNode != nullptr);
 
+		if constexpr (record_rail_stats) {
+			RecordYapfRailSearchStats(m_nodes.ClosedCount(), m_stats_cost_calcs, m_stats_cache_hits, std::chrono::steady_clock::now() - start_time);
+		}
+
 		if (_debug_yapf_level >= 3) {
 			UnitID veh_idx = (m_veh != nullptr) ? m_veh->unitnumber : 0;
 			char ttc = Yapf().TransportTypeChar();
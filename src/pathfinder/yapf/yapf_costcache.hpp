@@ -11,6 +11,8 @@
 #define YAPF_COSTCACHE_HPP
 
 #include "../../date_func.h"
+#include "../../map_func.h"
+#include <vector>
 
 /**
  * CYapfSegmentCostCacheNoneT - the formal only yapf cost cache provider that implements
@@ -91,19 +93,80 @@ public:
 
 
 /**
- * Base class for segment cost cache providers. Contains global counter
- *  of track layout changes and static notification function called whenever
- *  the track layout changes. It is implemented as base class because it needs
+ * Base class for segment cost cache providers. Contains the global counter
+ *  of track layout changes, the per map region record of local track layout
+ *  changes and the static notification function called whenever the track
+ *  layout changes. It is implemented as base class because it needs
  *  to be shared between all rail YAPF types (one shared counter, one notification
  *  function.
+ *
+ * A change of the track layout at a tile only invalidates the cached segments
+ *  near that tile: each cached segment records the rectangle of map regions
+ *  its tiles are in, and the change stamp at the time its cost was calculated.
+ *  It is valid while none of these regions has changed since.
+ *  A change without a tile (INVALID_TILE) flushes the whole cache.
  */
 struct CSegmentCostCacheBase
 {
+	static const uint REGION_BITS = 5; ///< Log2 of the size of a map region in tiles, in each direction.
+
+	/** Counters of the segment cost cache, for debugging. */
+	struct Stats {
+		uint64_t flushes = 0;        ///< Number of times the whole cache has been flushed.
+		uint64_t local_changes = 0;  ///< Number of track layout changes at a specific tile.
+		uint64_t invalidated = 0;    ///< Number of cached segments which were found to be stale.
+	};
+
 	static int   s_rail_change_counter;
+	static uint64_t s_change_stamp;                  ///< Incremented for each track layout change at a specific tile.
+	static std::vector<uint64_t> s_region_stamps;    ///< Change stamp of the last track layout change in each map region.
+	static Stats s_stats;
+
+	static void NotifyTrackLayoutChange(TileIndex tile, Track)
+	{
+		if (tile == INVALID_TILE || !CheckRegions()) {
+			s_rail_change_counter++;
+			return;
+		}
+		s_stats.local_changes++;
+		s_region_stamps[GetRegionIndex(TileX(tile) >> REGION_BITS, TileY(tile) >> REGION_BITS)] = ++s_change_stamp;
+	}
+
+	/**
+	 * Make sure that there is a change stamp for each region of the current map.
+	 * @return True if the regions were already set up for this map, false if they have been reset.
+	 */
+	static bool CheckRegions()
+	{
+		const size_t count = (size_t)(MapSizeX() >> REGION_BITS) * (MapSizeY() >> REGION_BITS);
+		if (s_region_stamps.size() == count) return true;
+		s_region_stamps.assign(count, 0);
+		return false;
+	}
+
+	static inline size_t GetRegionIndex(uint region_x, uint region_y)
+	{
+		return (region_y << (MapLogX() - REGION_BITS)) + region_x;
+	}
 
-	static void NotifyTrackLayoutChange(TileIndex, Track)
+	/**
+	 * Check whether any region in a rectangle has changed since a given change stamp.
+	 * @param left First region in the x direction.
+	 * @param top First region in the y direction.
+	 * @param right Last region in the x direction.
+	 * @param bottom Last region in the y direction.
+	 * @param stamp Change stamp to check against.
+	 * @return True if a region has changed after  stamp.
+	 */
+	static bool HasRegionChangedSince(uint left, uint top, uint right, uint bottom, uint64_t stamp)
 	{
-		s_rail_change_counter++;
+		for (uint y = top; y <= bottom; y++) {
+			const uint64_t *region = s_region_stamps.data() + GetRegionIndex(left, y);
+			for (uint x = left; x <= right; x++, region++) {
+				if (*region > stamp) return true;
+			}
+		}
+		return false;
 	}
 };
 
@@ -121,6 +184,7 @@ struct CSegmentCostCacheBase
 template <class Tsegment>
 struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 	static const int C_HASH_BITS = 14;
+	static const uint MAX_SEGMENTS = 1 << 18; ///< Number of segments at which the cache is flushed, as it is no longer flushed by every track layout change.
 
 	typedef CHashTableT<Tsegment, C_HASH_BITS> HashTable;
 	typedef SmallArray<Tsegment> Heap;
@@ -184,10 +248,11 @@ protected:
 		static int last_rail_change_counter = 0;
 		static Cache C;
 
-		/* delete the cache sometimes... */
-		if (last_rail_change_counter != Cache::s_rail_change_counter) {
+		/* delete the cache after global changes, or when it has grown too large */
+		if (!Cache::CheckRegions() || last_rail_change_counter != Cache::s_rail_change_counter || C.m_heap.Length() >= Cache::MAX_SEGMENTS) {
 			last_rail_change_counter = Cache::s_rail_change_counter;
 			C.Flush();
+			Cache::s_stats.flushes++;
 		}
 		return C;
 	}
@@ -205,6 +270,11 @@ public:
 		CacheKey key(n.GetKey());
 		bool found;
 		CachedData &item = m_global_cache.Get(key, &found);
+		if (found && item.IsStale()) {
+			item.Reset();
+			Cache::s_stats.invalidated++;
+			found = false;
+		}
 		Yapf().ConnectNodeToCachedData(n, item);
 		return found;
 	}
@@ -566,6 +566,22 @@ public:
 
 		TrackFollower tf_local(v, Yapf().GetCompatibleRailTypes());
 
+		/* Rectangle of the tiles which the segment data depends on, to invalidate the cached segment when any of these change. */
+		uint min_x = TileX(n.m_key.m_tile);
+		uint min_y = TileY(n.m_key.m_tile);
+		uint max_x = min_x;
+		uint max_y = min_y;
+		auto include_tile = [&](TileIndex tile) {
+			const uint x = TileX(tile);
+			const uint y = TileY(tile);
+			if (x < min_x) min_x = x;
+			if (x > max_x) max_x = x;
+			if (y < min_y) min_y = y;
+			if (y > max_y) max_y = y;
+		};
+		/* Tiles skipped when entering the segment, such as station platform tiles, are between these two tiles. */
+		if (has_parent && tf->m_old_tile != INVALID_TILE) include_tile(tf->m_old_tile);
+
 		if (!has_parent) {
 			/* We will jump to the middle of the cost calculator assuming that segment cache is not used. */
 			dbg_assert(!is_cached_segment);
@@ -614,6 +630,8 @@ public:
 
 no_entry_cost: // jump here at the beginning if the node has no parent (it is the first node)
 
+			include_tile(cur.tile);
+
 			/* All other tile costs will be calculated here. */
 			segment_cost += Yapf().OneTileCost(cur.tile, cur.td);
 
@@ -730,7 +748,9 @@ no_entry_cost: // jump here at the beginning if the node has no parent (it is th
 			tf = &tf_local;
 			tf_local.Init(v, Yapf().GetCompatibleRailTypes());
 
-			if (!tf_local.Follow(cur.tile, cur.td)) {
+			bool followed = tf_local.Follow(cur.tile, cur.td);
+			if (tf_local.m_new_tile != INVALID_TILE) include_tile(tf_local.m_new_tile);
+			if (!followed) {
 				dbg_assert(tf_local.m_err != TrackFollower::EC_NONE);
 				/* Can't move to the next tile (EOL?). */
 				if (!(end_segment_reason & (ESRB_RAIL_TYPE | ESRB_DEAD_END))) end_segment_reason |= ESRB_DEAD_END_EOL;
@@ -826,6 +846,7 @@ no_entry_cost: // jump here at the beginning if the node has no parent (it is th
 			/* Write back the segment information so it can be reused the next time. */
 			segment.m_cost = segment_cost;
 			segment.m_end_segment_reason = end_segment_reason & ESRB_CACHED_MASK;
+			segment.SetRegions(min_x, min_y, max_x, max_y);
 			/* Save end of segment back to the node. */
 			n.SetLastTileTrackdir(cur.tile, cur.td);
 		}
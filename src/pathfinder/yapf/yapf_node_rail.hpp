@@ -69,18 +69,58 @@ struct CYapfRailSegment
 	TileIndex              m_last_signal_tile;
 	Trackdir               m_last_signal_td;
 	EndSegmentReasonBits   m_end_segment_reason;
+	uint64_t               m_region_stamp;     ///< Track layout change stamp when the cost was calculated.
+	uint16_t               m_region_left;      ///< First map region the segment depends on, in the x direction.
+	uint16_t               m_region_top;       ///< First map region the segment depends on, in the y direction.
+	uint16_t               m_region_right;     ///< Last map region the segment depends on, in the x direction.
+	uint16_t               m_region_bottom;    ///< Last map region the segment depends on, in the y direction.
 	CYapfRailSegment      *m_hash_next;
 
 	inline CYapfRailSegment(const CYapfRailSegmentKey &key)
 		: m_key(key)
-		, m_last_tile(INVALID_TILE)
-		, m_last_td(INVALID_TRACKDIR)
-		, m_cost(-1)
-		, m_last_signal_tile(INVALID_TILE)
-		, m_last_signal_td(INVALID_TRACKDIR)
-		, m_end_segment_reason(ESRB_NONE)
 		, m_hash_next(nullptr)
-	{}
+	{
+		Reset();
+	}
+
+	/** Forget the calculated segment data, but keep the key and the place in the hash table. */
+	inline void Reset()
+	{
+		m_last_tile = INVALID_TILE;
+		m_last_td = INVALID_TRACKDIR;
+		m_cost = -1;
+		m_last_signal_tile = INVALID_TILE;
+		m_last_signal_td = INVALID_TRACKDIR;
+		m_end_segment_reason = ESRB_NONE;
+		m_region_stamp = 0;
+		m_region_left = m_region_top = m_region_right = m_region_bottom = 0;
+	}
+
+	/**
+	 * Record the tiles which the calculated segment data depends on.
+	 * The rectangle is extended by one tile, as the tiles next to the segment determine where it ends.
+	 * @param min_x Minimum x coordinate of the tiles.
+	 * @param min_y Minimum y coordinate of the tiles.
+	 * @param max_x Maximum x coordinate of the tiles.
+	 * @param max_y Maximum y coordinate of the tiles.
+	 */
+	inline void SetRegions(uint min_x, uint min_y, uint max_x, uint max_y)
+	{
+		m_region_stamp = CSegmentCostCacheBase::s_change_stamp;
+		m_region_left = (min_x > 0 ? min_x - 1 : 0) >> CSegmentCostCacheBase::REGION_BITS;
+		m_region_top = (min_y > 0 ? min_y - 1 : 0) >> CSegmentCostCacheBase::REGION_BITS;
+		m_region_right = std::min(max_x + 1, MapMaxX()) >> CSegmentCostCacheBase::REGION_BITS;
+		m_region_bottom = std::min(max_y + 1, MapMaxY()) >> CSegmentCostCacheBase::REGION_BITS;
+	}
+
+	/**
+	 * Check whether the calculated segment data is out of date, because the track layout near the segment has changed.
+	 * @return True if the segment data must be calculated again.
+	 */
+	inline bool IsStale() const
+	{
+		return m_cost >= 0 && CSegmentCostCacheBase::HasRegionChangedSince(m_region_left, m_region_top, m_region_right, m_region_bottom, m_region_stamp);
+	}
 
 	inline const Key &GetKey() const
 	{
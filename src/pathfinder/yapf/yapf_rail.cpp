@@ -14,10 +14,12 @@
 #include "yapf_node_rail.hpp"
 #include "yapf_costrail.hpp"
 #include "yapf_destrail.hpp"
+#include "yapf_rail_regions.h"
 #include "../../viewport_func.h"
 #include "../../newgrf_station.h"
 #include "../../tracerestrict.h"
 #include "../../debug.h"
+#include "../../date_func.h"
 
 #include "../../safeguards.h"
 
@@ -476,6 +478,13 @@ protected:
 		return *static_cast<Tpf *>(this);
 	}
 
+	std::vector<TRailRegionIndex> m_rail_region_corridor; ///< sorted rail regions the search is restricted to, empty if not restricted
+
+	inline bool IsInRailRegionCorridor(TileIndex tile) const
+	{
+		return m_rail_region_corridor.empty() || std::binary_search(m_rail_region_corridor.begin(), m_rail_region_corridor.end(), GetRailRegionIndex(tile));
+	}
+
 public:
 	/**
 	 * Called by YAPF to move from the given node to the next tile. For each
@@ -494,7 +503,7 @@ public:
 				rev_node = rev_node->m_parent;
 			}
 			if (rev_node && length >= v->gcache.cached_total_length) {
-				if (F.Follow(rev_node->GetLastTile(), ReverseTrackdir(rev_node->GetLastTrackdir()))) {
+				if (F.Follow(rev_node->GetLastTile(), ReverseTrackdir(rev_node->GetLastTrackdir())) && IsInRailRegionCorridor(F.m_new_tile)) {
 					Yapf().AddMultipleNodes(&old_node, F, [&](Node &n) {
 						n.flags_u.flags_s.m_reverse_pending = false;
 						n.flags_u.flags_s.m_teleport = true;
@@ -505,11 +514,32 @@ public:
 				return;
 			}
 		}
-		if (F.Follow(old_node.GetLastTile(), old_node.GetLastTrackdir())) {
+		if (F.Follow(old_node.GetLastTile(), old_node.GetLastTrackdir()) && IsInRailRegionCorridor(F.m_new_tile)) {
 			Yapf().AddMultipleNodes(&old_node, F);
 		}
 	}
 
+	/**
+	 * Restricts the search to a corridor around a path of rail regions.
+	 * The corridor includes all regions adjacent to the path, as lines often run along region edges.
+	 * @param path Rail region path, or empty to not restrict the search.
+	 */
+	inline void RestrictSearch(const std::vector<RailRegionPatchDesc> &path)
+	{
+		m_rail_region_corridor.clear();
+		const uint32_t size_x = GetRailRegionMapSizeX();
+		const uint32_t size_y = GetRailRegionMapSizeY();
+		for (const RailRegionPatchDesc &path_entry : path) {
+			for (uint32_t y = std::max<uint32_t>(path_entry.y, 1) - 1; y <= std::min<uint32_t>(path_entry.y + 1, size_y - 1); y++) {
+				for (uint32_t x = std::max<uint32_t>(path_entry.x, 1) - 1; x <= std::min<uint32_t>(path_entry.x + 1, size_x - 1); x++) {
+					m_rail_region_corridor.push_back(GetRailRegionIndex(RailRegionDesc(x, y)));
+				}
+			}
+		}
+		std::sort(m_rail_region_corridor.begin(), m_rail_region_corridor.end());
+		m_rail_region_corridor.erase(std::unique(m_rail_region_corridor.begin(), m_rail_region_corridor.end()), m_rail_region_corridor.end());
+	}
+
 	/** return debug report character to identify the transportation type */
 	inline char TransportTypeChar() const
 	{
@@ -517,9 +547,26 @@ public:
 	}
 
 	static Trackdir stChooseRailTrack(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest)
+	{
+		/* Use the rail regions to cut the search short when the destination can't be reached by rail at all, starting from
+		 * the end of the current reservation like the search itself. The rail regions over-approximate the reachability of
+		 * the search, as they don't take signals, rail types, owners or 90 degree turns into account, so the search is only
+		 * restricted when it can't find a path anyway. Otherwise it runs unrestricted, to choose the same path as before. */
+		const TileIndex origin_tile = FollowTrainReservation(v, nullptr, FTRF_OKAY_UNUSED).tile;
+		std::vector<RailRegionPatchDesc> high_level_path;
+		if (YapfTrainFindRailRegionPath(v, origin_tile, high_level_path) && high_level_path.empty()) {
+			/* Only search the surroundings of the train. The search still reports a path when it stops on the first two-way signal. */
+			return stChooseRailTrackInCorridor(v, tile, enterdir, tracks, path_found, reserve_track, target, dest, { GetRailRegionPatchInfo(origin_tile) });
+		}
+
+		return stChooseRailTrackInCorridor(v, tile, enterdir, tracks, path_found, reserve_track, target, dest, {});
+	}
+
+	static Trackdir stChooseRailTrackInCorridor(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest, const std::vector<RailRegionPatchDesc> &corridor)
 	{
 		/* create pathfinder instance */
 		Tpf pf1;
+		pf1.RestrictSearch(corridor);
 		Trackdir result1;
 
 		if (_debug_yapfdesync_level < 1 && _debug_desync_level < 2) {
@@ -528,6 +575,7 @@ public:
 			result1 = pf1.ChooseRailTrack(v, tile, enterdir, tracks, path_found, false, nullptr, nullptr);
 			Tpf pf2;
 			pf2.DisableCache(true);
+			pf2.RestrictSearch(corridor);
 			Trackdir result2 = pf2.ChooseRailTrack(v, tile, enterdir, tracks, path_found, reserve_track, target, dest);
 			if (result1 != result2) {
 				DEBUG(desync, 0, "CACHE ERROR: ChooseRailTrack() = [%d, %d]", result1, result2);
@@ -783,10 +831,115 @@ bool YapfTrainFindNearestSafeTile(const Train *v, TileIndex tile, Trackdir td, b
 
 /** if any track changes, this counter is incremented - that will invalidate segment cost cache */
 int CSegmentCostCacheBase::s_rail_change_counter = 0;
+/** if the track changes at a specific tile, this counter is incremented and stored for the map region of that tile */
+uint64_t CSegmentCostCacheBase::s_change_stamp = 0;
+std::vector<uint64_t> CSegmentCostCacheBase::s_region_stamps;
+CSegmentCostCacheBase::Stats CSegmentCostCacheBase::s_stats;
 
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track)
 {
 	CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);
+
+	if (tile == INVALID_TILE) {
+		InvalidateAllRailRegions();
+	} else {
+		InvalidateRailRegion(tile);
+		/* Tunnels and bridges link the rail regions at both ends. */
+		if (IsTileType(tile, MP_TUNNELBRIDGE)) InvalidateRailRegion(GetOtherTunnelBridgeEnd(tile));
+	}
+}
+
+static const uint YAPF_RAIL_STATS_TICKS = 64; ///< Number of recent game ticks for which rail pathfinder statistics are kept.
+
+/** Statistics of rail pathfinder searches. */
+struct YapfRailSearchStats {
+	uint64_t tick = 0;                            ///< Game tick of the searches, for per-tick statistics.
+	uint64_t searches = 0;                        ///< Number of searches.
+	uint64_t nodes = 0;                           ///< Number of closed nodes.
+	uint64_t cost_calcs = 0;                      ///< Number of segment costs which were calculated.
+	uint64_t cache_hits = 0;                      ///< Number of segment costs which were taken from the segment cost cache.
+	std::chrono::steady_clock::duration time{};   ///< Time spent searching.
+
+	void Add(const YapfRailSearchStats &other)
+	{
+		this->searches += other.searches;
+		this->nodes += other.nodes;
+		this->cost_calcs += other.cost_calcs;
+		this->cache_hits += other.cache_hits;
+		this->time += other.time;
+	}
+
+	char *Dump(char *buffer, const char *last, const char *label, uint64_t divisor = 1) const
+	{
+		return buffer + seprintf(buffer, last, "%s: searches: " OTTD_PRINTF64U ", nodes: " OTTD_PRINTF64U ", cost calcs: " OTTD_PRINTF64U ", cache hits: " OTTD_PRINTF64U ", time: " OTTD_PRINTF64U " us\n",
+				label, this->searches / divisor, this->nodes / divisor, this->cost_calcs / divisor, this->cache_hits / divisor,
+				(uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(this->time).count() / divisor);
+	}
+};
+
+static YapfRailSearchStats _yapf_rail_tick_stats[YAPF_RAIL_STATS_TICKS]; ///< Per-tick statistics, indexed by game tick modulo YAPF_RAIL_STATS_TICKS.
+static YapfRailSearchStats _yapf_rail_total_stats;                        ///< Statistics since the last reset.
+
+void RecordYapfRailSearchStats(int nodes, int cost_calcs, int cache_hits, std::chrono::steady_clock::duration time)
+{
+	YapfRailSearchStats search;
+	search.searches = 1;
+	search.nodes = nodes;
+	search.cost_calcs = cost_calcs;
+	search.cache_hits = cache_hits;
+	search.time = time;
+
+	YapfRailSearchStats &tick_stats = _yapf_rail_tick_stats[_tick_counter % YAPF_RAIL_STATS_TICKS];
+	if (tick_stats.tick != _tick_counter) {
+		tick_stats = {};
+		tick_stats.tick = _tick_counter;
+	}
+	tick_stats.Add(search);
+	_yapf_rail_total_stats.Add(search);
+}
+
+void ResetYapfRailSearchStats()
+{
+	for (YapfRailSearchStats &tick_stats : _yapf_rail_tick_stats) {
+		tick_stats = {};
+	}
+	_yapf_rail_total_stats = {};
+	CSegmentCostCacheBase::s_stats = {};
+}
+
+void DumpYapfRailSearchStats(char *buffer, const char *last)
+{
+	const YapfRailSearchStats *last_tick = nullptr;
+	const YapfRailSearchStats *peak_tick = nullptr;
+	YapfRailSearchStats recent;
+	for (const YapfRailSearchStats &tick_stats : _yapf_rail_tick_stats) {
+		if (tick_stats.searches == 0 || tick_stats.tick > _tick_counter || _tick_counter - tick_stats.tick >= YAPF_RAIL_STATS_TICKS) continue;
+		recent.Add(tick_stats);
+		if (last_tick == nullptr || tick_stats.tick > last_tick->tick) last_tick = &tick_stats;
+		if (peak_tick == nullptr || tick_stats.time > peak_tick->time) peak_tick = &tick_stats;
+	}
+
+	char label[64];
+	buffer += seprintf(buffer, last, "Rail pathfinder:\n");
+	if (last_tick != nullptr) {
+		seprintf(label, lastof(label), "  Last tick with searches (%u ticks ago)", (uint)(_tick_counter - last_tick->tick));
+		buffer = last_tick->Dump(buffer, last, label);
+		seprintf(label, lastof(label), "  Peak tick (%u ticks ago)", (uint)(_tick_counter - peak_tick->tick));
+		buffer = peak_tick->Dump(buffer, last, label);
+	}
+	seprintf(label, lastof(label), "  Mean of last %u ticks", YAPF_RAIL_STATS_TICKS);
+	buffer = recent.Dump(buffer, last, label, YAPF_RAIL_STATS_TICKS);
+	buffer = _yapf_rail_total_stats.Dump(buffer, last, "  Total since reset");
+
+	auto hit_rate = [](const YapfRailSearchStats &stats) -> double {
+		const uint64_t lookups = stats.cost_calcs + stats.cache_hits;
+		return lookups == 0 ? 0.0 : (100.0 * stats.cache_hits) / lookups;
+	};
+	const CSegmentCostCacheBase::Stats &cache_stats = CSegmentCostCacheBase::s_stats;
+	buffer += seprintf(buffer, last, "Segment cost cache: hit rate: %.1f%% (last %u ticks), %.1f%% (since reset)\n",
+			hit_rate(recent), YAPF_RAIL_STATS_TICKS, hit_rate(_yapf_rail_total_stats));
+	buffer += seprintf(buffer, last, "  Local track changes: " OTTD_PRINTF64U ", stale segments recalculated: " OTTD_PRINTF64U ", flushes: " OTTD_PRINTF64U "\n",
+			cache_stats.local_changes, cache_stats.invalidated, cache_stats.flushes);
 }
 
 void YapfCheckRailSignalPenalties()
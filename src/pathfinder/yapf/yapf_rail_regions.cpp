@@ -0,0 +1,323 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file yapf_rail_regions.cpp Implementation of YAPF for rail regions, which are used for restricting the train search area. */
+
+#include "../../stdafx.h"
+#include "../../train.h"
+#include "../../station_base.h"
+#include "../../core/math_func.hpp"
+
+#include "yapf.hpp"
+#include "yapf_rail_regions.h"
+#include "../rail_regions.h"
+
+#include "../../safeguards.h"
+
+constexpr int DIRECT_NEIGHBOR_COST = 100;
+constexpr int NODES_PER_REGION = 4;
+constexpr uint32_t MAX_NUMBER_OF_NODES = 65536;
+
+/** Yapf Node Key that represents a single patch of interconnected track within a rail region. */
+struct CYapfRailRegionPatchNodeKey {
+	RailRegionPatchDesc m_rail_region_patch;
+
+	static_assert(sizeof(TRailRegionPatchLabel) == sizeof(uint16_t)); // Important for the hash calculation.
+
+	inline void Set(const RailRegionPatchDesc &rail_region_patch)
+	{
+		m_rail_region_patch = rail_region_patch;
+	}
+
+	inline int CalcHash() const { return (int)(m_rail_region_patch.label ^ (GetRailRegionIndex(m_rail_region_patch) << 4)); }
+	inline bool operator==(const CYapfRailRegionPatchNodeKey &other) const { return m_rail_region_patch == other.m_rail_region_patch; }
+};
+
+inline uint ManhattanDistance(const CYapfRailRegionPatchNodeKey &a, const CYapfRailRegionPatchNodeKey &b)
+{
+	return (Delta(a.m_rail_region_patch.x, b.m_rail_region_patch.x) + Delta(a.m_rail_region_patch.y, b.m_rail_region_patch.y)) * DIRECT_NEIGHBOR_COST;
+}
+
+/** Yapf Node for rail regions. */
+template <class Tkey_>
+struct CYapfRailRegionNodeT {
+	typedef Tkey_ Key;
+	typedef CYapfRailRegionNodeT<Tkey_> Node;
+
+	Tkey_       m_key;
+	Node       *m_hash_next;
+	Node       *m_parent;
+	int         m_cost;
+	int         m_estimate;
+
+	inline void Set(Node *parent, const RailRegionPatchDesc &rail_region_patch)
+	{
+		m_key.Set(rail_region_patch);
+		m_hash_next = nullptr;
+		m_parent = parent;
+		m_cost = 0;
+		m_estimate = 0;
+	}
+
+	inline void Set(Node *parent, const Key &key)
+	{
+		Set(parent, key.m_rail_region_patch);
+	}
+
+	inline Node *GetHashNext() { return m_hash_next; }
+	inline void SetHashNext(Node *pNext) { m_hash_next = pNext; }
+	inline const Tkey_ &GetKey() const { return m_key; }
+	inline int GetCost() { return m_cost; }
+	inline int GetCostEstimate() { return m_estimate; }
+	inline bool operator<(const Node &other) const { return m_estimate < other.m_estimate; }
+};
+
+/** YAPF origin for rail regions. */
+template <class Types>
+class CYapfOriginRailRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::NodeList::Titem Node; ///< This will be our node type.
+	typedef typename Node::Key Key;               ///< Key to hash tables.
+
+protected:
+	inline Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+private:
+	std::vector<CYapfRailRegionPatchNodeKey> m_origin_keys;
+
+public:
+	void AddOrigin(const RailRegionPatchDesc &rail_region_patch)
+	{
+		if (!IsValidRailRegionPatch(rail_region_patch)) return;
+		if (!HasOrigin(rail_region_patch)) m_origin_keys.push_back(CYapfRailRegionPatchNodeKey{ rail_region_patch });
+	}
+
+	bool HasOrigin(const RailRegionPatchDesc &rail_region_patch)
+	{
+		return std::find(m_origin_keys.begin(), m_origin_keys.end(), CYapfRailRegionPatchNodeKey{ rail_region_patch }) != m_origin_keys.end();
+	}
+
+	bool HasAnyOrigin() const
+	{
+		return !m_origin_keys.empty();
+	}
+
+	void PfSetStartupNodes()
+	{
+		for (const CYapfRailRegionPatchNodeKey &origin_key : m_origin_keys) {
+			Node &node = Yapf().CreateNewNode();
+			node.Set(nullptr, origin_key);
+			Yapf().AddStartupNode(node);
+		}
+	}
+};
+
+/** YAPF destination provider for rail regions. */
+template <class Types>
+class CYapfDestinationRailRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::NodeList::Titem Node; ///< This will be our node type.
+	typedef typename Node::Key Key;               ///< Key to hash tables.
+
+protected:
+	Key m_dest;
+
+public:
+	void SetDestination(const RailRegionPatchDesc &rail_region_patch)
+	{
+		m_dest.Set(rail_region_patch);
+	}
+
+protected:
+	Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+public:
+	inline bool PfDetectDestination(Node &n) const
+	{
+		return n.m_key == m_dest;
+	}
+
+	inline bool PfCalcEstimate(Node &n)
+	{
+		if (PfDetectDestination(n)) {
+			n.m_estimate = n.m_cost;
+			return true;
+		}
+
+		n.m_estimate = n.m_cost + ManhattanDistance(n.m_key, m_dest);
+
+		return true;
+	}
+};
+
+/** YAPF node following for rail region pathfinding. */
+template <class Types>
+class CYapfFollowRailRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;                     ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::TrackFollower TrackFollower;
+	typedef typename Types::NodeList::Titem Node;        ///< This will be our node type.
+	typedef typename Node::Key Key;                      ///< Key to hash tables.
+
+protected:
+	inline Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+public:
+	inline void PfFollowNode(Node &old_node)
+	{
+		TVisitRailRegionPatchCallBack visitFunc = [&](const RailRegionPatchDesc &rail_region_patch)
+		{
+			Node &node = Yapf().CreateNewNode();
+			node.Set(&old_node, rail_region_patch);
+			Yapf().AddNewNode(node, TrackFollower{});
+		};
+		VisitRailRegionPatchNeighbors(old_node.m_key.m_rail_region_patch, visitFunc);
+	}
+
+	inline char TransportTypeChar() const { return '#'; }
+
+	static bool FindRailRegionPath(const Train *v, TileIndex start_tile, std::vector<RailRegionPatchDesc> &path)
+	{
+		path.clear();
+
+		const RailRegionPatchDesc start_rail_region_patch = GetRailRegionPatchInfo(start_tile);
+		if (!IsValidRailRegionPatch(start_rail_region_patch)) return false;
+
+		/* We reserve 4 nodes (patches) per rail region, capped at 65536, as for water regions. */
+		const int max_nodes = std::min(static_cast<uint32_t>(MapSize() * NODES_PER_REGION) / RAIL_REGION_NUMBER_OF_TILES, MAX_NUMBER_OF_NODES);
+		Tpf pf(max_nodes);
+		pf.SetDestination(start_rail_region_patch);
+
+		switch (v->current_order.GetType()) {
+			case OT_GOTO_STATION:
+			case OT_GOTO_WAYPOINT: {
+				const StationID station_id = v->current_order.GetDestination();
+				const BaseStation *station = BaseStation::GetIfValid(station_id);
+				if (station == nullptr) return false;
+				const StationType station_type = v->current_order.IsType(OT_GOTO_WAYPOINT) ? STATION_WAYPOINT : STATION_RAIL;
+				TileArea tile_area;
+				station->GetTileArea(&tile_area, station_type);
+				for (const auto &tile : tile_area) {
+					if (IsTileType(tile, MP_STATION) && GetStationIndex(tile) == station_id && GetStationType(tile) == station_type) {
+						pf.AddOrigin(GetRailRegionPatchInfo(tile));
+					}
+				}
+				break;
+			}
+
+			case OT_GOTO_DEPOT:
+				/* Any depot will do, so there is no single destination to route to. */
+				if (v->current_order.GetDepotActionType() & ODATFB_NEAREST_DEPOT) return false;
+				FALLTHROUGH;
+
+			default:
+				if (v->dest_tile < MapSize()) pf.AddOrigin(GetRailRegionPatchInfo(v->dest_tile));
+				break;
+		}
+
+		if (!pf.HasAnyOrigin()) return false;
+
+		/* If origin and destination are the same we simply return that track patch. */
+		if (pf.HasOrigin(start_rail_region_patch)) {
+			path.push_back(start_rail_region_patch);
+			return true;
+		}
+
+		/* Find best path. */
+		if (!pf.FindPath(v)) {
+			/* Either the destination is not connected to the start, or the node limit was hit, in which case nothing is known. */
+			return pf.m_nodes.ClosedCount() < max_nodes;
+		}
+
+		path.push_back(start_rail_region_patch);
+		Node *node = pf.GetBestNode();
+		while (node != nullptr && node->m_parent != nullptr) {
+			node = node->m_parent;
+			path.push_back(node->m_key.m_rail_region_patch);
+		}
+
+		return true;
+	}
+};
+
+/** Cost Provider of YAPF for rail regions. */
+template <class Types>
+class CYapfCostRailRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< The pathfinder class (derived from THIS class).
+	typedef typename Types::TrackFollower TrackFollower;
+	typedef typename Types::NodeList::Titem Node; ///< This will be our node type.
+	typedef typename Node::Key Key;               ///< Key to hash tables.
+
+protected:
+	/** To access inherited path finder. */
+	Tpf &Yapf() { return *static_cast<Tpf*>(this); }
+
+public:
+	/**
+	 * Called by YAPF to calculate the cost from the origin to the given node.
+	 * Calculates only the cost of given node, adds it to the parent node cost
+	 * and stores the result into Node::m_cost member.
+	 */
+	inline bool PfCalcCost(Node &n, const TrackFollower *)
+	{
+		n.m_cost = n.m_parent->m_cost + std::max<uint>(ManhattanDistance(n.m_key, n.m_parent->m_key), DIRECT_NEIGHBOR_COST);
+		return true;
+	}
+};
+
+/* We don't need a follower but YAPF requires one. */
+struct RailRegionDummyFollower {};
+
+/**
+ * Config struct of YAPF for rail region route planning.
+ * Defines all 6 base YAPF modules as classes providing services for CYapfBaseT.
+ */
+template <class Tpf_, class Tnode_list>
+struct CYapfRailRegion_TypesT
+{
+	typedef CYapfRailRegion_TypesT<Tpf_, Tnode_list> Types;     ///< Shortcut for this struct type.
+	typedef Tpf_                                 Tpf;           ///< Pathfinder type.
+	typedef RailRegionDummyFollower              TrackFollower; ///< Track follower helper class
+	typedef Tnode_list                           NodeList;
+	typedef Vehicle                              VehicleType;   ///< Not Train, such that region searches are not counted in the rail search statistics
+
+	/** Pathfinder components (modules). */
+	typedef CYapfBaseT<Types>                 PfBase;        ///< Base pathfinder class.
+	typedef CYapfFollowRailRegionT<Types>     PfFollow;      ///< Node follower.
+	typedef CYapfOriginRailRegionT<Types>     PfOrigin;      ///< Origin provider.
+	typedef CYapfDestinationRailRegionT<Types> PfDestination; ///< Destination/distance provider.
+	typedef CYapfSegmentCostCacheNoneT<Types> PfCache;       ///< Segment cost cache provider.
+	typedef CYapfCostRailRegionT<Types>       PfCost;        ///< Cost provider.
+};
+
+typedef CNodeList_HashTableT<CYapfRailRegionNodeT<CYapfRailRegionPatchNodeKey>, 12, 12> CRegionNodeListRail;
+
+struct CYapfRailRegion : CYapfT<CYapfRailRegion_TypesT<CYapfRailRegion, CRegionNodeListRail>>
+{
+	explicit CYapfRailRegion(int max_nodes) { m_max_search_nodes = max_nodes; }
+};
+
+/**
+ * Finds a path at the rail region level, from the rail region patch of the start tile to any rail region patch of the train's destination.
+ * The regions only describe which track tiles are connected, so a found path does not guarantee that the train can actually use it,
+ * but if no path is found then the destination is not reachable by rail from the start tile.
+ * @param v The train to find a path for.
+ * @param start_tile The tile to start searching from.
+ * @param[out] path A path of rail region patches starting with the start patch, or empty if the destination is not reachable.
+ * @returns False if the rail regions can't be used for this search, in which case \a path is empty as well.
+ */
+bool YapfTrainFindRailRegionPath(const Train *v, TileIndex start_tile, std::vector<RailRegionPatchDesc> &path)
+{
+	return CYapfRailRegion::FindRailRegionPath(v, start_tile, path);
+}
@@ -0,0 +1,23 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+ /** @file yapf_rail_regions.h Implementation of YAPF for rail regions, which are used for restricting the train search area. */
+
+#ifndef YAPF_RAIL_REGIONS_H
+#define YAPF_RAIL_REGIONS_H
+
+#include "../../stdafx.h"
+#include "../../tile_type.h"
+#include "../rail_regions.h"
+
+#include <vector>
+
+struct Train;
+
+bool YapfTrainFindRailRegionPath(const Train *v, TileIndex start_tile, std::vector<RailRegionPatchDesc> &path);
+
+#endif /* YAPF_RAIL_REGIONS_H */
@@ -10,6 +10,7 @@
 #include "../../stdafx.h"
 #include "yapf.hpp"
 #include "yapf_node_road.hpp"
+#include "yapf_road_regions.h"
 #include "../../roadstop_base.h"
 #include "../../vehicle_func.h"
 
@@ -415,6 +416,8 @@ protected:
 		return *static_cast<Tpf *>(this);
 	}
 
+	std::vector<TRoadRegionIndex> m_road_region_corridor; ///< sorted road regions the search is restricted to, empty if not restricted
+
 public:
 
 	/**
@@ -426,8 +429,32 @@ public:
 	{
 		TrackFollower F(Yapf().GetVehicle());
 		if (F.Follow(old_node.m_segment_last_tile, old_node.m_segment_last_td)) {
-			Yapf().AddMultipleNodes(&old_node, F);
+			if (m_road_region_corridor.empty()
+					|| std::binary_search(m_road_region_corridor.begin(), m_road_region_corridor.end(), GetRoadRegionIndex(F.m_new_tile))) {
+				Yapf().AddMultipleNodes(&old_node, F);
+			}
+		}
+	}
+
+	/**
+	 * Restricts the search to a corridor around a path of road regions.
+	 * The corridor includes all regions adjacent to the path, as roads often run along region edges.
+	 * @param path Road region path.
+	 */
+	inline void RestrictSearch(const std::vector<RoadRegionPatchDesc> &path)
+	{
+		m_road_region_corridor.clear();
+		const uint32_t size_x = GetRoadRegionMapSizeX();
+		const uint32_t size_y = GetRoadRegionMapSizeY();
+		for (const RoadRegionPatchDesc &path_entry : path) {
+			for (uint32_t y = std::max<uint32_t>(path_entry.y, 1) - 1; y <= std::min<uint32_t>(path_entry.y + 1, size_y - 1); y++) {
+				for (uint32_t x = std::max<uint32_t>(path_entry.x, 1) - 1; x <= std::min<uint32_t>(path_entry.x + 1, size_x - 1); x++) {
+					m_road_region_corridor.push_back(GetRoadRegionIndex(RoadRegionDesc(x, y)));
+				}
+			}
 		}
+		std::sort(m_road_region_corridor.begin(), m_road_region_corridor.end());
+		m_road_region_corridor.erase(std::unique(m_road_region_corridor.begin(), m_road_region_corridor.end()), m_road_region_corridor.end());
 	}
 
 	/** return debug report character to identify the transportation type */
@@ -438,6 +465,18 @@ public:
 
 	static Trackdir stChooseRoadTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, bool &path_found, RoadVehPathCache &path_cache)
 	{
+		/* Use the road regions to cut the search short when the destination can't be reached by road at all. The road regions
+		 * over-approximate the reachability of the search, as they don't take one-way roads, road types or owners into account,
+		 * so the search is only restricted when it can't find a path anyway. Otherwise it runs unrestricted, to choose the same
+		 * path as before. */
+		std::vector<RoadRegionPatchDesc> high_level_path;
+		if (YapfRoadVehicleFindRoadRegionPath(v, tile, high_level_path) && high_level_path.empty()) {
+			/* Only search the surroundings of the vehicle. */
+			Tpf pf;
+			pf.RestrictSearch({ GetRoadRegionPatchInfo(tile, GetRoadTramType(v->roadtype)) });
+			return pf.ChooseRoadTrack(v, tile, enterdir, path_found, path_cache);
+		}
+
 		Tpf pf;
 		return pf.ChooseRoadTrack(v, tile, enterdir, path_found, path_cache);
 	}
@@ -41,6 +41,7 @@
 #include "scope.h"
 #include "newgrf_newsignals.h"
 #include "pathfinder/water_regions.h"
+#include "pathfinder/road_regions.h"
 
 #include "table/strings.h"
 #include "table/railtypes.h"
@@ -852,6 +853,7 @@ CommandCost CmdBuildSingleRail(TileIndex tile, DoCommandFlag flags, uint32_t p1,
 
 					if (flags & DC_EXEC) {
 						MakeRoadCrossing(tile, road_owner, tram_owner, _current_company, (track == TRACK_X ? AXIS_Y : AXIS_X), railtype, roadtype_road, roadtype_tram, GetTownIndex(tile));
+						InvalidateRoadRegion(tile);
 						UpdateLevelCrossing(tile, false);
 						MarkDirtyAdjacentLevelCrossingTilesOnAdd(tile, GetCrossingRoadAxis(tile));
 						Company::Get(_current_company)->infrastructure.rail[railtype] += LEVELCROSSING_TRACKBIT_FACTOR;
@@ -980,6 +982,7 @@ CommandCost CmdRemoveSingleRail(TileIndex tile, DoCommandFlag flags, uint32_t p1
 				Company::Get(owner)->infrastructure.rail[GetRailType(tile)] -= LEVELCROSSING_TRACKBIT_FACTOR;
 				DirtyCompanyInfrastructureWindows(owner);
 				MakeRoadNormal(tile, GetCrossingRoadBits(tile), GetRoadTypeRoad(tile), GetRoadTypeTram(tile), GetTownIndex(tile), GetRoadOwner(tile, RTT_ROAD), GetRoadOwner(tile, RTT_TRAM));
+				InvalidateRoadRegion(tile);
 				DeleteNewGRFInspectWindow(GSF_RAILTYPES, tile);
 				UpdateRoadCachedOneWayStatesAroundTile(tile);
 			}
@@ -14,6 +14,7 @@
 #include "viewport_func.h"
 #include "command_func.h"
 #include "pathfinder/yapf/yapf_cache.h"
+#include "pathfinder/road_regions.h"
 #include "depot_base.h"
 #include "newgrf.h"
 #include "autoslope.h"
@@ -705,6 +706,8 @@ static CommandCost RemoveRoad(TileIndex tile, DoCommandFlag flags, RoadBits piec
 					SetCustomBridgeHeadRoadBits(tile, rtt, bits);
 					SetCustomBridgeHeadRoadBits(other_end, rtt, other_bits);
 				}
+				InvalidateRoadRegion(tile);
+				InvalidateRoadRegion(other_end);
 
 				if (bits == ROAD_NONE && other_bits == ROAD_NONE) {
 					/* If the owner of the bridge sells all its road, also move the ownership
@@ -745,6 +748,7 @@ static CommandCost RemoveRoad(TileIndex tile, DoCommandFlag flags, RoadBits piec
 					SetDriveThroughStopDisallowedRoadDirections(tile, DRD_NONE);
 				}
 				SetRoadType(tile, rtt, INVALID_ROADTYPE);
+				InvalidateRoadRegion(tile);
 				MarkTileDirtyByTile(tile);
 				NotifyRoadLayoutChanged(false);
 				if (rtt == RTT_ROAD) {
@@ -804,6 +808,7 @@ static CommandCost RemoveRoad(TileIndex tile, DoCommandFlag flags, RoadBits piec
 
 				if (RoadLayoutChangeNotificationEnabled(false)) NotifyRoadLayoutChangedIfTileNonLeaf(tile, rtt, present | pieces);
 				UpdateCompanyRoadInfrastructure(existing_rt, GetRoadOwner(tile, rtt), -(int)CountBits(pieces));
+				InvalidateRoadRegion(tile);
 
 				if (present == ROAD_NONE) {
 					/* No other road type, just clear tile. */
@@ -855,6 +860,7 @@ static CommandCost RemoveRoad(TileIndex tile, DoCommandFlag flags, RoadBits piec
 
 				Track railtrack = GetCrossingRailTrack(tile);
 				if (RoadLayoutChangeNotificationEnabled(false)) NotifyRoadLayoutChangedIfTileNonLeaf(tile, rtt, GetCrossingRoadBits(tile));
+				InvalidateRoadRegion(tile);
 				if (GetRoadType(tile, OtherRoadTramType(rtt)) == INVALID_ROADTYPE) {
 					TrackBits tracks = GetCrossingRailBits(tile);
 					bool reserved = HasCrossingReservation(tile);
@@ -1168,6 +1174,7 @@ CommandCost CmdBuildRoad(TileIndex tile, DoCommandFlag flags, uint32_t p1, uint3
 				bool reserved = HasBit(GetRailReservationTrackBits(tile), railtrack);
 				MakeRoadCrossing(tile, company, company, GetTileOwner(tile), roaddir, GetRailType(tile), rtt == RTT_ROAD ? rt : INVALID_ROADTYPE, (rtt == RTT_TRAM) ? rt : INVALID_ROADTYPE, p2);
 				SetCrossingReservation(tile, reserved);
+				InvalidateRoadRegion(tile);
 				UpdateLevelCrossing(tile, false);
 				MarkDirtyAdjacentLevelCrossingTilesOnAdd(tile, GetCrossingRoadAxis(tile));
 				if (RoadLayoutChangeNotificationEnabled(true)) NotifyRoadLayoutChangedIfTileNonLeaf(tile, rtt, GetCrossingRoadBits(tile));
@@ -1348,6 +1355,8 @@ CommandCost CmdBuildRoad(TileIndex tile, DoCommandFlag flags, uint32_t p1, uint3
 					} else if (existing & entrance_piece) {
 						SetRoadType(other_end, rtt, rt);
 					}
+					InvalidateRoadRegion(tile);
+					InvalidateRoadRegion(other_end);
 
 					MarkBridgeDirty(tile);
 
@@ -1447,6 +1456,7 @@ do_clear:;
 	cost.AddCost(num_pieces * RoadBuildCost(rt));
 
 	if (flags & DC_EXEC) {
+		InvalidateRoadRegion(tile);
 		switch (GetTileType(tile)) {
 			case MP_ROAD: {
 				RoadTileType rttype = GetRoadTileType(tile);
@@ -1467,6 +1477,7 @@ do_clear:;
 				SetRoadType(tile, rtt, rt);
 				SetRoadOwner(other_end, rtt, company);
 				SetRoadOwner(tile, rtt, company);
+				InvalidateRoadRegion(other_end);
 
 				/* Mark tiles dirty that have been repaved */
 				if (IsBridge(tile)) {
@@ -1774,6 +1785,7 @@ CommandCost CmdBuildRoadDepot(TileIndex tile, DoCommandFlag flags, uint32_t p1,
 		UpdateCompanyRoadInfrastructure(rt, _current_company, ROAD_DEPOT_TRACKBIT_FACTOR);
 
 		MakeRoadDepot(tile, _current_company, dep->index, dir, rt);
+		InvalidateRoadRegion(tile);
 		MarkTileDirtyByTile(tile);
 		MakeDefaultName(dep);
 
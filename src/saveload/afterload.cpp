@@ -682,6 +682,8 @@ bool AfterLoadGame()
 
 	RebuildTownKdtree();
 	RebuildStationKdtree();
+	/* The map was allocated with the size of the savegame after the vehicle index was set up for the previous map. */
+	ResetVehicleHash();
 	UpdateCachedSnowLine();
 	UpdateCachedSnowLineBounds();
 
@@ -54,7 +54,7 @@ ScriptCargoList_StationAccepting::ScriptCargoList_StationAccepting(StationID sta
 {
 	if (!ScriptStation::IsValidStation(station_id)) return;
 
-	Station *st = ::Station::Get(station_id);
+	const Station *st = ::Station::Get(station_id);
 	for (CargoID i = 0; i < NUM_CARGO; i++) {
 		if (HasBit(st->goods[i].status, GoodsEntry::GES_ACCEPTANCE)) this->AddItem(i);
 	}
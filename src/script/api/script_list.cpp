@@ -1043,8 +1043,14 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 			sq_push(vm, i + 3);
 		}
 
-		/* Call the function. Squirrel pops all parameters and pushes the return value. */
-		if (SQ_FAILED(sq_call(vm, nparam + 1, SQTrue, SQTrue))) {
+		/* Call the function. Squirrel pops all parameters and pushes the return value.
+		 * Other scripts running concurrently may take the lock while the valuator runs. */
+		bool failed;
+		{
+			SquirrelConcurrency::VMScope vm_scope;
+			failed = SQ_FAILED(sq_call(vm, nparam + 1, SQTrue, SQTrue));
+		}
+		if (failed) {
 			ScriptObject::SetAllowDoCommand(backup_allow);
 			return SQ_ERROR;
 		}
@@ -58,7 +58,8 @@ template<bool Tfrom, bool Tvia>
 		return -1;
 	}
 
-	const GoodsEntry &ge = ::Station::Get(station_id)->goods[cargo_id];
+	const ::Station *st = ::Station::Get(station_id);
+	const GoodsEntry &ge = st->goods[cargo_id];
 	if (ge.data == nullptr) return 0;
 
 	const StationCargoList &cargo_list = ge.data->cargo;
@@ -109,7 +110,8 @@ template<bool Tfrom, bool Tvia>
 		return -1;
 	}
 
-	const GoodsEntry &ge = ::Station::Get(station_id)->goods[cargo_id];
+	const ::Station *st = ::Station::Get(station_id);
+	const GoodsEntry &ge = st->goods[cargo_id];
 	if (ge.data == nullptr) return 0;
 
 	const FlowStatMap &flows = ge.data->flows;
@@ -149,14 +151,16 @@ template<bool Tfrom, bool Tvia>
 	if (!IsValidStation(station_id)) return false;
 	if (!ScriptCargo::IsValidCargo(cargo_id)) return false;
 
-	return ::Station::Get(station_id)->goods[cargo_id].HasRating();
+	const ::Station *st = ::Station::Get(station_id);
+	return st->goods[cargo_id].HasRating();
 }
 
 /* static */ SQInteger ScriptStation::GetCargoRating(StationID station_id, CargoID cargo_id)
 {
 	if (!ScriptStation::HasCargoRating(station_id, cargo_id)) return -1;
 
-	return ::ToPercent8(::Station::Get(station_id)->goods[cargo_id].rating);
+	const ::Station *st = ::Station::Get(station_id);
+	return ::ToPercent8(st->goods[cargo_id].rating);
 }
 
 /* static */ SQInteger ScriptStation::GetCoverageRadius(ScriptStation::StationType station_type)
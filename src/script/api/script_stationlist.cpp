@@ -124,7 +124,8 @@ CargoCollector::CargoCollector(ScriptStationList_Cargo *parent,
 {
 	if (!ScriptStation::IsValidStation(station_id)) return;
 	if (!ScriptCargo::IsValidCargo(cargo)) return;
-	this->ge = &(Station::Get(station_id)->goods[cargo]);
+	const Station *st = Station::Get(station_id);
+	this->ge = &st->goods[cargo];
 }
 
 CargoCollector::~CargoCollector()
@@ -14,6 +14,7 @@
 #include "../string_func.h"
 #include "script_fatalerror.hpp"
 #include "../settings_type.h"
+#include "../company_func.h"
 #include <sqstdaux.h>
 #include <../squirrel/sqpcheader.h>
 #include <../squirrel/sqvm.h>
@@ -190,7 +191,7 @@ struct ScriptAllocator {
  */
 #include "../safeguards.h"
 
-ScriptAllocator *_squirrel_allocator = nullptr;
+thread_local ScriptAllocator *_squirrel_allocator = nullptr;
 
 /* See 3rdparty/squirrel/squirrel/sqmem.cpp for the default allocator implementation, which this overrides */
 #ifndef SQUIRREL_DEFAULT_ALLOCATOR
@@ -199,6 +200,68 @@ void *sq_vm_realloc(void *p, SQUnsignedInteger oldsize, SQUnsignedInteger size)
 void sq_vm_free(void *p, SQUnsignedInteger size) { _squirrel_allocator->Free(p, size); }
 #endif
 
+/* static */ std::mutex SquirrelConcurrency::lock;
+/* static */ thread_local SquirrelConcurrency::ThreadState *SquirrelConcurrency::thread_state = nullptr;
+
+/** Take the lock, and act as the company of the current thread. */
+/* static */ void SquirrelConcurrency::Acquire()
+{
+	SquirrelConcurrency::lock.lock();
+	_current_company = SquirrelConcurrency::thread_state->company;
+}
+
+SquirrelConcurrency::ThreadScope::ThreadScope(CompanyID company)
+{
+	assert(SquirrelConcurrency::thread_state == nullptr);
+	this->state.company = company;
+	this->state.depth = 1;
+	SquirrelConcurrency::thread_state = &this->state;
+	SquirrelConcurrency::Acquire();
+}
+
+SquirrelConcurrency::ThreadScope::~ThreadScope()
+{
+	assert(this->state.depth == 1);
+	SquirrelConcurrency::lock.unlock();
+	SquirrelConcurrency::thread_state = nullptr;
+}
+
+SquirrelConcurrency::VMScope::VMScope()
+{
+	ThreadState *state = SquirrelConcurrency::thread_state;
+	this->depth = (state != nullptr) ? state->depth : 0;
+	if (this->depth == 0) return;
+
+	state->depth = 0;
+	SquirrelConcurrency::lock.unlock();
+}
+
+SquirrelConcurrency::VMScope::~VMScope()
+{
+	if (this->depth == 0) return;
+
+	SquirrelConcurrency::Acquire();
+	SquirrelConcurrency::thread_state->depth = this->depth;
+}
+
+/**
+ * Hook of the VMs for calls of the native functions added by Squirrel::AddMethod, which takes the lock on entering the outermost one.
+ * @param vm The VM, unused.
+ * @param enter Whether the native function is entered or left.
+ */
+/* static */ void SquirrelConcurrency::NativeCallHook(HSQUIRRELVM, SQBool enter)
+{
+	ThreadState *state = SquirrelConcurrency::thread_state;
+	if (state == nullptr) return;
+
+	if (enter) {
+		if (state->depth++ == 0) SquirrelConcurrency::Acquire();
+	} else {
+		assert(state->depth > 0);
+		if (--state->depth == 0) SquirrelConcurrency::lock.unlock();
+	}
+}
+
 size_t Squirrel::GetAllocatedMemory() const noexcept
 {
 	assert(this->allocator != nullptr);
@@ -215,6 +278,7 @@ void Squirrel::SetMemoryAllocationLimit(size_t limit) noexcept
 
 void Squirrel::CompileError(HSQUIRRELVM vm, const SQChar *desc, const SQChar *source, SQInteger line, SQInteger column)
 {
+	SquirrelConcurrency::NativeScope native_scope;
 	SQChar buf[1024];
 
 	seprintf(buf, lastof(buf), "Error %s:" OTTD_PRINTF64 "/" OTTD_PRINTF64 ": %s", source, line, column, desc);
@@ -250,6 +314,8 @@ void Squirrel::ErrorPrintFunc(HSQUIRRELVM vm, const SQChar *s, ...)
 
 void Squirrel::RunError(HSQUIRRELVM vm, const SQChar *error)
 {
+	SquirrelConcurrency::NativeScope native_scope;
+
 	/* Set the print function to something that prints to stderr */
 	SQPRINTFUNCTION pf = sq_getprintfunc(vm);
 	sq_setprintfunc(vm, &Squirrel::ErrorPrintFunc);
@@ -296,6 +362,9 @@ void Squirrel::PrintFunc(HSQUIRRELVM vm, const SQChar *s, ...)
 	va_end(arglist);
 	strecat(buf, "\n", lastof(buf));
 
+	/* The print builtin of Squirrel does not take the lock */
+	SquirrelConcurrency::NativeScope native_scope;
+
 	/* Check if we have a custom print function */
 	SQPrintFunc *func = ((Squirrel *)sq_getforeignptr(vm))->print_func;
 	if (func == nullptr) {
@@ -319,6 +388,8 @@ void Squirrel::AddMethod(const char *method_name, SQFUNCTION proc, uint nparam,
 	sq_newclosure(this->vm, proc, size != 0 ? 1 : 0);
 	if (nparam != 0) sq_setparamscheck(this->vm, nparam, params);
 	sq_setnativeclosurename(this->vm, -1, method_name);
+	/* Unlike the builtins of Squirrel, methods added here may access the game, so they need the native call hook */
+	sq_setnativeclosurecallhook(this->vm, -1, SQTrue);
 	sq_newslot(this->vm, -3, SQFalse);
 }
 
@@ -406,7 +477,10 @@ bool Squirrel::Resume(int suspend)
 		suspend = -this->overdrawn_ops;
 	}
 
-	this->crashed = !sq_resumecatch(this->vm, suspend);
+	{
+		SquirrelConcurrency::VMScope vm_scope;
+		this->crashed = !sq_resumecatch(this->vm, suspend);
+	}
 	this->overdrawn_ops = -this->vm->_ops_till_suspend;
 	this->allocator->CheckLimit();
 	return this->vm->_suspended != 0;
@@ -448,7 +522,10 @@ bool Squirrel::CallMethod(HSQOBJECT instance, const char *method_name, HSQOBJECT
 	}
 	/* Call the method */
 	sq_pushobject(this->vm, instance);
-	if (SQ_FAILED(sq_call(this->vm, 1, ret == nullptr ? SQFalse : SQTrue, SQTrue, suspend))) return false;
+	{
+		SquirrelConcurrency::VMScope vm_scope;
+		if (SQ_FAILED(sq_call(this->vm, 1, ret == nullptr ? SQFalse : SQTrue, SQTrue, suspend))) return false;
+	}
 	if (ret != nullptr) sq_getstackobj(vm, -1, ret);
 	/* Reset the top, but don't do so for the script main function, as we need
 	 *  a correct stack when resuming. */
@@ -564,6 +641,8 @@ void Squirrel::Initialize()
 	/* Handle runtime-errors ourself, so we can display it nicely */
 	sq_newclosure(this->vm, &Squirrel::_RunError, 0);
 	sq_seterrorhandler(this->vm);
+	/* Serialise native calls when running concurrently with other scripts */
+	sq_setnativecallhook(this->vm, &SquirrelConcurrency::NativeCallHook);
 
 	/* Set the foreign pointer, so we can always find this instance from within the VM */
 	sq_setforeignptr(this->vm, this);
@@ -11,6 +11,9 @@
 #define SQUIRREL_HPP
 
 #include <squirrel.h>
+#include "../company_type.h"
+
+#include <mutex>
 
 /** The type of script we're working with, i.e. for who is it? */
 enum class ScriptType {
@@ -285,7 +288,7 @@ public:
 };
 
 
-extern ScriptAllocator *_squirrel_allocator;
+extern thread_local ScriptAllocator *_squirrel_allocator;
 
 class ScriptAllocatorScope {
 	ScriptAllocator *old_allocator;
@@ -304,4 +307,57 @@ public:
 	}
 };
 
+/**
+ * Serialisation of scripts which run concurrently on several threads, see AI::GameLoop.
+ * A thread which runs scripts concurrently holds the lock, except while a VM executes script code.
+ * Calls of the native functions added by Squirrel::AddMethod, releases of native objects and the
+ * print and error callbacks take the lock again, so everything outside of the VMs, including the
+ * game state, is only accessed by one thread at a time. The builtins of Squirrel run without it.
+ */
+class SquirrelConcurrency {
+	struct ThreadState {
+		CompanyID company; ///< The company to act as while the lock is held.
+		uint depth;        ///< Number of nested holds of the lock, 0 when the lock is not held.
+	};
+
+	static std::mutex lock;
+	static thread_local ThreadState *thread_state; ///< State of the current thread, nullptr when it does not run scripts concurrently.
+
+	static void Acquire();
+
+public:
+	/** Run scripts of a company concurrently on the current thread, holding the lock, for the lifetime of the object. */
+	class ThreadScope {
+		ThreadState state;
+
+	public:
+		ThreadScope(CompanyID company);
+		~ThreadScope();
+	};
+
+	/** Let other threads take the lock while the VM executes script code. */
+	class VMScope {
+		uint depth;
+
+	public:
+		VMScope();
+		~VMScope();
+	};
+
+	/** Hold the lock while calling native code from the VM. */
+	class NativeScope {
+	public:
+		NativeScope() { SquirrelConcurrency::NativeCallHook(nullptr, SQTrue); }
+		~NativeScope() { SquirrelConcurrency::NativeCallHook(nullptr, SQFalse); }
+	};
+
+	static void NativeCallHook(HSQUIRRELVM vm, SQBool enter);
+
+	/**
+	 * Check whether the current thread may access anything outside of its VM.
+	 * @return True when the thread does not run scripts concurrently, or holds the lock.
+	 */
+	static bool IsSerialised() { return thread_state == nullptr || thread_state->depth > 0; }
+};
+
 #endif /* SQUIRREL_HPP */
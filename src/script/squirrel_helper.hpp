@@ -325,6 +325,7 @@ namespace SQConvert {
 	static SQInteger DefSQDestructorCallback(SQUserPointer p, SQInteger)
 	{
 		/* Remove the real instance too */
+		SquirrelConcurrency::NativeScope native_scope;
 		if (p != nullptr) ((Tcls *)p)->Release();
 		return 0;
 	}
@@ -201,12 +201,15 @@ struct GUISettings : public TimeSettings {
 	uint32_t autosave_interval;                             ///< how often should we do autosaves?
 	bool   autosave_realtime;                               ///< autosaves based on real elapsed time (with pause handling)
 	bool   threaded_saves;                                  ///< should we do threaded saves?
+	bool   dedicated_fork_saves;                            ///< should a dedicated server save from a forked process, where supported?
+	bool   parallel_tile_loop;                              ///< should the tile loop check which tiles have nothing to do on worker threads?
 	bool   keep_all_autosave;                               ///< name the autosave in a different way
 	bool   autosave_on_exit;                                ///< save an autosave when you quit the game, but do not ask "Do you really want to quit?"
 	bool   autosave_on_network_disconnect;                  ///< save an autosave when you get disconnected from a network game with an error?
 	uint8_t  date_format_in_default_names;                  ///< should the default savegame/screenshot name use long dates (31th Dec 2008), short dates (31-12-2008) or ISO dates (2008-12-31)
 	byte   max_num_autosaves;                               ///< controls how many autosavegames are made before the game starts to overwrite (names them 0 to max_num_autosaves - 1)
 	byte   max_num_lt_autosaves;                            ///< controls how many long-term autosavegames are made before the game starts to overwrite (names them 0 to max_num_lt_autosaves - 1)
+	byte   autosave_delta_count;                            ///< how many delta autosaves are written against a base save before the next base save (0 = no delta autosaves)
 	uint8_t  savegame_overwrite_confirm;                    ///< Mode for when to warn about overwriting an existing savegame
 	bool   population_in_label;                             ///< show the population of a town in its label?
 	bool   city_in_label;                                   ///< show cities in label?
@@ -414,9 +417,12 @@ struct NetworkSettings {
 	uint16_t      max_init_time;                          ///< maximum amount of time, in game ticks, a client may take to initiate joining
 	uint16_t      max_join_time;                          ///< maximum amount of time, in game ticks, a client may take to sync up during joining
 	uint16_t      max_download_time;                      ///< maximum amount of time, in game ticks, a client may take to download the map
+	uint16_t      map_snapshot_window;                    ///< amount of time, in game ticks, during which joining clients share the same map snapshot
 	uint16_t      max_password_time;                      ///< maximum amount of time, in game ticks, a client may take to enter the password
 	uint16_t      max_lag_time;                           ///< maximum amount of time, in game ticks, a client may be lagging behind the server
 	bool        pause_on_join;                            ///< pause the game when people join
+	bool        server_io_thread;                         ///< do the socket I/O of the clients on a separate network thread
+	bool        server_concurrent_ai;                     ///< run the scripts of the AIs concurrently on the worker threads
 	uint16_t      server_port;                            ///< port the server listens on
 	uint16_t      server_admin_port;                      ///< port the server listens on for the admin network
 	bool        server_admin_chat;                        ///< allow private chat for the server to be distributed to the admin network
@@ -181,6 +181,11 @@ SaveLoadTable GetCargoPacketDesc()
  */
 static void Save_CAPA()
 {
+	/* Packets in vehicles store their age relative to the aging epoch of their list. */
+	for (Vehicle *v : Vehicle::Iterate()) {
+		v->cargo.NormaliseAging();
+	}
+
 	std::vector<SaveLoad> filtered_packet_desc = SlFilterObject(GetCargoPacketDesc());
 	for (CargoPacket *cp : CargoPacket::Iterate()) {
 		SlSetArrayIndex(cp->index);
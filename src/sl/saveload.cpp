@@ -51,6 +51,13 @@
 #ifdef __EMSCRIPTEN__
 #	include <emscripten.h>
 #endif
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#	include <dirent.h>
+#	include <errno.h>
+#	include <fcntl.h>
+#	include <sys/wait.h>
+#	include <unistd.h>
+#endif
 
 #include "../tbtr_template_vehicle.h"
 
@@ -59,13 +66,17 @@
 #include "saveload_internal.h"
 #include "saveload_filter.h"
 #include "saveload_buffer.h"
+#include "saveload_delta.h"
 #include "extended_ver_sl.h"
 
 #include <vector>
 
 #include "../thread.h"
+#include "../worker_thread.h"
 #include <mutex>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 
 #include "../safeguards.h"
 
@@ -148,7 +159,7 @@ void ReadBuffer::AcquireBytes()
 void MemoryDumper::FinaliseBlock()
 {
 	assert(this->saved_buf == nullptr);
-	if (!this->blocks.empty()) {
+	if (!this->blocks.empty() && this->buf != nullptr) {
 		size_t s = MEMORY_CHUNK_SIZE - (this->bufe - this->buf);
 		this->blocks.back().size = s;
 		this->completed_block_bytes += s;
@@ -189,6 +200,60 @@ void MemoryDumper::Flush(SaveFilter *writer)
 	writer->Finish();
 }
 
+/**
+ * Call a function for each contiguous part of a range of the memory dump.
+ * The dump must have been finalised, i.e. no more writes may follow.
+ * @param blocks The blocks of the dump.
+ * @param offset Start of the range.
+ * @param length Length of the range.
+ * @param proc Function to call with each part of the range.
+ */
+template <typename F>
+static void IterateMemoryDumperRange(std::vector<MemoryDumper::BufferInfo> &blocks, size_t offset, size_t length, F proc)
+{
+	for (MemoryDumper::BufferInfo &block : blocks) {
+		if (length == 0) return;
+		if (offset >= block.size) {
+			offset -= block.size;
+			continue;
+		}
+		size_t len = std::min(block.size - offset, length);
+		proc(block.data + offset, len);
+		offset = 0;
+		length -= len;
+	}
+	assert(length == 0);
+}
+
+/**
+ * Copy a range of the memory dump made so far.
+ * @param offset Start of the range.
+ * @param length Length of the range.
+ * @param dest Destination to copy to.
+ */
+void MemoryDumper::CopyRange(size_t offset, size_t length, byte *dest)
+{
+	this->FinaliseBlock();
+	IterateMemoryDumperRange(this->blocks, offset, length, [&](byte *data, size_t len) {
+		memcpy(dest, data, len);
+		dest += len;
+	});
+}
+
+/**
+ * Write a range of the memory dump made so far into a writer.
+ * @param writer The filter we want to use.
+ * @param offset Start of the range.
+ * @param length Length of the range.
+ */
+void MemoryDumper::WriteRange(SaveFilter *writer, size_t offset, size_t length)
+{
+	this->FinaliseBlock();
+	IterateMemoryDumperRange(this->blocks, offset, length, [&](byte *data, size_t len) {
+		writer->Write(data, len);
+	});
+}
+
 void MemoryDumper::StartAutoLength()
 {
 	assert(this->saved_buf == nullptr);
@@ -241,6 +306,8 @@ struct SaveLoadParams {
 
 	bool saveinprogress;                 ///< Whether there is currently a save in progress.
 	SaveModeFlags save_flags;            ///< Save mode flags
+	std::string delta_base_filename;     ///< Name of the base save to write, only set when writing a new base for delta autosaves.
+	std::vector<SavedChunkRange> chunk_ranges; ///< Position of each chunk in the memory dump of the last save.
 };
 
 static SaveLoadParams _sl; ///< Parameters used for/at saveload.
@@ -2307,8 +2374,12 @@ static void SlSaveChunk(const ChunkHandler &ch)
 /** Save all chunks */
 static void SlSaveChunks()
 {
+	_sl.chunk_ranges.clear();
 	for (auto &ch : ChunkHandlers()) {
+		size_t start = _sl.dumper->GetSize();
 		SlSaveChunk(ch);
+		size_t end = _sl.dumper->GetSize();
+		if (end != start) _sl.chunk_ranges.push_back({ ch.id, start, end - start });
 	}
 
 	/* Terminator */
@@ -2851,6 +2922,233 @@ struct LZMASaveFilter : SaveFilter {
 	}
 };
 
+/** Size of the uncompressed blocks of the block-parallel LZMA format. */
+static const size_t LZMA_MT_BLOCK_SIZE = 4 * 1024 * 1024;
+/** Maximum number of blocks of the block-parallel LZMA format which are compressed or decompressed at once. */
+static const size_t LZMA_MT_MAX_PENDING_BLOCKS = 16;
+
+/**
+ * A block of the block-parallel LZMA format.
+ *
+ * Block-parallel LZMA savegames consist of a sequence of blocks, each of which is an independent xz stream.
+ * Each block is preceded by a header of its compressed and uncompressed sizes (both big endian uint32_t).
+ * The sequence is terminated by a header with a compressed size of 0.
+ * As the sizes of each block are known up front, blocks can be compressed and decompressed concurrently.
+ */
+struct LZMAMTBlock {
+	std::vector<byte> input;        ///< Data to compress or decompress.
+	std::vector<byte> output;       ///< Compressed or decompressed data.
+	lzma_ret result = LZMA_OK;      ///< Result of the compression or decompression.
+	bool done = false;              ///< Whether the compression or decompression has completed, protected by LZMAMTBlockQueue::lock.
+};
+
+/** Blocks of the block-parallel LZMA format which are being compressed or decompressed on the general worker pool. */
+struct LZMAMTBlockQueue {
+	std::mutex lock;
+	std::condition_variable done_cv;
+	std::deque<std::unique_ptr<LZMAMTBlock>> blocks; ///< Blocks which have not yet been consumed, in stream order.
+	WorkerTaskGroup tasks{_general_worker_pool};     ///< Outstanding tasks, these refer to the blocks and are waited for before the blocks are destroyed.
+
+	/**
+	 * Queue a block for compression or decompression.
+	 * @param block The block.
+	 * @param func Function to process the block.
+	 */
+	template <typename F>
+	void Submit(std::unique_ptr<LZMAMTBlock> block, F func)
+	{
+		LZMAMTBlock *b = block.get();
+		this->blocks.push_back(std::move(block));
+		this->tasks.Run([this, b, func]() {
+			func(b);
+			this->MarkDone(b);
+		});
+	}
+
+	/**
+	 * Called when a block has been processed.
+	 * @param block The block.
+	 */
+	void MarkDone(LZMAMTBlock *block)
+	{
+		std::lock_guard<std::mutex> lk(this->lock);
+		block->done = true;
+		this->done_cv.notify_all();
+	}
+
+	/**
+	 * Wait for the first block in stream order to be processed.
+	 * @return The first block.
+	 */
+	LZMAMTBlock *WaitFront()
+	{
+		LZMAMTBlock *block = this->blocks.front().get();
+		std::unique_lock<std::mutex> lk(this->lock);
+		this->done_cv.wait(lk, [&]() { return block->done; });
+		return block;
+	}
+};
+
+/** Filter using block-parallel LZMA decompression. */
+struct LZMAMTLoadFilter : LoadFilter {
+	LZMAMTBlockQueue queue;     ///< Blocks which are being decompressed or which have not been fully read yet.
+	size_t read_offset = 0;     ///< Offset of the next byte to read in the first block.
+	bool end_of_stream = false; ///< Whether the terminating block header has been read.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The next filter in this chain.
+	 */
+	LZMAMTLoadFilter(LoadFilter *chain) : LoadFilter(chain)
+	{
+	}
+
+	static void DecompressBlock(LZMAMTBlock *block)
+	{
+		uint64_t memlimit = UINT64_MAX;
+		size_t in_pos = 0;
+		size_t out_pos = 0;
+		block->result = lzma_stream_buffer_decode(&memlimit, 0, nullptr, block->input.data(), &in_pos, block->input.size(), block->output.data(), &out_pos, block->output.size());
+		if (block->result == LZMA_OK && (in_pos != block->input.size() || out_pos != block->output.size())) block->result = LZMA_DATA_ERROR;
+		block->input = {};
+	}
+
+	void ReadFully(byte *buf, size_t size)
+	{
+		while (size > 0) {
+			size_t read = this->chain->Read(buf, size);
+			if (read == 0) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "truncated block-parallel LZMA stream");
+			buf += read;
+			size -= read;
+		}
+	}
+
+	/** Read the next block from the chain and queue it for decompression. */
+	void QueueNextBlock()
+	{
+		byte header[8];
+		this->ReadFully(header, sizeof(header));
+		const uint32_t compressed_size = (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+		const uint32_t uncompressed_size = (header[4] << 24) | (header[5] << 16) | (header[6] << 8) | header[7];
+		if (compressed_size == 0) {
+			this->end_of_stream = true;
+			return;
+		}
+		if (uncompressed_size > LZMA_MT_BLOCK_SIZE || compressed_size > lzma_stream_buffer_bound(LZMA_MT_BLOCK_SIZE)) {
+			SlErrorFmt(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "invalid block-parallel LZMA block size: %u, %u", compressed_size, uncompressed_size);
+		}
+
+		std::unique_ptr<LZMAMTBlock> block = std::make_unique<LZMAMTBlock>();
+		block->input.resize(compressed_size);
+		block->output.resize(uncompressed_size);
+		this->ReadFully(block->input.data(), compressed_size);
+		this->queue.Submit(std::move(block), &LZMAMTLoadFilter::DecompressBlock);
+	}
+
+	size_t Read(byte *buf, size_t size) override
+	{
+		size_t read = 0;
+		while (read < size) {
+			while (!this->end_of_stream && this->queue.blocks.size() < LZMA_MT_MAX_PENDING_BLOCKS) {
+				this->QueueNextBlock();
+			}
+			if (this->queue.blocks.empty()) break;
+
+			LZMAMTBlock *block = this->queue.WaitFront();
+			if (block->result != LZMA_OK) SlErrorFmt(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "liblzma returned error code: %u", block->result);
+
+			size_t to_read = std::min<size_t>(size - read, block->output.size() - this->read_offset);
+			memcpy(buf + read, block->output.data() + this->read_offset, to_read);
+			read += to_read;
+			this->read_offset += to_read;
+			if (this->read_offset == block->output.size()) {
+				this->queue.blocks.pop_front();
+				this->read_offset = 0;
+			}
+		}
+		return read;
+	}
+};
+
+/** Filter using block-parallel LZMA compression. */
+struct LZMAMTSaveFilter : SaveFilter {
+	LZMAMTBlockQueue queue;               ///< Blocks which are being compressed or which have not been written yet.
+	std::unique_ptr<LZMAMTBlock> current; ///< Block which is being filled.
+	lzma_options_lzma options;            ///< LZMA2 options of the requested preset, with a dictionary no larger than a block.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain             The next filter in this chain.
+	 * @param compression_level The requested level of compression.
+	 */
+	LZMAMTSaveFilter(SaveFilter *chain, byte compression_level) : SaveFilter(chain)
+	{
+		if (lzma_lzma_preset(&this->options, compression_level)) SlErrorFmt(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "liblzma has no preset: %u", compression_level);
+
+		/* A dictionary larger than a block only costs memory, up to 674 MiB per block for preset 9, as each block is compressed on its own. */
+		this->options.dict_size = std::min<uint32_t>(this->options.dict_size, LZMA_MT_BLOCK_SIZE);
+	}
+
+	static void CompressBlock(LZMAMTBlock *block, lzma_options_lzma options)
+	{
+		lzma_filter filters[] = {
+			{ LZMA_FILTER_LZMA2, &options },
+			{ LZMA_VLI_UNKNOWN, nullptr },
+		};
+
+		block->output.resize(lzma_stream_buffer_bound(block->input.size()));
+		size_t out_pos = 0;
+		block->result = lzma_stream_buffer_encode(filters, LZMA_CHECK_CRC32, nullptr, block->input.data(), block->input.size(), block->output.data(), &out_pos, block->output.size());
+		block->output.resize(out_pos);
+	}
+
+	/** Wait for the first queued block to be compressed, and write it to the chain. */
+	void WriteFirstBlock()
+	{
+		LZMAMTBlock *block = this->queue.WaitFront();
+		if (block->result != LZMA_OK) SlErrorFmt(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "liblzma returned error code: %u", block->result);
+
+		uint32_t header[2] = { TO_BE32((uint32_t)block->output.size()), TO_BE32((uint32_t)block->input.size()) };
+		this->chain->Write((byte *)header, sizeof(header));
+		this->chain->Write(block->output.data(), block->output.size());
+		this->queue.blocks.pop_front();
+	}
+
+	/** Queue the block which is being filled for compression. */
+	void QueueCurrentBlock()
+	{
+		if (this->queue.blocks.size() >= LZMA_MT_MAX_PENDING_BLOCKS) this->WriteFirstBlock();
+		this->queue.Submit(std::move(this->current), [options = this->options](LZMAMTBlock *block) { CompressBlock(block, options); });
+	}
+
+	void Write(byte *buf, size_t size) override
+	{
+		while (size > 0) {
+			if (this->current == nullptr) {
+				this->current = std::make_unique<LZMAMTBlock>();
+				this->current->input.reserve(LZMA_MT_BLOCK_SIZE);
+			}
+			size_t to_write = std::min<size_t>(size, LZMA_MT_BLOCK_SIZE - this->current->input.size());
+			this->current->input.insert(this->current->input.end(), buf, buf + to_write);
+			buf += to_write;
+			size -= to_write;
+			if (this->current->input.size() == LZMA_MT_BLOCK_SIZE) this->QueueCurrentBlock();
+		}
+	}
+
+	void Finish() override
+	{
+		if (this->current != nullptr && !this->current->input.empty()) this->QueueCurrentBlock();
+		while (!this->queue.blocks.empty()) {
+			this->WriteFirstBlock();
+		}
+
+		uint32_t terminator[2] = { 0, 0 };
+		this->chain->Write((byte *)terminator, sizeof(terminator));
+		this->chain->Finish();
+	}
+};
+
 #endif /* WITH_LIBLZMA */
 
 /********************************************
@@ -2975,6 +3273,7 @@ enum SaveLoadFormatFlags : byte {
 	SLF_NONE             = 0,
 	SLF_NO_THREADED_LOAD = 1 << 0, ///< Unsuitable for threaded loading
 	SLF_REQUIRES_ZSTD    = 1 << 1, ///< Automatic selection requires the zstd flag
+	SLF_NO_AUTO_SELECT   = 1 << 2, ///< Never selected automatically, only when requested by name
 };
 DECLARE_ENUM_AS_BIT_SET(SaveLoadFormatFlags);
 
@@ -2992,6 +3291,8 @@ struct SaveLoadFormat {
 	SaveLoadFormatFlags flags;            ///< flags
 };
 
+static LoadFilter *CreateDeltaLoadFilter(LoadFilter *chain);
+
 /** The different saveload formats known/understood by OpenTTD. */
 static const SaveLoadFormat _saveload_formats[] = {
 #if defined(WITH_LZO)
@@ -3020,6 +3321,14 @@ static const SaveLoadFormat _saveload_formats[] = {
 #else
 	{"lzma",   TO_BE32X('OTTX'), nullptr,                            nullptr,                            0, 0, 0, SLF_NONE},
 #endif
+#if defined(WITH_LIBLZMA)
+	/* The same compression as lzma, but the stream is cut into 4 MB blocks which are compressed and decompressed concurrently
+	 * on the worker thread pool. Saves are slightly larger than lzma at the same level, but the speed scales with the number
+	 * of cores, which makes it suitable for autosaves and map transfers of large games on servers. Never chosen by default. */
+	{"lzmamt", TO_BE32X('OTTM'), CreateLoadFilter<LZMAMTLoadFilter>, CreateSaveFilter<LZMAMTSaveFilter>, 0, 2, 9, SLF_NO_AUTO_SELECT},
+#else
+	{"lzmamt", TO_BE32X('OTTM'), nullptr,                            nullptr,                            0, 0, 0, SLF_NO_AUTO_SELECT},
+#endif
 #if defined(WITH_ZSTD)
 	/* Zstd provides a decent compression rate at a very high compression/decompression speed. Compared to lzma level 2
 	 * zstd saves are about 40% larger (on level 1) but it has about 30x faster compression and 5x decompression making it
@@ -3031,6 +3340,9 @@ static const SaveLoadFormat _saveload_formats[] = {
 #else
 	{"zstd",   TO_BE32X('OTTS'), nullptr,                            nullptr,                            0, 0, 0, SLF_REQUIRES_ZSTD},
 #endif
+	/* Delta autosaves, which only contain the parts that changed since a full autosave. They are written by
+	 * WriteDeltaSave, compressed with one of the formats above, and never selected as a format on their own. */
+	{"delta",  TO_BE32X('OTTI'), CreateDeltaLoadFilter,              nullptr,                            0, 0, 0, SLF_NO_AUTO_SELECT},
 };
 
 /**
@@ -3045,7 +3357,7 @@ static const SaveLoadFormat *GetSavegameFormat(const std::string &full_name, byt
 	const SaveLoadFormat *def = lastof(_saveload_formats);
 
 	/* find default savegame format, the highest one with which files can be written */
-	while (!def->init_write || ((def->flags & SLF_REQUIRES_ZSTD) && !(flags & SMF_ZSTD_OK))) def--;
+	while (!def->init_write || (def->flags & SLF_NO_AUTO_SELECT) || ((def->flags & SLF_REQUIRES_ZSTD) && !(flags & SMF_ZSTD_OK))) def--;
 
 	if (!full_name.empty()) {
 		/* Get the ":..." of the compression level out of the way */
@@ -3081,6 +3393,541 @@ static const SaveLoadFormat *GetSavegameFormat(const std::string &full_name, byt
 	return def;
 }
 
+/*******************************************
+ ********** START OF DELTA SAVE CODE *******
+ *******************************************/
+
+/*
+ * Delta autosaves only store the parts of the uncompressed savegame stream which changed since the last full autosave
+ * (the base save). Each chunk is cut into segments; segments of chunks which kept their length and whose content hash
+ * matches the base save are stored as a reference into the uncompressed stream of the base save, everything else is
+ * stored inline. Loading reconstructs the complete stream, so the chunk handlers are not involved at all.
+ *
+ * Base saves are written to their own files in the autosave directory, outside of the autosave rotation, so they are
+ * never overwritten or renamed while delta saves still refer to them. Each autosave in the rotation, including the
+ * one written together with a new base save, is a delta save. Base saves which are not used by any delta save in the
+ * autosave directory anymore are removed whenever a new base save is written.
+ *
+ * After the usual tag and version, a delta save contains the tag of the format used to compress the rest of the file
+ * and the name of its base save in the autosave directory, so the users of a base save can be found without
+ * decompressing anything. The compressed part contains a list of entries.
+ */
+
+static const uint32_t DELTA_SAVE_TAG = TO_BE32X('OTTI');
+static const size_t DELTA_SAVE_SEGMENT_SIZE = 256 * 1024; ///< Granularity at which chunks are compared with the base save.
+static const char * const DELTA_SAVE_BASE_PREFIX = "delta_base";  ///< Start of the file names of base saves.
+static const char * const DELTA_SAVE_BASE_EXTENSION = ".base";    ///< Extension of base saves, which keeps them out of the savegame list.
+
+/** Types of the entries of a delta save. */
+enum DeltaSaveEntryType : byte {
+	DSET_END    = 0, ///< End of the entry list.
+	DSET_INLINE = 1, ///< Data stored in the delta save itself: length, data.
+	DSET_BASE   = 2, ///< Data referenced from the base save: length, offset in the base save, hash.
+};
+
+/** The current base save. Only accessed while no threaded save is in progress, or from the save thread. */
+static DeltaSaveBase _delta_save_base;
+
+/**
+ * Hash a segment of the uncompressed savegame stream.
+ * @param data The data to hash.
+ * @param length Length of the data.
+ * @return The hash.
+ */
+static uint64_t DeltaSaveHash(const byte *data, size_t length)
+{
+	uint64_t hash = 0x9E3779B97F4A7C15ULL ^ length;
+	auto mix = [&](uint64_t v) {
+		hash ^= v * 0xC2B2AE3D27D4EB4FULL;
+		hash = ROL(hash, 31) * 0x9E3779B97F4A7C15ULL + 0x165667B19E3779F9ULL;
+	};
+	for (; length >= 8; data += 8, length -= 8) {
+		uint64_t v;
+		memcpy(&v, data, sizeof(v));
+		mix(FROM_LE64(v));
+	}
+	for (; length > 0; data++, length--) {
+		mix(*data);
+	}
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+/**
+ * Choose between writing a delta save against the current base save, and writing a new base save first.
+ */
+static void SelectDeltaSaveMode()
+{
+	/* The base save may have been removed by the player. */
+	if (!_delta_save_base.filename.empty() && _delta_save_base.deltas_written < _settings_client.gui.autosave_delta_count &&
+			FioCheckFileExists(_delta_save_base.filename, AUTOSAVE_DIR)) {
+		return;
+	}
+
+	/* Names of older base saves which are still used by delta saves are skipped. */
+	_delta_save_base.filename.clear();
+	for (uint i = 0;; i++) {
+		std::string name = stdstr_fmt("%s%u%s", DELTA_SAVE_BASE_PREFIX, i, DELTA_SAVE_BASE_EXTENSION);
+		if (!FioCheckFileExists(name, AUTOSAVE_DIR)) {
+			_sl.delta_base_filename = std::move(name);
+			break;
+		}
+	}
+	_sl.save_flags |= SMF_DELTA_BASE;
+}
+
+/**
+ * Remember the layout of a memory dump, so following dumps can be written as delta saves against it.
+ * @param base The base save to record the layout in.
+ * @param dumper The memory dump of the base save.
+ * @param ranges The position of each chunk in the memory dump.
+ */
+void RecordDeltaSaveLayout(DeltaSaveBase &base, MemoryDumper *dumper, const std::vector<SavedChunkRange> &ranges)
+{
+	std::vector<byte> buffer(DELTA_SAVE_SEGMENT_SIZE);
+
+	base.chunks.clear();
+	for (const SavedChunkRange &range : ranges) {
+		DeltaSaveBase::Chunk &chunk = base.chunks.emplace_back();
+		chunk.range = range;
+		for (size_t pos = 0; pos < range.length; pos += DELTA_SAVE_SEGMENT_SIZE) {
+			size_t length = std::min(DELTA_SAVE_SEGMENT_SIZE, range.length - pos);
+			dumper->CopyRange(range.offset + pos, length, buffer.data());
+			chunk.hashes.push_back(DeltaSaveHash(buffer.data(), length));
+		}
+	}
+	base.deltas_written = 0;
+}
+
+/**
+ * Write the entries of a delta save of a memory dump, up to and including the end entry.
+ * @param writer The filter to write the entries to.
+ * @param dumper The memory dump to write.
+ * @param ranges The position of each chunk in the memory dump.
+ * @param base The base save to refer to.
+ * @return The number of bytes of the memory dump which are stored inline.
+ */
+size_t WriteDeltaSaveEntries(SaveFilter *writer, MemoryDumper *dumper, const std::vector<SavedChunkRange> &ranges, const DeltaSaveBase &base)
+{
+	auto write_entry = [&](DeltaSaveEntryType type, std::initializer_list<uint64_t> values) {
+		byte entry[1 + 3 * 8];
+		byte *p = entry;
+		*p++ = type;
+		for (uint64_t v : values) {
+			for (int shift = 56; shift >= 0; shift -= 8) *p++ = GB(v, shift, 8);
+		}
+		writer->Write(entry, p - entry);
+	};
+
+	size_t inline_start = 0;
+	size_t inline_bytes = 0;
+	auto write_inline = [&](size_t end) {
+		if (end == inline_start) return;
+		write_entry(DSET_INLINE, { end - inline_start });
+		dumper->WriteRange(writer, inline_start, end - inline_start);
+		inline_bytes += end - inline_start;
+	};
+
+	std::vector<byte> buffer(DELTA_SAVE_SEGMENT_SIZE);
+	for (const SavedChunkRange &range : ranges) {
+		auto base_chunk = std::find_if(base.chunks.begin(), base.chunks.end(), [&](const DeltaSaveBase::Chunk &chunk) {
+			return chunk.range.id == range.id;
+		});
+		if (base_chunk == base.chunks.end() || base_chunk->range.length != range.length) continue;
+
+		for (size_t i = 0; i < base_chunk->hashes.size(); i++) {
+			size_t pos = i * DELTA_SAVE_SEGMENT_SIZE;
+			size_t length = std::min(DELTA_SAVE_SEGMENT_SIZE, range.length - pos);
+			dumper->CopyRange(range.offset + pos, length, buffer.data());
+			uint64_t hash = DeltaSaveHash(buffer.data(), length);
+			if (hash != base_chunk->hashes[i]) continue;
+
+			write_inline(range.offset + pos);
+			write_entry(DSET_BASE, { length, base_chunk->range.offset + pos, hash });
+			inline_start = range.offset + pos + length;
+		}
+	}
+	write_inline(dumper->GetSize());
+	write_entry(DSET_END, {});
+	return inline_bytes;
+}
+
+/**
+ * Write the memory dump as a normal savegame.
+ * @param fmt The format to compress the savegame with.
+ * @param compression The compression level.
+ */
+static void WriteFullSave(const SaveLoadFormat *fmt, byte compression)
+{
+	uint32_t hdr[2] = { fmt->tag, TO_BE32((uint32_t) (SAVEGAME_VERSION | SAVEGAME_VERSION_EXT) << 16) };
+	_sl.sf->Write((byte*)hdr, sizeof(hdr));
+
+	_sl.sf = fmt->init_write(_sl.sf, compression);
+	_sl.dumper->Flush(_sl.sf);
+}
+
+/**
+ * Write the memory dump as a new base save, next to the autosave being written, and make it the current base save.
+ * @param fmt The format to compress the base save with.
+ * @param compression The compression level.
+ */
+static void WriteDeltaSaveBase(const SaveLoadFormat *fmt, byte compression)
+{
+	FILE *fh = FioFOpenFile(_sl.delta_base_filename, "wb", AUTOSAVE_DIR);
+	if (fh == nullptr) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
+
+	/* The save filter of the autosave itself is put aside, as the delta save is written to it afterwards. */
+	SaveFilter *autosave = _sl.sf;
+	_sl.sf = new FileWriter(fh);
+	try {
+		WriteFullSave(fmt, compression);
+	} catch (...) {
+		delete _sl.sf;
+		_sl.sf = autosave;
+		throw;
+	}
+	delete _sl.sf;
+	_sl.sf = autosave;
+
+	RecordDeltaSaveLayout(_delta_save_base, _sl.dumper, _sl.chunk_ranges);
+	_delta_save_base.filename = _sl.delta_base_filename;
+}
+
+/**
+ * Write the memory dump as delta save against the current base save.
+ * @param fmt The format to compress the delta save with.
+ * @param compression The compression level.
+ */
+static void WriteDeltaSave(const SaveLoadFormat *fmt, byte compression)
+{
+	std::string base_name = _delta_save_base.filename;
+	uint32_t hdr[3] = { DELTA_SAVE_TAG, TO_BE32((uint32_t) (SAVEGAME_VERSION | SAVEGAME_VERSION_EXT) << 16), fmt->tag };
+	_sl.sf->Write((byte*)hdr, sizeof(hdr));
+	byte name_length[2] = { (byte)GB(base_name.size(), 8, 8), (byte)GB(base_name.size(), 0, 8) };
+	_sl.sf->Write(name_length, sizeof(name_length));
+	_sl.sf->Write((byte *)base_name.data(), base_name.size());
+
+	_sl.sf = fmt->init_write(_sl.sf, compression);
+	const size_t inline_bytes = WriteDeltaSaveEntries(_sl.sf, _sl.dumper, _sl.chunk_ranges, _delta_save_base);
+	_sl.sf->Finish();
+
+	DEBUG(sl, 2, "Delta save against '%s': " PRINTF_SIZE " of " PRINTF_SIZE " bytes stored", base_name.c_str(), inline_bytes, _sl.dumper->GetSize());
+}
+
+/**
+ * Read the name of the base save from the header of a delta save.
+ * @param file The file to read from, positioned at its start.
+ * @param[out] base_name The name of the base save.
+ * @return Whether the file is a delta save.
+ */
+static bool ReadDeltaSaveBaseName(FILE *file, std::string &base_name)
+{
+	uint32_t hdr[3];
+	byte name_length[2];
+	if (fread(hdr, sizeof(hdr), 1, file) != 1 || hdr[0] != DELTA_SAVE_TAG) return false;
+	if (fread(name_length, sizeof(name_length), 1, file) != 1) return false;
+	base_name.resize((name_length[0] << 8) | name_length[1]);
+	return fread(base_name.data(), 1, base_name.size(), file) == base_name.size();
+}
+
+/**
+ * Remove the base saves which are neither the current base save, nor used by any delta save in the autosave directory.
+ * Delta saves can only load from the autosave directory, so other base saves can't be needed anymore.
+ */
+static void RemoveUnusedDeltaSaveBases()
+{
+	const std::string dir = FioFindDirectory(AUTOSAVE_DIR);
+	DIR *d = ttd_opendir(dir.c_str());
+	if (d == nullptr) return;
+
+	std::vector<std::string> bases;
+	std::vector<std::string> used;
+	struct dirent *dirent;
+	while ((dirent = readdir(d)) != nullptr) {
+		std::string name = FS2OTTD(dirent->d_name);
+		if (StrStartsWith(name, DELTA_SAVE_BASE_PREFIX) && StrEndsWith(name, DELTA_SAVE_BASE_EXTENSION)) {
+			bases.push_back(std::move(name));
+			continue;
+		}
+
+		FILE *f = FioFOpenFile(dir + name, "rb", NO_DIRECTORY);
+		if (f == nullptr) continue;
+		std::string base_name;
+		if (ReadDeltaSaveBaseName(f, base_name)) used.push_back(std::move(base_name));
+		fclose(f);
+	}
+	closedir(d);
+
+	for (const std::string &name : bases) {
+		if (name == _delta_save_base.filename || std::find(used.begin(), used.end(), name) != used.end()) continue;
+		DEBUG(sl, 2, "Removing unused delta save base '%s'", name.c_str());
+		std::remove((dir + name).c_str());
+	}
+}
+
+/**
+ * Read exactly the given number of bytes from a filter.
+ * @param reader The filter to read from.
+ * @param buf The buffer to read into.
+ * @param size The number of bytes to read.
+ */
+static void DeltaSaveReadExact(LoadFilter *reader, byte *buf, size_t size)
+{
+	while (size > 0) {
+		size_t read = reader->Read(buf, size);
+		if (read == 0) SlErrorCorrupt("Unexpected end of delta savegame");
+		buf += read;
+		size -= read;
+	}
+}
+
+/**
+ * Find the format of a (non-delta) savegame.
+ * @param tag The tag of the format.
+ * @return The format, or nullptr if it can not be loaded.
+ */
+static const SaveLoadFormat *GetDeltaSaveInnerFormat(uint32_t tag)
+{
+	for (const SaveLoadFormat &fmt : _saveload_formats) {
+		if (fmt.tag == tag && fmt.tag != DELTA_SAVE_TAG && fmt.init_load != nullptr) return &fmt;
+	}
+	return nullptr;
+}
+
+/**
+ * Open the base save of a delta save.
+ * @param base_name Name of the base save in the autosave directory.
+ * @return The uncompressed stream of the base save.
+ */
+static LoadFilter *OpenDeltaSaveBase(const std::string &base_name)
+{
+	FILE *fh = FioFOpenFile(base_name, "rb", AUTOSAVE_DIR);
+	if (fh == nullptr) SlErrorFmt(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE, "Base savegame '%s' of delta savegame not found", base_name.c_str());
+	LoadFilter *reader = new FileReader(fh);
+
+	uint32_t hdr[2];
+	if (reader->Read((byte*)hdr, sizeof(hdr)) != sizeof(hdr)) {
+		delete reader;
+		SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+	}
+	const SaveLoadFormat *fmt = GetDeltaSaveInnerFormat(hdr[0]);
+	if (fmt == nullptr) {
+		delete reader;
+		SlErrorFmt(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "Base savegame '%s' of delta savegame has an unsupported format", base_name.c_str());
+	}
+	return fmt->init_load(reader);
+}
+
+/** Filter reconstructing the uncompressed savegame stream of a delta save, from the delta save and its base save. */
+struct DeltaLoadFilter : LoadFilter {
+	std::string base_name;           ///< Name of the base save.
+	LoadFilter *base;                ///< Uncompressed stream of the base save.
+	size_t base_pos = 0;             ///< Position in the uncompressed stream of the base save.
+	DeltaSaveEntryType type = DSET_INLINE; ///< Type of the current entry.
+	size_t remaining = 0;            ///< Bytes remaining of the current entry.
+	std::vector<byte> segment;       ///< Verified data of the current base save entry.
+	size_t segment_pos = 0;          ///< Read position in #segment.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The uncompressed entry stream of the delta save.
+	 * @param base The uncompressed stream of the base save.
+	 * @param base_name Name of the base save.
+	 */
+	DeltaLoadFilter(LoadFilter *chain, LoadFilter *base, const std::string &base_name) : LoadFilter(chain), base_name(base_name), base(base), segment(DELTA_SAVE_SEGMENT_SIZE)
+	{
+	}
+
+	/** Clean everything up. */
+	~DeltaLoadFilter()
+	{
+		delete this->base;
+	}
+
+	/**
+	 * Read a big endian 64 bit value from the entry stream.
+	 * @return The value.
+	 */
+	uint64_t ReadUint64()
+	{
+		byte buf[8];
+		DeltaSaveReadExact(this->chain, buf, sizeof(buf));
+		uint64_t v = 0;
+		for (byte b : buf) v = (v << 8) | b;
+		return v;
+	}
+
+	/**
+	 * Start reading the next entry.
+	 * @return False when there are no more entries.
+	 */
+	bool NextEntry()
+	{
+		if (this->type == DSET_END) return false;
+
+		byte type;
+		DeltaSaveReadExact(this->chain, &type, 1);
+		switch (type) {
+			case DSET_END:
+				this->type = DSET_END;
+				return false;
+
+			case DSET_INLINE:
+				this->type = DSET_INLINE;
+				this->remaining = this->ReadUint64();
+				return true;
+
+			case DSET_BASE: {
+				uint64_t length = this->ReadUint64();
+				uint64_t offset = this->ReadUint64();
+				uint64_t hash = this->ReadUint64();
+				if (length > DELTA_SAVE_SEGMENT_SIZE || offset < this->base_pos) SlErrorCorrupt("Invalid base savegame reference in delta savegame");
+
+				/* References are in increasing order, so the base save only has to be streamed once. */
+				while (this->base_pos < offset) {
+					size_t skip = std::min<size_t>(offset - this->base_pos, this->segment.size());
+					DeltaSaveReadExact(this->base, this->segment.data(), skip);
+					this->base_pos += skip;
+				}
+				DeltaSaveReadExact(this->base, this->segment.data(), length);
+				this->base_pos += length;
+				if (DeltaSaveHash(this->segment.data(), length) != hash) {
+					SlErrorFmt(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "Base savegame '%s' has changed since the delta savegame was written", this->base_name.c_str());
+				}
+
+				this->type = DSET_BASE;
+				this->remaining = length;
+				this->segment_pos = 0;
+				return true;
+			}
+
+			default:
+				SlErrorCorrupt("Invalid entry in delta savegame");
+		}
+	}
+
+	size_t Read(byte *buf, size_t size) override
+	{
+		size_t total = 0;
+		while (total < size) {
+			if (this->remaining == 0 && !this->NextEntry()) break;
+
+			size_t length = std::min(size - total, this->remaining);
+			if (this->type == DSET_INLINE) {
+				DeltaSaveReadExact(this->chain, buf + total, length);
+			} else {
+				memcpy(buf + total, this->segment.data() + this->segment_pos, length);
+				this->segment_pos += length;
+			}
+			this->remaining -= length;
+			total += length;
+		}
+		return total;
+	}
+};
+
+/**
+ * Create a filter reconstructing the uncompressed savegame stream of a delta save.
+ * @param entries The uncompressed entry stream of the delta save.
+ * @param base The uncompressed stream of the base save.
+ * @param base_name Name of the base save, for error messages.
+ * @return The filter, which owns both streams.
+ */
+LoadFilter *CreateDeltaSaveEntryReader(LoadFilter *entries, LoadFilter *base, const std::string &base_name)
+{
+	return new DeltaLoadFilter(entries, base, base_name);
+}
+
+/**
+ * Instantiator for the delta save load filter.
+ * @param chain The file to read the delta save from, positioned after the savegame header.
+ * @return The filter.
+ */
+static LoadFilter *CreateDeltaLoadFilter(LoadFilter *chain)
+{
+	uint32_t tag;
+	if (chain->Read((byte*)&tag, sizeof(tag)) != sizeof(tag)) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+
+	const SaveLoadFormat *fmt = GetDeltaSaveInnerFormat(tag);
+	if (fmt == nullptr) SlErrorCorrupt("Delta savegame has an unsupported format");
+
+	byte name_length[2];
+	DeltaSaveReadExact(chain, name_length, sizeof(name_length));
+	std::string base_name;
+	base_name.resize((name_length[0] << 8) | name_length[1]);
+	DeltaSaveReadExact(chain, (byte *)base_name.data(), base_name.size());
+	if (base_name.find_first_of("/\\") != std::string::npos) SlErrorCorrupt("Invalid base savegame name in delta savegame");
+
+	LoadFilter *base = OpenDeltaSaveBase(base_name);
+	LoadFilter *entries;
+	try {
+		entries = fmt->init_load(chain);
+	} catch (...) {
+		delete base;
+		throw;
+	}
+	return CreateDeltaSaveEntryReader(entries, base, base_name);
+}
+
+/**
+ * Convert a delta autosave into a normal savegame, which no longer depends on its base save.
+ * @param input Name of the delta save in the autosave directory.
+ * @param output Name of the savegame to write in the save directory.
+ * @param[out] error The error message, when converting failed.
+ * @return Whether the conversion succeeded.
+ */
+bool ConsolidateDeltaSave(const std::string &input, const std::string &output, std::string &error)
+{
+	WaitTillSaved();
+
+	/* Errors must be reported as a save error, and not touch the state of the running game. */
+	const SaveLoadAction old_action = _sl.action;
+	_sl.action = SLA_SAVE;
+	auto guard = scope_guard([&]() {
+		_sl.action = old_action;
+	});
+
+	LoadFilter *reader = nullptr;
+	SaveFilter *writer = nullptr;
+	bool ok = true;
+	try {
+		FILE *in = FioFOpenFile(input, "rb", AUTOSAVE_DIR);
+		if (in == nullptr) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+		reader = new FileReader(in);
+
+		uint32_t hdr[2];
+		if (reader->Read((byte*)hdr, sizeof(hdr)) != sizeof(hdr)) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+		if (hdr[0] != DELTA_SAVE_TAG) SlErrorFmt(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "'%s' is not a delta savegame", input.c_str());
+		reader = CreateDeltaLoadFilter(reader);
+
+		FILE *out = FioFOpenFile(output, "wb", SAVE_DIR);
+		if (out == nullptr) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
+		writer = new FileWriter(out);
+
+		byte compression;
+		const SaveLoadFormat *fmt = GetSavegameFormat(_savegame_format, &compression, SMF_NONE);
+		hdr[0] = fmt->tag;
+		writer->Write((byte*)hdr, sizeof(hdr));
+		writer = fmt->init_write(writer, compression);
+
+		std::vector<byte> buffer(MEMORY_CHUNK_SIZE);
+		size_t length;
+		while ((length = reader->Read(buffer.data(), buffer.size())) != 0) {
+			writer->Write(buffer.data(), length);
+		}
+		writer->Finish();
+	} catch (...) {
+		error = strip_leading_colours(GetSaveLoadErrorString());
+		ok = false;
+	}
+
+	delete reader;
+	delete writer;
+	return ok;
+}
+
 /* actual loader/saver function */
 void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settings);
 extern bool AfterLoadGame();
@@ -3162,6 +4009,53 @@ static void SaveFileError()
 	SaveFileDone();
 }
 
+/**
+ * Compress the memory dump of the game and write it to the save filter.
+ */
+static void WriteMemoryDump()
+{
+	byte compression;
+	const SaveLoadFormat *fmt = GetSavegameFormat(_savegame_format, &compression, _sl.save_flags);
+
+	DEBUG(sl, 3, "Using compression format: %s, level: %u", fmt->name, compression);
+
+	/* We have written our stuff to memory, now write it to file! */
+	if (_sl.save_flags & SMF_DELTA) {
+		if (_sl.save_flags & SMF_DELTA_BASE) WriteDeltaSaveBase(fmt, compression);
+		WriteDeltaSave(fmt, compression);
+		/* Only delta saves which have been written completely count towards the next base save. */
+		_delta_save_base.deltas_written++;
+		if (_sl.save_flags & SMF_DELTA_BASE) RemoveUnusedDeltaSaveBases();
+	} else {
+		WriteFullSave(fmt, compression);
+	}
+}
+
+/**
+ * Clean up after writing the savegame failed, and report the error.
+ * @param threaded Whether the savegame was written on the save thread.
+ */
+static void SaveFileToDiskFailed(bool threaded)
+{
+	ClearSaveLoadState();
+
+	AsyncSaveFinishProc asfp = SaveFileDone;
+
+	/* We don't want to shout when saving is just
+	 * cancelled due to a client disconnecting. */
+	if (_sl.error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
+		/* Skip the "colour" character */
+		DEBUG(sl, 0, "%s", strip_leading_colours(GetSaveLoadErrorString()));
+		asfp = SaveFileError;
+	}
+
+	if (threaded) {
+		SetAsyncSaveFinish(asfp);
+	} else {
+		asfp();
+	}
+}
+
 /**
  * We have written the whole game into memory, _memory_savegame, now find
  * and appropriate compressor and start writing to file.
@@ -3169,17 +4063,7 @@ static void SaveFileError()
 static SaveOrLoadResult SaveFileToDisk(bool threaded)
 {
 	try {
-		byte compression;
-		const SaveLoadFormat *fmt = GetSavegameFormat(_savegame_format, &compression, _sl.save_flags);
-
-		DEBUG(sl, 3, "Using compression format: %s, level: %u", fmt->name, compression);
-
-		/* We have written our stuff to memory, now write it to file! */
-		uint32_t hdr[2] = { fmt->tag, TO_BE32((uint32_t) (SAVEGAME_VERSION | SAVEGAME_VERSION_EXT) << 16) };
-		_sl.sf->Write((byte*)hdr, sizeof(hdr));
-
-		_sl.sf = fmt->init_write(_sl.sf, compression);
-		_sl.dumper->Flush(_sl.sf);
+		WriteMemoryDump();
 
 		ClearSaveLoadState();
 
@@ -3187,27 +4071,245 @@ static SaveOrLoadResult SaveFileToDisk(bool threaded)
 
 		return SL_OK;
 	} catch (...) {
-		ClearSaveLoadState();
+		SaveFileToDiskFailed(threaded);
+		return SL_ERROR;
+	}
+}
 
-		AsyncSaveFinishProc asfp = SaveFileDone;
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+/*
+ * Forked saves: a dedicated server can serialise the game from a child process created by fork(), which works on a
+ * copy-on-write snapshot of the memory of the server. The child writes the compressed savegame into a pipe, which is
+ * read by the save thread of the server and passed on to the actual writer (a file or a client joining the server).
+ * This way the game loop is not paused at all while the game state is serialised.
+ *
+ * Only the thread calling fork() exists in the child, so locks held by other threads of the server at that moment
+ * stay locked there forever. The child therefore only takes locks which are made safe around the fork:
+ *  - The locks of the worker pool are held across the fork by WorkerThreadPool::PrepareFork(), and the child drops
+ *    its workers, so the compression runs on the thread of the child.
+ *  - The debug output mutexes are only taken for the debug socket and the remote console, which
+ *    DebugDetachForkedChild() detaches first.
+ *  - The packet pool mutex of the network thread is never taken, the child writes to a pipe and creates no packets.
+ *  - The lock of concurrently running scripts is free, saving happens between the script steps of the game loop.
+ *  - Link graph job threads take no locks, and the save thread of the parent only locks the state of the save.
+ * The child also closes every file descriptor it inherited besides its pipes, so the sockets of clients which the
+ * server disconnects while the child is running are really closed.
+ */
 
-		/* We don't want to shout when saving is just
-		 * cancelled due to a client disconnecting. */
-		if (_sl.error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
-			/* Skip the "colour" character */
-			DEBUG(sl, 0, "%s", strip_leading_colours(GetSaveLoadErrorString()));
-			asfp = SaveFileError;
+/**
+ * Create a pipe whose file descriptors are not inherited by executed programs.
+ * @param fds The read and write ends of the pipe.
+ * @return Whether the pipe has been created.
+ */
+static bool CreateForkedSavePipe(int fds[2])
+{
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+	return pipe2(fds, O_CLOEXEC) == 0;
+#else
+	if (pipe(fds) != 0) return false;
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+	return true;
+#endif
+}
+
+/**
+ * Close all file descriptors inherited by the child process of a forked save, except for the standard streams and its pipes.
+ * @param data_fd The file descriptor to write the savegame to.
+ * @param error_fd The file descriptor to write the error message to.
+ */
+static void CloseForkedSaveInheritedFileDescriptors(int data_fd, int error_fd)
+{
+	auto close_inherited = [&](int fd) {
+		if (fd > STDERR_FILENO && fd != data_fd && fd != error_fd) close(fd);
+	};
+
+#if defined(__linux__)
+	/* Only visit the file descriptors which are open, the limit of open files can be very large. */
+	DIR *dir = opendir("/proc/self/fd");
+	if (dir != nullptr) {
+		std::vector<int> fds;
+		while (const struct dirent *entry = readdir(dir)) {
+			if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+			int fd = atoi(entry->d_name);
+			if (fd != dirfd(dir)) fds.push_back(fd);
 		}
+		closedir(dir);
+		for (int fd : fds) close_inherited(fd);
+		return;
+	}
+#endif
 
-		if (threaded) {
-			SetAsyncSaveFinish(asfp);
-		} else {
-			asfp();
+	const long max_fd = sysconf(_SC_OPEN_MAX);
+	for (long fd = 0; fd < (max_fd > 0 ? max_fd : 1024); fd++) close_inherited((int)fd);
+}
+
+/** Save filter writing to a file descriptor, used in the child process of a forked save. */
+struct ForkedSaveWriter : SaveFilter {
+	int fd; ///< The file descriptor to write to.
+
+	/**
+	 * Create the writer.
+	 * @param fd The file descriptor to write to.
+	 */
+	ForkedSaveWriter(int fd) : SaveFilter(nullptr), fd(fd)
+	{
+	}
+
+	void Write(byte *buf, size_t size) override
+	{
+		while (size > 0) {
+			ssize_t written = write(this->fd, buf, size);
+			if (written < 0 && errno == EINTR) continue;
+			if (written <= 0) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
+			buf += written;
+			size -= written;
+		}
+	}
+};
+
+/**
+ * Serialise the game in the child process of a forked save, and exit.
+ * @param data_fd The file descriptor to write the savegame to.
+ * @param error_fd The file descriptor to write the error message to, if saving fails.
+ */
+static void NORETURN ForkedSaveChild(int data_fd, int error_fd)
+{
+	/* Only this thread exists in the child, and the file descriptors of the parent must be left alone. */
+	DebugDetachForkedChild();
+	CloseForkedSaveInheritedFileDescriptors(data_fd, error_fd);
+
+	int status = 0;
+	try {
+		_sl.dumper = new MemoryDumper();
+		_sl.sf = new ForkedSaveWriter(data_fd);
+
+		SaveViewportBeforeSaveGame();
+		SlSaveChunks();
+		WriteMemoryDump();
+	} catch (...) {
+		uint32_t error_str = _sl.error_str;
+		if (write(error_fd, &error_str, sizeof(error_str)) == sizeof(error_str)) {
+			[[maybe_unused]] ssize_t written = write(error_fd, _sl.extra_msg.data(), _sl.extra_msg.size());
+		}
+		status = 1;
+	}
+
+	/* Do not run any destructors or exit handlers, they belong to the parent. */
+	_exit(status);
+}
+
+/**
+ * Pass the savegame written by the child process of a forked save on to the save filter, and wait for the child to finish.
+ * @param pid The process ID of the child.
+ * @param data_fd The file descriptor to read the savegame from.
+ * @param error_fd The file descriptor to read the error message from.
+ * @param threaded Whether this runs on the save thread.
+ * @return Return the result of the action. #SL_OK or #SL_ERROR
+ */
+static SaveOrLoadResult ForkedSaveCollect(pid_t pid, int data_fd, int error_fd, bool threaded)
+{
+	/* Always reap the child, also when writing fails, e.g. because the joining client disconnected. */
+	auto finish_child = [&]() -> bool {
+		if (data_fd >= 0) close(data_fd);
+		data_fd = -1;
+		int status;
+		while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+		return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	};
+	auto guard = scope_guard([&]() {
+		if (data_fd >= 0) finish_child();
+		close(error_fd);
+	});
+
+	try {
+		std::vector<byte> buffer(MEMORY_CHUNK_SIZE);
+		for (;;) {
+			ssize_t length = read(data_fd, buffer.data(), buffer.size());
+			if (length < 0 && errno == EINTR) continue;
+			if (length <= 0) break;
+			_sl.sf->Write(buffer.data(), length);
 		}
+
+		if (!finish_child()) {
+			uint32_t error_str;
+			if (read(error_fd, &error_str, sizeof(error_str)) != sizeof(error_str)) {
+				SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "Save process terminated unexpectedly");
+			}
+			std::string extra_msg;
+			char msg[256];
+			ssize_t length;
+			while ((length = read(error_fd, msg, sizeof(msg))) > 0) extra_msg.append(msg, length);
+			SlError(error_str, std::move(extra_msg));
+		}
+		_sl.sf->Finish();
+
+		ClearSaveLoadState();
+
+		if (threaded) SetAsyncSaveFinish(SaveFileDone);
+
+		return SL_OK;
+	} catch (...) {
+		SaveFileToDiskFailed(threaded);
 		return SL_ERROR;
 	}
 }
 
+/**
+ * Try to save the game from a forked child process.
+ * @return Whether the save has been started, when false the game has to be saved in the normal way.
+ */
+static bool DoForkedSave()
+{
+	if (!_network_dedicated || !_settings_client.gui.dedicated_fork_saves) return false;
+
+	/* The layout of the base save of delta autosaves has to be known in this process. */
+	if (_sl.save_flags & (SMF_DELTA | SMF_DELTA_BASE)) return false;
+
+	int data_pipe[2];
+	int error_pipe[2];
+	if (!CreateForkedSavePipe(data_pipe)) return false;
+	if (!CreateForkedSavePipe(error_pipe)) {
+		close(data_pipe[0]);
+		close(data_pipe[1]);
+		return false;
+	}
+
+	_general_worker_pool.PrepareFork();
+	pid_t pid = fork();
+	if (pid == 0) {
+		_general_worker_pool.ChildAfterFork();
+		ForkedSaveChild(data_pipe[1], error_pipe[1]);
+	}
+	_general_worker_pool.ParentAfterFork();
+
+	close(data_pipe[1]);
+	close(error_pipe[1]);
+	if (pid < 0) {
+		DEBUG(sl, 1, "Cannot fork savegame process, reverting to normal saving...");
+		close(data_pipe[0]);
+		close(error_pipe[0]);
+		return false;
+	}
+
+	DEBUG(sl, 2, "Saving from forked process %d", (int)pid);
+	SaveFileStart();
+	const int data_fd = data_pipe[0];
+	const int error_fd = error_pipe[0];
+	if (!StartNewThread(&_save_thread, "ottd:savegame", [=]() { ForkedSaveCollect(pid, data_fd, error_fd, true); })) {
+		DEBUG(sl, 1, "Cannot create savegame thread, collecting forked save in the main thread...");
+		ForkedSaveCollect(pid, data_fd, error_fd, false);
+		SaveFileDone();
+	}
+	return true;
+}
+#else
+static bool DoForkedSave()
+{
+	return false;
+}
+#endif /* defined(UNIX) && !defined(__EMSCRIPTEN__) */
+
 void WaitTillSaved()
 {
 	if (!_save_thread.joinable()) return;
@@ -3230,12 +4332,15 @@ static SaveOrLoadResult DoSave(SaveFilter *writer, bool threaded)
 {
 	assert(!_sl.saveinprogress);
 
-	_sl.dumper = new MemoryDumper();
 	_sl.sf = writer;
 
 	_sl_version = SAVEGAME_VERSION;
 	SlXvSetCurrentState();
 
+	if (threaded && DoForkedSave()) return SL_OK;
+
+	_sl.dumper = new MemoryDumper();
+
 	SaveViewportBeforeSaveGame();
 	SlSaveChunks();
 
@@ -3392,9 +4497,10 @@ struct ThreadedLoadFilter : LoadFilter {
  * Actually perform the loading of a "non-old" savegame.
  * @param reader     The filter to read the savegame from.
  * @param load_check Whether to perform the checking ("preview") or actually load the game.
+ * @param allow_delta Whether the savegame may be a delta save, i.e. it is a local file in the autosave directory.
  * @return Return the result of the action. #SL_OK or #SL_REINIT ("unload" the game)
  */
-static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
+static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check, bool allow_delta)
 {
 	_sl.lf = reader;
 
@@ -3481,6 +4587,11 @@ static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 		fmt++;
 	}
 
+	/* A delta save refers to a base save in the local autosave directory, which is unrelated to savegames from anywhere else. */
+	if (fmt->tag == DELTA_SAVE_TAG && !allow_delta) {
+		SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "Delta savegames can only be loaded from the autosave directory.");
+	}
+
 	/* loader for this savegame type is not implemented? */
 	if (fmt->init_load == nullptr) {
 		char err_str[64];
@@ -3636,7 +4747,7 @@ SaveOrLoadResult LoadWithFilter(LoadFilter *reader)
 {
 	try {
 		_sl.action = SLA_LOAD;
-		return DoLoad(reader, false);
+		return DoLoad(reader, false, false);
 	} catch (...) {
 		ClearSaveLoadState();
 
@@ -3647,6 +4758,26 @@ SaveOrLoadResult LoadWithFilter(LoadFilter *reader)
 	}
 }
 
+/**
+ * Check whether a savegame file is in an autosave directory.
+ * @param filename The name of the savegame.
+ * @param sb The sub directory the savegame was opened in.
+ * @return True if the savegame is in an autosave directory.
+ */
+static bool IsAutosaveDirectoryFile(const std::string &filename, Subdirectory sb)
+{
+	if (sb == AUTOSAVE_DIR) return true;
+	if (sb != NO_DIRECTORY) return false;
+
+	size_t separator = filename.find_last_of(PATHSEPCHAR);
+	if (separator == std::string::npos) return false;
+	const std::string directory = filename.substr(0, separator + 1);
+	for (Searchpath sp : _valid_searchpaths) {
+		if (FioGetDirectory(sp, AUTOSAVE_DIR) == directory) return true;
+	}
+	return false;
+}
+
 /**
  * Main Save or Load function where the high-level saveload functions are
  * handled. It opens the savegame, selects format and checks versions
@@ -3715,6 +4846,7 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 		_sl.save_flags = save_flags;
 
 		FILE *fh = (fop == SLO_SAVE) ? FioFOpenFile(filename, "wb", sb) : FioFOpenFile(filename, "rb", sb);
+		const bool allow_delta = (fh != nullptr && IsAutosaveDirectoryFile(filename, sb));
 
 		/* Make it a little easier to load savegames from the console */
 		if (fh == nullptr && fop != SLO_SAVE) fh = FioFOpenFile(filename, "rb", SAVE_DIR);
@@ -3728,6 +4860,7 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 		if (fop == SLO_SAVE) { // SAVE game
 			DEBUG(desync, 1, "save: %s; %s", debug_date_dumper().HexDate(), filename.c_str());
 			if (!_settings_client.gui.threaded_saves) threaded = false;
+			if (_sl.save_flags & SMF_DELTA) SelectDeltaSaveMode();
 
 			return DoSave(new FileWriter(fh), threaded);
 		}
@@ -3735,7 +4868,9 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 		/* LOAD game */
 		assert(fop == SLO_LOAD || fop == SLO_CHECK);
 		DEBUG(desync, 1, "load: %s", filename.c_str());
-		return DoLoad(new FileReader(fh), fop == SLO_CHECK);
+		/* Delta autosaves of the loaded game would hardly share anything with the current base save. */
+		if (fop == SLO_LOAD) _delta_save_base.filename.clear();
+		return DoLoad(new FileReader(fh), fop == SLO_CHECK, allow_delta);
 	} catch (...) {
 		/* This code may be executed both for old and new save games. */
 		ClearSaveLoadState();
@@ -3752,8 +4887,9 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
  * Create an autosave or netsave.
  * @param counter A reference to the counter variable to be used for rotating the file name.
  * @param netsave Indicates if this is a regular autosave or a netsave.
+ * @param flags Additional save mode flags, e.g. #SMF_DELTA.
  */
-void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded, FiosNumberedSaveName *lt_counter)
+void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded, FiosNumberedSaveName *lt_counter, SaveModeFlags flags)
 {
 	std::string filename;
 
@@ -3765,12 +4901,14 @@ void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded, FiosNumberedS
 			std::string lt_path = lt_counter->FilenameUsingMaxSaves(_settings_client.gui.max_num_lt_autosaves);
 			DEBUG(sl, 2, "Renaming autosave '%s' to long-term file '%s'", filename.c_str(), lt_path.c_str());
 			std::string dir = FioFindDirectory(AUTOSAVE_DIR);
+			/* The save thread may be looking for the delta saves which still use a base save. */
+			if (flags & SMF_DELTA) WaitTillSaved();
 			FioRenameFile(dir + filename, dir + lt_path);
 		}
 	}
 
 	DEBUG(sl, 2, "Autosaving to '%s'", filename.c_str());
-	if (SaveOrLoad(filename, SLO_SAVE, DFT_GAME_FILE, AUTOSAVE_DIR, threaded, SMF_ZSTD_OK) != SL_OK) {
+	if (SaveOrLoad(filename, SLO_SAVE, DFT_GAME_FILE, AUTOSAVE_DIR, threaded, SMF_ZSTD_OK | flags) != SL_OK) {
 		ShowErrorMessage(STR_ERROR_AUTOSAVE_FAILED, INVALID_STRING_ID, WL_ERROR);
 	}
 }
@@ -61,6 +61,8 @@ enum SaveModeFlags : byte {
 	SMF_NET_SERVER       = 1 << 0, ///< Network server save
 	SMF_ZSTD_OK          = 1 << 1, ///< Zstd OK
 	SMF_SCENARIO         = 1 << 2, ///< Scenario save
+	SMF_DELTA            = 1 << 3, ///< Autosave which may be written as delta against a base save
+	SMF_DELTA_BASE       = 1 << 4, ///< Delta autosave which first writes a new base save to write it against (set internally)
 };
 DECLARE_ENUM_AS_BIT_SET(SaveModeFlags);
 
@@ -74,7 +76,8 @@ void WaitTillSaved();
 void ProcessAsyncSaveFinish();
 void DoExitSave();
 
-void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded, FiosNumberedSaveName *lt_counter = nullptr);
+void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded, FiosNumberedSaveName *lt_counter = nullptr, SaveModeFlags flags = SMF_NONE);
+bool ConsolidateDeltaSave(const std::string &input, const std::string &output, std::string &error);
 
 SaveOrLoadResult SaveWithFilter(struct SaveFilter *writer, bool threaded, SaveModeFlags flags);
 SaveOrLoadResult LoadWithFilter(struct LoadFilter *reader);
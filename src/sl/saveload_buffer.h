@@ -257,6 +257,8 @@ struct MemoryDumper {
 
 	void Flush(SaveFilter *writer);
 	size_t GetSize() const;
+	void CopyRange(size_t offset, size_t length, byte *dest);
+	void WriteRange(SaveFilter *writer, size_t offset, size_t length);
 	void StartAutoLength();
 	std::pair<byte *, size_t> StopAutoLength();
 	bool IsAutoLengthActive() const { return this->saved_buf != nullptr; }
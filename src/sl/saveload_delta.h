@@ -0,0 +1,42 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file saveload_delta.h Declaration of the encoding of delta autosaves. */
+
+#ifndef SL_SAVELOAD_DELTA_H
+#define SL_SAVELOAD_DELTA_H
+
+#include "saveload_buffer.h"
+#include "saveload_filter.h"
+#include <string>
+#include <vector>
+
+/** Position of a saved chunk in the uncompressed savegame stream. */
+struct SavedChunkRange {
+	uint32_t id;   ///< Chunk ID.
+	size_t offset; ///< Offset of the chunk in the stream.
+	size_t length; ///< Length of the chunk in the stream.
+};
+
+/** Layout of the last full autosave, against which delta autosaves are made. */
+struct DeltaSaveBase {
+	/** A saved chunk of the base save. */
+	struct Chunk {
+		SavedChunkRange range;        ///< Position of the chunk in the base save.
+		std::vector<uint64_t> hashes; ///< Hash of each segment of the chunk.
+	};
+
+	std::string filename;      ///< Name of the base save in the autosave directory, empty if there is none.
+	std::vector<Chunk> chunks; ///< Chunks of the base save.
+	uint deltas_written = 0;   ///< Number of delta saves written since the base save.
+};
+
+void RecordDeltaSaveLayout(DeltaSaveBase &base, MemoryDumper *dumper, const std::vector<SavedChunkRange> &ranges);
+size_t WriteDeltaSaveEntries(SaveFilter *writer, MemoryDumper *dumper, const std::vector<SavedChunkRange> &ranges, const DeltaSaveBase &base);
+LoadFilter *CreateDeltaSaveEntryReader(LoadFilter *entries, LoadFilter *base, const std::string &base_name);
+
+#endif /* SL_SAVELOAD_DELTA_H */
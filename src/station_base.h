@@ -625,6 +625,16 @@ struct GoodsEntry {
 		return !HasBit(this->status, GES_NO_CARGO_SUPPLY);
 	}
 
+	/**
+	 * Is this entry in a state which the periodic rating and acceptance updates leave alone?
+	 * That is without any status, rating bonus or malus and link graph.
+	 * @return true if the entry is idle.
+	 */
+	inline bool IsIdle() const
+	{
+		return this->status == 0 && this->rating >= INITIAL_STATION_RATING && this->link_graph == INVALID_LINK_GRAPH;
+	}
+
 	/**
 	 * Reports whether a vehicle has ever tried to load the cargo at this station.
 	 * This does not imply that there was cargo available for loading. Refer to GES_RATING for that.
@@ -713,6 +723,59 @@ struct GoodsEntry {
 	}
 };
 
+/**
+ * The goods entries of a station, one per cargo type.
+ * Every entry which may be changed is handed out by the non-const accessors,
+ * which mark its cargo as active. Cargos which aren't active have idle entries,
+ * so the periodic updates only need to visit the active ones.
+ */
+struct StationGoods {
+private:
+	GoodsEntry entries[NUM_CARGO]; ///< The entries, indexed by cargo type.
+	CargoTypes active = 0;         ///< Cargos whose entry may not be idle.
+
+public:
+	inline GoodsEntry &operator[](size_t cargo)
+	{
+		SetBit(this->active, cargo);
+		return this->entries[cargo];
+	}
+
+	inline const GoodsEntry &operator[](size_t cargo) const
+	{
+		return this->entries[cargo];
+	}
+
+	inline GoodsEntry *begin()
+	{
+		this->active = ALL_CARGOTYPES;
+		return std::begin(this->entries);
+	}
+
+	inline GoodsEntry *end() { return std::end(this->entries); }
+	inline const GoodsEntry *begin() const { return std::begin(this->entries); }
+	inline const GoodsEntry *end() const { return std::end(this->entries); }
+	static constexpr size_t size() { return NUM_CARGO; }
+
+	/**
+	 * Get the cargos whose entry may not be idle.
+	 * @return Mask of the cargos.
+	 */
+	inline CargoTypes GetActiveCargos() const
+	{
+		return this->active;
+	}
+
+	/**
+	 * Stop visiting the entry of a cargo if it is idle.
+	 * @param cargo Cargo of the entry.
+	 */
+	inline void DeactivateIfIdle(CargoID cargo)
+	{
+		if (this->entries[cargo].IsIdle()) ClrBit(this->active, cargo);
+	}
+};
+
 /** All airport-related information. Only valid if tile != INVALID_TILE. */
 struct Airport : public TileArea {
 	Airport() : TileArea(INVALID_TILE, 0, 0) {}
@@ -898,7 +961,7 @@ public:
 	byte time_since_unload;
 
 	std::vector<Vehicle *> loading_vehicles;
-	GoodsEntry goods[NUM_CARGO];  ///< Goods at this station
+	StationGoods goods;               ///< Goods at this station
 	CargoTypes always_accepted;       ///< Bitmask of always accepted cargo types (by houses, HQs, industry tiles when industry doesn't accept cargo)
 
 	IndustryList industries_near; ///< Cached list of industries near the station that can accept cargo, @see DeliverGoodsToIndustry()
@@ -25,6 +25,7 @@
 #include "newgrf_station.h"
 #include "newgrf_canal.h" /* For the buoy */
 #include "pathfinder/yapf/yapf_cache.h"
+#include "pathfinder/road_regions.h"
 #include "road_internal.h" /* For drawing catenary/checking road removal */
 #include "autoslope.h"
 #include "water.h"
@@ -573,7 +574,7 @@ CargoTypes GetAcceptanceMask(const Station *st)
 {
 	CargoTypes mask = 0;
 
-	for (CargoID i = 0; i < NUM_CARGO; i++) {
+	for (CargoID i : SetCargoBitIterator(st->goods.GetActiveCargos())) {
 		if (HasBit(st->goods[i].status, GoodsEntry::GES_ACCEPTANCE)) SetBit(mask, i);
 	}
 	return mask;
@@ -706,8 +707,14 @@ void UpdateStationAcceptance(Station *st, bool show_msg)
 		acceptance = GetAcceptanceAroundStation(st, &st->always_accepted);
 	}
 
-	/* Adjust in case our station only accepts fewer kinds of goods */
+	/* Only cargos which are accepted now or have an entry which isn't idle can change. */
+	CargoTypes cargos = st->goods.GetActiveCargos();
 	for (CargoID i = 0; i < NUM_CARGO; i++) {
+		if (acceptance[i] >= 8) SetBit(cargos, i);
+	}
+
+	/* Adjust in case our station only accepts fewer kinds of goods */
+	for (CargoID i : SetCargoBitIterator(cargos)) {
 		uint amt = acceptance[i];
 
 		/* Make sure the station can accept the goods type. */
@@ -754,8 +761,9 @@ static void UpdateStationSignCoord(BaseStation *st)
 	st->MoveSign(new_xy);
 
 	if (!Station::IsExpected(st)) return;
-	Station *full_station = Station::From(st);
-	for (const GoodsEntry &ge : full_station->goods) {
+	const Station *full_station = Station::From(st);
+	for (CargoID c : SetCargoBitIterator(full_station->goods.GetActiveCargos())) {
+		const GoodsEntry &ge = full_station->goods[c];
 		LinkGraphID lg = ge.link_graph;
 		if (!LinkGraph::IsValidID(lg)) continue;
 		(*LinkGraph::Get(lg))[ge.node].UpdateLocation(st->xy);
@@ -2268,6 +2276,7 @@ CommandCost CmdBuildRoadStop(TileIndex tile, DoCommandFlag flags, uint32_t p1, u
 				if (tram_rt == INVALID_ROADTYPE && RoadTypeIsTram(rt)) tram_rt = rt;
 				MakeRoadStop(cur_tile, st->owner, st->index, rs_type, road_rt, tram_rt, ddir);
 			}
+			InvalidateRoadRegion(cur_tile);
 			UpdateCompanyRoadInfrastructure(road_rt, road_owner, ROAD_STOP_TRACKBIT_FACTOR);
 			UpdateCompanyRoadInfrastructure(tram_rt, tram_owner, ROAD_STOP_TRACKBIT_FACTOR);
 			Company::Get(st->owner)->infrastructure.station++;
@@ -2552,6 +2561,7 @@ CommandCost CmdRemoveRoadStop(TileIndex tile, DoCommandFlag flags, uint32_t p1,
 			MakeRoadNormal(cur_tile, road_bits, road_type[RTT_ROAD], road_type[RTT_TRAM], ClosestTownFromTile(cur_tile, UINT_MAX)->index,
 					road_owner[RTT_ROAD], road_owner[RTT_TRAM]);
 			if (drd != DRD_NONE) SetDisallowedRoadDirections(cur_tile, drd);
+			InvalidateRoadRegion(cur_tile);
 
 			/* Update company infrastructure counts. */
 			int count = CountBits(road_bits);
@@ -4068,7 +4078,7 @@ void TriggerWatchedCargoCallbacks(Station *st)
 {
 	/* Collect cargoes accepted since the last big tick. */
 	CargoTypes cargoes = 0;
-	for (CargoID cid = 0; cid < NUM_CARGO; cid++) {
+	for (CargoID cid : SetCargoBitIterator(st->goods.GetActiveCargos())) {
 		if (HasBit(st->goods[cid].status, GoodsEntry::GES_ACCEPTED_BIGTICK)) SetBit(cargoes, cid);
 	}
 
@@ -4098,10 +4108,11 @@ static bool StationHandleBigTick(BaseStation *st)
 	}
 
 	if (Station::IsExpected(st)) {
-		TriggerWatchedCargoCallbacks(Station::From(st));
+		Station *station = Station::From(st);
+		TriggerWatchedCargoCallbacks(station);
 
-		for (GoodsEntry &ge : Station::From(st)->goods) {
-			ClrBit(ge.status, GoodsEntry::GES_ACCEPTED_BIGTICK);
+		for (CargoID c : SetCargoBitIterator(station->goods.GetActiveCargos())) {
+			ClrBit(station->goods[c].status, GoodsEntry::GES_ACCEPTED_BIGTICK);
 		}
 	}
 
@@ -4243,7 +4254,15 @@ int GetVehicleAgeRating(const GoodsEntry *ge)
 	return rating;
 }
 
-int GetTargetRating(const Station *st, const CargoSpec *cs, const GoodsEntry *ge)
+/**
+ * Get the rating which the rating of a cargo at a station moves towards.
+ * @param st Station of the cargo.
+ * @param cs Cargo to rate.
+ * @param ge Goods entry of the cargo at the station.
+ * @param statue_rating Rating bonus of the statue in the town of the station, see #GetStatueRating.
+ * @return The target rating.
+ */
+static int GetTargetRating(const Station *st, const CargoSpec *cs, const GoodsEntry *ge, int statue_rating)
 {
 	bool skip = false;
 	int rating = 0;
@@ -4267,7 +4286,7 @@ int GetTargetRating(const Station *st, const CargoSpec *cs, const GoodsEntry *ge
 		rating += GetWaitingCargoRating(st, ge);
 	}
 
-	rating += GetStatueRating(st);
+	rating += statue_rating;
 	rating += GetVehicleAgeRating(ge);
 
 	return ClampTo<uint8_t>(rating);
@@ -4280,8 +4299,29 @@ static void UpdateStationRating(Station *st)
 	byte_inc_sat(&st->time_since_load);
 	byte_inc_sat(&st->time_since_unload);
 
-	for (const CargoSpec *cs : CargoSpec::Iterate()) {
-		GoodsEntry *ge = &st->goods[cs->Index()];
+	/* The statue and the cap of the waiting cargo are the same for all cargos of the station. */
+	const int statue_rating = GetStatueRating(st);
+
+	/* At some point we really must cap the cargo. Previously this
+	 * was a strict 4095, but now we'll have a less strict, but
+	 * increasingly aggressive truncation of the amount of cargo. */
+	static const uint WAITING_CARGO_THRESHOLD  = 1 << 12;
+	static const uint WAITING_CARGO_CUT_FACTOR = 1 <<  6;
+	static const uint MAX_WAITING_CARGO        = 1 << 15;
+
+	uint normalised_waiting_cargo_threshold = WAITING_CARGO_THRESHOLD;
+	if (_settings_game.station.station_size_rating_cargo_amount) {
+		if (st->station_tiles > 1) normalised_waiting_cargo_threshold *= st->station_tiles;
+		normalised_waiting_cargo_threshold /= 8;
+	}
+	const uint normalised_max_waiting_cargo = normalised_waiting_cargo_threshold * (MAX_WAITING_CARGO / WAITING_CARGO_THRESHOLD);
+
+	/* Idle entries keep their rating, so only the active cargos need a visit. */
+	for (CargoID c : SetCargoBitIterator(st->goods.GetActiveCargos())) {
+		st->goods.DeactivateIfIdle(c);
+		const CargoSpec *cs = CargoSpec::Get(c);
+		if (!cs->IsValid() || !HasBit(st->goods.GetActiveCargos(), c)) continue;
+		GoodsEntry *ge = &st->goods[c];
 
 		/* Slowly increase the rating back to its original level in the case we
 		 *  didn't deliver cargo yet to this station. This happens when a bribe
@@ -4303,7 +4343,7 @@ static void UpdateStationRating(Station *st)
 			}
 
 			{
-				int rating = GetTargetRating(st, cs, ge);
+				int rating = GetTargetRating(st, cs, ge, statue_rating);
 
 				uint waiting = ge->CargoAvailableCount();
 
@@ -4344,23 +4384,9 @@ static void UpdateStationRating(Station *st)
 					}
 				}
 
-				/* At some point we really must cap the cargo. Previously this
-				 * was a strict 4095, but now we'll have a less strict, but
-				 * increasingly aggressive truncation of the amount of cargo. */
-				static const uint WAITING_CARGO_THRESHOLD  = 1 << 12;
-				static const uint WAITING_CARGO_CUT_FACTOR = 1 <<  6;
-				static const uint MAX_WAITING_CARGO        = 1 << 15;
-
-				uint normalised_waiting_cargo_threshold = WAITING_CARGO_THRESHOLD;
-				if (_settings_game.station.station_size_rating_cargo_amount) {
-					if (st->station_tiles > 1) normalised_waiting_cargo_threshold *= st->station_tiles;
-					normalised_waiting_cargo_threshold /= 8;
-				}
-
 				if (waiting > normalised_waiting_cargo_threshold) {
 					const uint difference = waiting - normalised_waiting_cargo_threshold;
 					waiting -= (difference / WAITING_CARGO_CUT_FACTOR);
-					const uint normalised_max_waiting_cargo = normalised_waiting_cargo_threshold * (MAX_WAITING_CARGO / WAITING_CARGO_THRESHOLD);
 					waiting = std::min(waiting, normalised_max_waiting_cargo);
 					waiting_changed = true;
 				}
@@ -4456,7 +4482,7 @@ void ClearDeleteStaleLinksVehicleCache()
  */
 void DeleteStaleLinks(Station *from)
 {
-	for (CargoID c = 0; c < NUM_CARGO; ++c) {
+	for (CargoID c : SetCargoBitIterator(from->goods.GetActiveCargos())) {
 		const bool auto_distributed = (_settings_game.linkgraph.GetDistributionType(c) != DT_MANUAL);
 		GoodsEntry &ge = from->goods[c];
 		LinkGraph *lg = LinkGraph::GetIfValid(ge.link_graph);
@@ -4673,7 +4699,8 @@ void StationDailyLoop()
 void StationMonthlyLoop()
 {
 	for (Station *st : Station::Iterate()) {
-		for (GoodsEntry &ge : st->goods) {
+		for (CargoID c : SetCargoBitIterator(st->goods.GetActiveCargos())) {
+			GoodsEntry &ge = st->goods[c];
 			SB(ge.status, GoodsEntry::GES_LAST_MONTH, 1, GB(ge.status, GoodsEntry::GES_CURRENT_MONTH, 1));
 			ClrBit(ge.status, GoodsEntry::GES_CURRENT_MONTH);
 		}
@@ -4685,7 +4712,8 @@ void ModifyStationRatingAround(TileIndex tile, Owner owner, int amount, uint rad
 {
 	ForAllStationsRadius(tile, radius, [&](Station *st) {
 		if (st->owner == owner && DistanceManhattan(tile, st->xy) <= radius) {
-			for (GoodsEntry &ge : st->goods) {
+			for (CargoID c : SetCargoBitIterator(st->goods.GetActiveCargos())) {
+				GoodsEntry &ge = st->goods[c];
 				if (ge.status != 0) {
 					ge.rating = ClampTo<uint8_t>(ge.rating + amount);
 				}
@@ -524,12 +524,15 @@ inline void free(const void *ptr)
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 	#define INCLUDE_FOR_PREFETCH_NTA <xmmintrin.h>
 	#define PREFETCH_NTA(address) _mm_prefetch((const char *) (address), _MM_HINT_NTA);
+	#define PREFETCH_WRITE(address) _mm_prefetch((const char *) (address), _MM_HINT_T0);
 #elif defined(__GNUC__) || defined(__clang__)
 	#define INCLUDE_FOR_PREFETCH_NTA "stdafx.h"
 	#define PREFETCH_NTA(address) __builtin_prefetch((const void *) (address), 0, 0);
+	#define PREFETCH_WRITE(address) __builtin_prefetch((const void *) (address), 1, 3);
 #else
 	#define INCLUDE_FOR_PREFETCH_NTA "stdafx.h"
 	#define PREFETCH_NTA(address)
+	#define PREFETCH_WRITE(address)
 #endif
 
 #if !defined(DISABLE_SCOPE_INFO) && (__cplusplus >= 201103L || defined(__STDCXX_VERSION__) || defined(__GXX_EXPERIMENTAL_CXX0X__) || defined(__GXX_EXPERIMENTAL_CPP0X__))
@@ -0,0 +1,124 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file cargo_aging.cpp Test the aging of the cargo in vehicles. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../cargopacket.h"
+
+#include <chrono>
+#include <map>
+
+/** Reference ages of the packets, keyed by their first station, which is unique per packet. */
+using ExpectedAges = std::map<StationID, uint16_t>;
+
+static StationID _next_first_station = 0;
+
+static void AppendPacket(VehicleCargoList &list, ExpectedAges &expected, uint16_t count, uint16_t periods_in_transit)
+{
+	REQUIRE(CargoPacket::CanAllocateItem());
+	StationID first_station = _next_first_station++;
+	list.Append(new CargoPacket(count, periods_in_transit, first_station, 0, 0));
+	expected[first_station] = periods_in_transit;
+}
+
+static void AgeExpected(ExpectedAges &expected)
+{
+	for (auto &it : expected) {
+		if (it.second != UINT16_MAX) it.second++;
+	}
+}
+
+static bool CheckAges(VehicleCargoList &list, const ExpectedAges &expected)
+{
+	uint64_t sum = 0;
+	for (const CargoPacket *cp : *list.Packets()) {
+		auto it = expected.find(cp->GetFirstStation());
+		if (it == expected.end() || it->second != list.GetPeriodsInTransit(cp)) return false;
+		sum += static_cast<uint64_t>(it->second) * cp->Count();
+	}
+	if (list.CargoPeriodsInTransit() != sum) return false;
+
+	/* Rebuilding the cache from the packets has to give the same result. */
+	list.InvalidateCache();
+	return list.CargoPeriodsInTransit() == sum;
+}
+
+TEST_CASE("Cargo aging - same ages as aging each packet")
+{
+	VehicleCargoList list{};
+	ExpectedAges expected;
+
+	AppendPacket(list, expected, 10, 0);
+	AppendPacket(list, expected, 20, 300);
+	for (uint i = 0; i < 50; i++) {
+		list.AgeCargo();
+		AgeExpected(expected);
+		if (i % 7 == 0) AppendPacket(list, expected, 1 + i, i * 3);
+	}
+	CHECK(CheckAges(list, expected));
+
+	/* Packets reaching the maximum age stop aging. */
+	AppendPacket(list, expected, 5, UINT16_MAX - 3);
+	for (uint i = 0; i < 10; i++) {
+		list.AgeCargo();
+		AgeExpected(expected);
+		CHECK(CheckAges(list, expected));
+	}
+
+	/* Moving packets to a list with another aging epoch keeps their ages. */
+	VehicleCargoList other{};
+	ExpectedAges other_expected;
+	AppendPacket(other, other_expected, 3, 7);
+	for (uint i = 0; i < 20; i++) {
+		other.AgeCargo();
+		AgeExpected(other_expected);
+	}
+	list.Shift(list.TotalCount() / 2, &other);
+	for (const CargoPacket *cp : *other.Packets()) {
+		auto it = expected.find(cp->GetFirstStation());
+		if (it != expected.end()) other_expected[it->first] = it->second;
+	}
+	CHECK(CheckAges(other, other_expected));
+
+	/* Saving stores the absolute ages in the packets. */
+	other.NormaliseAging();
+	for (const CargoPacket *cp : *other.Packets()) {
+		CHECK(cp->GetPeriodsInTransit() == other.GetPeriodsInTransit(cp));
+	}
+	CHECK(CheckAges(other, other_expected));
+}
+
+/**
+ * Compare aging a list by its epoch with aging each of its packets, which still happens once a packet may be at the maximum age.
+ * Run with: openttd_test "[.benchmark]"
+ */
+TEST_CASE("Cargo aging - benchmark", "[.benchmark]")
+{
+	static const uint PACKETS = 2000;
+	static const uint AGINGS = 20000;
+
+	auto time = [&](bool at_maximum) {
+		VehicleCargoList list{};
+		ExpectedAges expected;
+		for (uint i = 0; i < PACKETS; i++) AppendPacket(list, expected, 1 + i % 50, i);
+		if (at_maximum) AppendPacket(list, expected, 1, UINT16_MAX);
+
+		auto start = std::chrono::steady_clock::now();
+		for (uint i = 0; i < AGINGS; i++) list.AgeCargo();
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		return std::make_pair(list.CargoPeriodsInTransit(), ns / AGINGS);
+	};
+
+	auto per_packet = time(true);
+	auto epoch = time(false);
+	CHECK(per_packet.first == epoch.first + UINT16_MAX);
+	WARN(PACKETS << " packets: per packet: " << per_packet.second << " ns, epoch: " << epoch.second << " ns per aging");
+}
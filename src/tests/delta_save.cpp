@@ -0,0 +1,144 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file delta_save.cpp Test writing and reading back the entries of delta autosaves. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../sl/saveload_delta.h"
+
+#include <memory>
+#include <random>
+
+/** Save filter collecting everything written to it. */
+struct MemorySaveFilter : SaveFilter {
+	std::vector<byte> &data; ///< The written data.
+
+	MemorySaveFilter(std::vector<byte> &data) : SaveFilter(nullptr), data(data) {}
+
+	void Write(byte *buf, size_t len) override
+	{
+		this->data.insert(this->data.end(), buf, buf + len);
+	}
+};
+
+/** Load filter reading from memory. */
+struct MemoryLoadFilter : LoadFilter {
+	const std::vector<byte> &data; ///< The data to read.
+	size_t pos = 0;                ///< Read position in #data.
+
+	MemoryLoadFilter(const std::vector<byte> &data) : LoadFilter(nullptr), data(data) {}
+
+	size_t Read(byte *buf, size_t len) override
+	{
+		len = std::min(len, this->data.size() - this->pos);
+		std::copy_n(this->data.begin() + this->pos, len, buf);
+		this->pos += len;
+		return len;
+	}
+
+	void Reset() override
+	{
+		this->pos = 0;
+	}
+};
+
+/** Uncompressed savegame stream with its chunks, as saved into a memory dump. */
+struct TestDump {
+	std::unique_ptr<MemoryDumper> dumper = std::make_unique<MemoryDumper>();
+	std::vector<SavedChunkRange> ranges;
+	std::vector<byte> data;
+
+	/**
+	 * Append a chunk to the stream.
+	 * @param id Chunk ID.
+	 * @param chunk Content of the chunk.
+	 */
+	void AddChunk(uint32_t id, const std::vector<byte> &chunk)
+	{
+		this->ranges.push_back({ id, this->data.size(), chunk.size() });
+		this->dumper->CopyBytes(chunk.data(), chunk.size());
+		this->data.insert(this->data.end(), chunk.begin(), chunk.end());
+	}
+};
+
+/**
+ * Read the complete stream of a filter.
+ * @param reader The filter to read from.
+ * @return The data.
+ */
+static std::vector<byte> ReadAll(LoadFilter *reader)
+{
+	std::vector<byte> result;
+	byte buf[100000];
+	size_t length;
+	while ((length = reader->Read(buf, sizeof(buf))) != 0) result.insert(result.end(), buf, buf + length);
+	return result;
+}
+
+TEST_CASE("Delta save - written entries read back as the saved stream")
+{
+	std::mt19937 random(1234);
+	auto make_chunk = [&](size_t length) {
+		std::vector<byte> chunk(length);
+		for (byte &b : chunk) b = (byte)random();
+		return chunk;
+	};
+
+	/* Chunks spanning several segments, a chunk which changes length and a chunk which only exists in the base save. */
+	std::vector<byte> large = make_chunk(700000);
+	std::vector<byte> small = make_chunk(5000);
+	std::vector<byte> resized = make_chunk(300000);
+	std::vector<byte> removed = make_chunk(1000);
+
+	TestDump base;
+	base.AddChunk('LRGE', large);
+	base.AddChunk('SMLL', small);
+	base.AddChunk('RSZD', resized);
+	base.AddChunk('REMV', removed);
+
+	DeltaSaveBase layout;
+	layout.deltas_written = 3;
+	RecordDeltaSaveLayout(layout, base.dumper.get(), base.ranges);
+	CHECK(layout.deltas_written == 0);
+	REQUIRE(layout.chunks.size() == 4);
+	CHECK(layout.chunks[0].hashes.size() == 3);
+
+	/* Change the middle segment of the large chunk, and add a new chunk in front of everything. */
+	large[400000]++;
+	resized.resize(resized.size() + 10);
+	TestDump current;
+	current.AddChunk('ADDD', make_chunk(2000));
+	current.AddChunk('LRGE', large);
+	current.AddChunk('SMLL', small);
+	current.AddChunk('RSZD', resized);
+
+	std::vector<byte> entries;
+	MemorySaveFilter writer(entries);
+	size_t inline_bytes = WriteDeltaSaveEntries(&writer, current.dumper.get(), current.ranges, layout);
+	CHECK(inline_bytes == current.data.size() - (large.size() - 256 * 1024) - small.size());
+	CHECK(entries.size() < inline_bytes + 1000);
+
+	SECTION("Round trip") {
+		std::unique_ptr<LoadFilter> reader(CreateDeltaSaveEntryReader(new MemoryLoadFilter(entries), new MemoryLoadFilter(base.data), "base"));
+		CHECK(ReadAll(reader.get()) == current.data);
+	}
+
+	SECTION("Changed base save") {
+		base.data[large.size() + 10]++;
+		std::unique_ptr<LoadFilter> reader(CreateDeltaSaveEntryReader(new MemoryLoadFilter(entries), new MemoryLoadFilter(base.data), "base"));
+		CHECK_THROWS(ReadAll(reader.get()));
+	}
+
+	SECTION("Truncated delta save") {
+		entries.pop_back();
+		std::unique_ptr<LoadFilter> reader(CreateDeltaSaveEntryReader(new MemoryLoadFilter(entries), new MemoryLoadFilter(base.data), "base"));
+		CHECK_THROWS(ReadAll(reader.get()));
+	}
+}
@@ -0,0 +1,181 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file network_poll.cpp Test functionality from network/core/tcp_poll.h */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../network/core/tcp_poll.h"
+
+#include <chrono>
+#include <vector>
+
+#if defined(UNIX)
+
+/** A number of connected loopback socket pairs. */
+struct LoopbackConnections {
+	SOCKET listener = INVALID_SOCKET;
+	std::vector<SOCKET> clients; ///< The connecting ends.
+	std::vector<SOCKET> servers; ///< The accepted ends.
+
+	LoopbackConnections(size_t count)
+	{
+		this->listener = socket(AF_INET, SOCK_STREAM, 0);
+		REQUIRE(this->listener != INVALID_SOCKET);
+
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		REQUIRE(bind(this->listener, (sockaddr *)&addr, sizeof(addr)) == 0);
+		REQUIRE(listen(this->listener, (int)count) == 0);
+		socklen_t addr_len = sizeof(addr);
+		REQUIRE(getsockname(this->listener, (sockaddr *)&addr, &addr_len) == 0);
+
+		for (size_t i = 0; i < count; i++) {
+			SOCKET client = socket(AF_INET, SOCK_STREAM, 0);
+			REQUIRE(client != INVALID_SOCKET);
+			REQUIRE(connect(client, (sockaddr *)&addr, sizeof(addr)) == 0);
+			this->clients.push_back(client);
+
+			SOCKET server = accept(this->listener, nullptr, nullptr);
+			REQUIRE(server != INVALID_SOCKET);
+			this->servers.push_back(server);
+		}
+	}
+
+	~LoopbackConnections()
+	{
+		for (SOCKET s : this->clients) closesocket(s);
+		for (SOCKET s : this->servers) closesocket(s);
+		if (this->listener != INVALID_SOCKET) closesocket(this->listener);
+	}
+};
+
+static void DrainSocket(SOCKET s)
+{
+	char buffer[16];
+	while (recv(s, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {}
+}
+
+TEST_CASE("NetworkSocketPoller - readability")
+{
+	LoopbackConnections conns(64);
+	NetworkSocketPoller poller;
+	for (size_t i = 0; i < conns.servers.size(); i++) {
+		REQUIRE(poller.AddSocket(conns.servers[i], &conns.servers[i]));
+	}
+	CHECK(poller.Count() == 64);
+
+	REQUIRE(poller.Poll());
+	CHECK(poller.GetEvents().empty());
+
+	for (size_t i = 0; i < conns.clients.size(); i += 7) {
+		REQUIRE(send(conns.clients[i], "x", 1, 0) == 1);
+	}
+
+	REQUIRE(poller.Poll(1000));
+	std::vector<bool> seen(conns.servers.size());
+	for (const NetworkSocketEvent &event : poller.GetEvents()) {
+		size_t index = static_cast<SOCKET *>(event.data) - conns.servers.data();
+		REQUIRE(index < conns.servers.size());
+		CHECK(event.sock == conns.servers[index]);
+		CHECK(event.readable);
+		CHECK_FALSE(event.writable);
+		seen[index] = true;
+	}
+	/* Loopback data is available immediately, so all sockets must be reported by the first poll. */
+	for (size_t i = 0; i < seen.size(); i++) {
+		CHECK(seen[i] == (i % 7 == 0));
+	}
+
+	/* Sockets stay readable until the data is received. */
+	REQUIRE(poller.Poll());
+	CHECK(poller.GetEvents().size() == (conns.servers.size() + 6) / 7);
+	for (SOCKET s : conns.servers) DrainSocket(s);
+	REQUIRE(poller.Poll());
+	CHECK(poller.GetEvents().empty());
+}
+
+TEST_CASE("NetworkSocketPoller - writability and removal")
+{
+	LoopbackConnections conns(4);
+	NetworkSocketPoller poller;
+	for (size_t i = 0; i < conns.servers.size(); i++) {
+		REQUIRE(poller.AddSocket(conns.servers[i], &conns.servers[i]));
+	}
+
+	/* Writability is only reported when requested. */
+	poller.WatchWritable(conns.servers[1], true);
+	REQUIRE(poller.Poll());
+	REQUIRE(poller.GetEvents().size() == 1);
+	CHECK(poller.GetEvents()[0].sock == conns.servers[1]);
+	CHECK(poller.GetEvents()[0].writable);
+	CHECK_FALSE(poller.GetEvents()[0].readable);
+
+	poller.WatchWritable(conns.servers[1], false);
+	REQUIRE(poller.Poll());
+	CHECK(poller.GetEvents().empty());
+
+	/* Removing a socket clears the data of its pending events. */
+	REQUIRE(send(conns.clients[2], "x", 1, 0) == 1);
+	REQUIRE(poller.Poll(1000));
+	REQUIRE(poller.GetEvents().size() == 1);
+	poller.RemoveSocket(conns.servers[2]);
+	CHECK(poller.GetEvents()[0].data == nullptr);
+	CHECK(poller.Count() == 3);
+
+	REQUIRE(poller.Poll());
+	CHECK(poller.GetEvents().empty());
+}
+
+/**
+ * Compare the cost of checking many mostly idle loopback connections with select, as done
+ * before, with the cost of polling them. Run with: openttd_test "[.benchmark]"
+ */
+TEST_CASE("NetworkSocketPoller - scaling with loopback clients", "[.benchmark]")
+{
+	for (size_t count : { 16, 64, 256, 400 }) {
+		LoopbackConnections conns(count);
+		NetworkSocketPoller poller;
+		for (size_t i = 0; i < conns.servers.size(); i++) {
+			REQUIRE(poller.AddSocket(conns.servers[i], &conns.servers[i]));
+		}
+		/* A few clients are active. */
+		for (size_t i = 0; i < 4; i++) REQUIRE(send(conns.clients[i], "x", 1, 0) == 1);
+
+		const int iterations = 2000;
+
+		auto select_start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) {
+			fd_set read_fd, write_fd;
+			FD_ZERO(&read_fd);
+			FD_ZERO(&write_fd);
+			for (SOCKET s : conns.servers) {
+				FD_SET(s, &read_fd);
+				FD_SET(s, &write_fd);
+			}
+			timeval tv{};
+			REQUIRE(select(FD_SETSIZE, &read_fd, &write_fd, nullptr, &tv) >= 0);
+		}
+		auto select_time = std::chrono::steady_clock::now() - select_start;
+
+		auto poll_start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) {
+			REQUIRE(poller.Poll());
+			REQUIRE(poller.GetEvents().size() == 4);
+		}
+		auto poll_time = std::chrono::steady_clock::now() - poll_start;
+
+		WARN(count << " connections: select: " << std::chrono::duration_cast<std::chrono::nanoseconds>(select_time).count() / iterations
+				<< " ns, poller: " << std::chrono::duration_cast<std::chrono::nanoseconds>(poll_time).count() / iterations << " ns per iteration");
+	}
+}
+
+#endif /* UNIX */
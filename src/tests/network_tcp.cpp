@@ -0,0 +1,175 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file network_tcp.cpp Test the send queue of network/core/tcp.h */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../network/core/tcp.h"
+#include "../network/core/tcp_io_thread.h"
+
+#include <thread>
+#include <vector>
+
+#if defined(UNIX)
+
+/** A socket handler on one end of a socket pair, with the other end to read what it sends. */
+struct SocketPairHandler {
+	NetworkTCPSocketHandler handler;
+	SOCKET reader = INVALID_SOCKET;
+
+	SocketPairHandler()
+	{
+		int fds[2];
+		REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+		REQUIRE(SetNonBlocking(fds[0]));
+		this->handler.sock = fds[0];
+		this->handler.writable = true;
+		this->reader = fds[1];
+	}
+
+	~SocketPairHandler()
+	{
+		closesocket(this->reader);
+	}
+
+	/**
+	 * Receive everything that is currently available.
+	 * @param received The buffer to append the data to.
+	 */
+	void Drain(std::vector<byte> &received)
+	{
+		byte buffer[4096];
+		ssize_t n;
+		while ((n = recv(this->reader, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+			received.insert(received.end(), buffer, buffer + n);
+		}
+	}
+};
+
+static std::unique_ptr<Packet> CreateTestPacket(PacketType type, size_t length)
+{
+	std::unique_ptr<Packet> p = Packet::Create(type, SHRT_MAX);
+	for (size_t i = 0; i < length; i++) p->Send_uint8((uint8_t)(type + i));
+	return p;
+}
+
+static void AppendExpected(std::vector<byte> &expected, const Packet &p)
+{
+	expected.insert(expected.end(), p.GetBufferData(), p.GetBufferData() + p.Size());
+}
+
+TEST_CASE("NetworkTCPSocketHandler - shared packets")
+{
+	SocketPairHandler a, b;
+	std::vector<byte> expected_a, expected_b;
+
+	std::unique_ptr<Packet> own = CreateTestPacket(1, 10);
+	own->PrepareToSend();
+	AppendExpected(expected_a, *own);
+	a.handler.SendPacket(std::move(own));
+
+	/* The same packet is queued for both sockets, and only released once both sent it. */
+	SharedPacket shared = Packet::Share(CreateTestPacket(2, 100));
+	AppendExpected(expected_a, *shared);
+	AppendExpected(expected_b, *shared);
+	a.handler.SendPacket(shared);
+	b.handler.SendPacket(shared);
+	CHECK(shared.use_count() == 3);
+
+	SharedPacket last = Packet::Share(CreateTestPacket(3, 5));
+	AppendExpected(expected_b, *last);
+	b.handler.SendPacket(last);
+
+	CHECK(a.handler.SendPackets() == SPS_ALL_SENT);
+	CHECK(b.handler.SendPackets() == SPS_ALL_SENT);
+	CHECK(shared.use_count() == 1);
+
+	std::vector<byte> received_a, received_b;
+	a.Drain(received_a);
+	b.Drain(received_b);
+	CHECK(received_a == expected_a);
+	CHECK(received_b == expected_b);
+}
+
+TEST_CASE("NetworkTCPSocketHandler - partly sent batches")
+{
+	SocketPairHandler a;
+	std::vector<byte> expected, received;
+
+	/* Queue far more than fits in the socket buffer, with packets of varying sizes. */
+	for (uint i = 0; i < 2000; i++) {
+		SharedPacket p = Packet::Share(CreateTestPacket((PacketType)i, (i * 37) % 1400));
+		AppendExpected(expected, *p);
+		a.handler.SendPacket(p);
+	}
+
+	SendPacketsState state;
+	int rounds = 0;
+	while ((state = a.handler.SendPackets()) != SPS_ALL_SENT) {
+		REQUIRE(state == SPS_PARTLY_SENT);
+		REQUIRE(++rounds < 10000);
+		a.Drain(received);
+	}
+	a.Drain(received);
+
+	CHECK(rounds > 0);
+	CHECK_FALSE(a.handler.HasSendQueue());
+	CHECK(received == expected);
+}
+
+#ifdef WITH_NETWORK_IO_THREAD
+TEST_CASE("NetworkIOThread - exchange packets")
+{
+	SocketPairHandler a;
+	REQUIRE(NetworkIOThread::Attach(&a.handler));
+
+	/* Packets sent by the handler arrive at the other end. */
+	std::vector<byte> expected, received;
+	for (uint i = 0; i < 100; i++) {
+		SharedPacket p = Packet::Share(CreateTestPacket((PacketType)i, i * 13));
+		AppendExpected(expected, *p);
+		a.handler.SendPacket(p);
+	}
+	for (int rounds = 0; received.size() < expected.size(); rounds++) {
+		REQUIRE(rounds < 10000);
+		a.handler.SendPackets();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		a.Drain(received);
+	}
+	CHECK(received == expected);
+
+	/* Packets written at the other end are handed to the handler by the network thread. */
+	for (uint i = 0; i < 10; i++) {
+		std::unique_ptr<Packet> p = CreateTestPacket((PacketType)i, i * 100);
+		p->PrepareToSend();
+		REQUIRE(send(a.reader, p->GetBufferData(), p->Size(), 0) == (ssize_t)p->Size());
+	}
+	for (uint i = 0, rounds = 0; i < 10;) {
+		REQUIRE(++rounds < 10000);
+		std::unique_ptr<Packet> p = a.handler.ReceivePacket();
+		if (p == nullptr) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+		CHECK(p->GetPacketType() == i);
+		CHECK(p->Size() == sizeof(PacketSize) + sizeof(PacketType) + i * 100);
+		i++;
+	}
+
+	/* Closing the handler makes the network thread close the socket. */
+	a.handler.CloseSocket();
+	CHECK(a.handler.io == nullptr);
+	NetworkIOThread::Stop();
+	byte buffer[1];
+	CHECK(recv(a.reader, buffer, sizeof(buffer), 0) == 0);
+}
+#endif /* WITH_NETWORK_IO_THREAD */
+
+#endif /* UNIX */
@@ -0,0 +1,273 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file newgrf_bytecode.cpp Test the bytecode of deterministic sprite groups against evaluating their adjusts. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../newgrf_internal.h"
+
+#include <array>
+#include <chrono>
+#include <random>
+
+/** Scope with made up variables, which stand in for the variables of the resolved object. */
+struct TestScopeResolver : ScopeResolver {
+	std::array<uint32_t, 16> vars{};
+	std::array<int32_t, 16> psa{};
+
+	TestScopeResolver(ResolverObject &ro) : ScopeResolver(ro) {}
+
+	uint32_t GetRandomBits() const override { return 0xA5; }
+	uint32_t GetTriggers() const override { return 0x3; }
+
+	uint32_t GetVariable(uint16_t variable, uint32_t parameter, GetVariableExtra *extra) const override
+	{
+		if (variable == 0x4F) {
+			extra->available = false;
+			return 0;
+		}
+		return this->vars[variable & 0xF] ^ (parameter * 0x9E3779B9);
+	}
+
+	void StorePSA(uint reg, int32_t value) override
+	{
+		this->psa[reg & 0xF] = value;
+	}
+};
+
+struct TestResolverObject : ResolverObject {
+	TestScopeResolver self_scope;
+
+	TestResolverObject(CallbackID callback, uint32_t param1, uint32_t param2) : ResolverObject(nullptr, callback, param1, param2), self_scope(*this) {}
+
+	ScopeResolver *GetScope(VarSpriteGroupScope scope = VSG_SCOPE_SELF, VarSpriteGroupScopeOffset relative = 0) override
+	{
+		return &this->self_scope;
+	}
+};
+
+/** Generator of random groups, which only do what can be evaluated the same way twice. */
+struct TestGroupGenerator {
+	std::mt19937 rng;
+	std::vector<DeterministicSpriteGroup *> procedures;
+
+	TestGroupGenerator(uint32_t seed) : rng(seed) {}
+
+	uint32_t Random(uint32_t limit) { return this->rng() % limit; }
+
+	DeterministicSpriteGroupAdjust MakeAdjust(bool allow_procedures)
+	{
+		static const DeterministicSpriteGroupAdjustOperation ops[] = {
+			DSGA_OP_ADD, DSGA_OP_SUB, DSGA_OP_SMIN, DSGA_OP_SMAX, DSGA_OP_UMIN, DSGA_OP_UMAX, DSGA_OP_SDIV, DSGA_OP_SMOD, DSGA_OP_UDIV, DSGA_OP_UMOD,
+			DSGA_OP_MUL, DSGA_OP_AND, DSGA_OP_OR, DSGA_OP_XOR, DSGA_OP_STO, DSGA_OP_RST, DSGA_OP_STOP, DSGA_OP_ROR, DSGA_OP_SCMP, DSGA_OP_UCMP,
+			DSGA_OP_SHL, DSGA_OP_SHR, DSGA_OP_SAR, DSGA_OP_TERNARY, DSGA_OP_EQ, DSGA_OP_SLT, DSGA_OP_SGE, DSGA_OP_SLE, DSGA_OP_SGT, DSGA_OP_RSUB,
+			DSGA_OP_STO_NC, DSGA_OP_ABS, DSGA_OP_NOOP,
+		};
+		static const uint16_t variables[] = {
+			0x01, 0x03, 0x0C, 0x10, 0x18, 0x1A, 0x1A, 0x1A, 0x1C, 0x30, 0x40, 0x41, 0x42, 0x43, 0x46, 0x4F, 0x5F, 0x60, 0x7B, 0x7D, 0x7D, 0x7E, 0x7F,
+		};
+
+		DeterministicSpriteGroupAdjust adjust{};
+		adjust.operation = ops[this->Random(lengthof(ops))];
+		adjust.variable = variables[this->Random(lengthof(variables))];
+		if (adjust.variable == 0x4F && this->Random(4) != 0) adjust.variable = 0x44;
+		if (adjust.variable == 0x7E && (!allow_procedures || this->procedures.empty())) adjust.variable = 0x1A;
+		adjust.parameter = this->Random(0x100);
+		if (adjust.variable == 0x7B) adjust.parameter = (this->Random(2) == 0) ? 0x7D : 0x60;
+		adjust.shift_num = this->Random(4) == 0 ? this->Random(32) : 0;
+		adjust.and_mask = this->Random(2) == 0 ? 0xFFFFFFFF : this->rng();
+		adjust.type = (DeterministicSpriteGroupAdjustType)this->Random(5);
+		adjust.add_val = this->Random(2) == 0 ? this->Random(100) : this->rng();
+		adjust.divmod_val = 1 + this->Random(100);
+		if (adjust.type == DSGA_TYPE_DIV || adjust.type == DSGA_TYPE_MOD) {
+			/* Avoid signed overflows */
+			adjust.and_mask &= 0xFFFF;
+			adjust.add_val = this->Random(100);
+		}
+		if (adjust.operation == DSGA_OP_SDIV || adjust.operation == DSGA_OP_SMOD) {
+			/* Avoid dividing the most negative number by -1 */
+			adjust.type = DSGA_TYPE_NONE;
+			adjust.and_mask &= 0x7F;
+		}
+		if (adjust.operation == DSGA_OP_STO_NC) {
+			/* The register is in divmod_val */
+			adjust.type = DSGA_TYPE_NONE;
+			adjust.divmod_val = this->Random(0x110);
+		}
+		if (adjust.variable == 0x7E) adjust.subroutine = this->procedures[this->Random((uint32_t)this->procedures.size())];
+		if (this->Random(8) == 0) adjust.adjust_flags = (DeterministicSpriteGroupAdjustFlags)(1 + this->Random(3));
+		return adjust;
+	}
+
+	DeterministicSpriteGroup *MakeGroup(bool allow_procedures)
+	{
+		DeterministicSpriteGroup *group = new DeterministicSpriteGroup();
+		group->feature = GSF_TRAINS;
+		group->var_scope = VSG_SCOPE_SELF;
+		group->var_scope_count = 0;
+		group->size = (DeterministicSpriteGroupSize)this->Random(3);
+		group->calculated_result = true;
+		group->default_group = nullptr;
+		group->error_group = nullptr;
+
+		uint count = 1 + this->Random(12);
+		for (uint i = 0; i < count; i++) group->adjusts.push_back(this->MakeAdjust(allow_procedures));
+
+		/* Jumps over some of the following adjusts */
+		for (uint i = 0; i < count; i++) {
+			DeterministicSpriteGroupAdjust &adjust = group->adjusts[i];
+			if (adjust.variable == 0x7E || this->Random(6) != 0) continue;
+			adjust.operation = (DeterministicSpriteGroupAdjustOperation)(DSGA_OP_JZ + this->Random(4));
+			adjust.jump = this->Random(count - i);
+		}
+		return group;
+	}
+
+	/** Make some procedures, and groups calling them. */
+	std::vector<DeterministicSpriteGroup *> MakeGroups(uint count)
+	{
+		std::vector<DeterministicSpriteGroup *> groups;
+		for (uint i = 0; i < count; i++) {
+			REQUIRE(SpriteGroup::CanAllocateItem());
+			if (i < count / 4) {
+				this->procedures.push_back(this->MakeGroup(false));
+				groups.push_back(this->procedures.back());
+			} else {
+				groups.push_back(this->MakeGroup(true));
+			}
+		}
+		return groups;
+	}
+};
+
+/** A recorded call of the resolver, with the state of the object it resolved for. */
+struct RecordedResolve {
+	const DeterministicSpriteGroup *group;
+	CallbackID callback;
+	uint32_t param1;
+	uint32_t param2;
+	std::array<uint32_t, 16> vars;
+};
+
+/** Result of a resolve, with all side effects. */
+struct ResolveOutcome {
+	uint16_t result;
+	uint32_t last_value;
+	std::array<int32_t, 16> psa;
+	std::array<int32_t, 0x110> temp;
+
+	bool operator==(const ResolveOutcome &other) const
+	{
+		return this->result == other.result && this->last_value == other.last_value && this->psa == other.psa && this->temp == other.temp;
+	}
+};
+
+static ResolveOutcome Replay(const RecordedResolve &call)
+{
+	TestResolverObject object(call.callback, call.param1, call.param2);
+	object.self_scope.vars = call.vars;
+	object.root_spritegroup = call.group;
+
+	ResolveOutcome outcome;
+	outcome.result = object.ResolveCallback();
+	outcome.last_value = object.last_value;
+	outcome.psa = object.self_scope.psa;
+	for (uint i = 0; i < outcome.temp.size(); i++) outcome.temp[i] = GetRegister(i);
+	return outcome;
+}
+
+static std::vector<RecordedResolve> RecordResolves(std::mt19937 &rng, const std::vector<DeterministicSpriteGroup *> &groups, uint count)
+{
+	std::vector<RecordedResolve> calls(count);
+	for (RecordedResolve &call : calls) {
+		call.group = groups[rng() % groups.size()];
+		call.callback = (CallbackID)(rng() % 0x160);
+		call.param1 = (rng() % 2 == 0) ? rng() % 16 : rng();
+		call.param2 = rng() % 4;
+		for (uint32_t &var : call.vars) var = (rng() % 2 == 0) ? rng() % 256 : rng();
+	}
+	return calls;
+}
+
+static void SetBytecode(const std::vector<DeterministicSpriteGroup *> &groups, bool lowered)
+{
+	for (DeterministicSpriteGroup *group : groups) {
+		if (lowered) {
+			OptimiseVarAction2DeterministicSpriteGroupLowerBytecode(group);
+		} else {
+			group->bytecode.clear();
+		}
+	}
+}
+
+TEST_CASE("NewGRF bytecode - same results as the adjusts")
+{
+	TestGroupGenerator generator(1234);
+	std::vector<DeterministicSpriteGroup *> groups = generator.MakeGroups(400);
+	std::mt19937 rng(42);
+	std::vector<RecordedResolve> calls = RecordResolves(rng, groups, 20000);
+
+	SetBytecode(groups, false);
+	std::vector<ResolveOutcome> expected;
+	for (const RecordedResolve &call : calls) expected.push_back(Replay(call));
+
+	SetBytecode(groups, true);
+	uint lowered = 0;
+	for (const DeterministicSpriteGroup *group : groups) {
+		if (!group->bytecode.empty()) lowered++;
+	}
+	CHECK(lowered == groups.size());
+
+	uint mismatches = 0;
+	for (size_t i = 0; i < calls.size(); i++) {
+		if (!(Replay(calls[i]) == expected[i])) mismatches++;
+	}
+	CHECK(mismatches == 0);
+
+	_spritegroup_pool.CleanPool();
+}
+
+/**
+ * Compare resolving a recorded set of resolver calls by evaluating the adjusts and by running the bytecode.
+ * Run with: openttd_test "[.benchmark]"
+ */
+TEST_CASE("NewGRF bytecode - benchmark", "[.benchmark]")
+{
+	static const uint CALLS = 1000000;
+
+	TestGroupGenerator generator(5678);
+	std::vector<DeterministicSpriteGroup *> groups = generator.MakeGroups(2000);
+	std::mt19937 rng(42);
+	std::vector<RecordedResolve> calls = RecordResolves(rng, groups, CALLS);
+
+	auto time = [&](bool lowered) {
+		SetBytecode(groups, lowered);
+		uint64_t sum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (const RecordedResolve &call : calls) {
+			TestResolverObject object(call.callback, call.param1, call.param2);
+			object.self_scope.vars = call.vars;
+			object.root_spritegroup = call.group;
+			sum += object.ResolveCallback() + object.last_value;
+		}
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		return std::make_pair(sum, ns / CALLS);
+	};
+
+	size_t adjusts = 0;
+	for (const DeterministicSpriteGroup *group : groups) adjusts += group->adjusts.size();
+
+	auto plain = time(false);
+	auto bytecode = time(true);
+	CHECK(plain.first == bytecode.first);
+	WARN(groups.size() << " groups, " << adjusts << " adjusts: adjusts: " << plain.second << " ns, bytecode: " << bytecode.second << " ns per resolve");
+
+	_spritegroup_pool.CleanPool();
+}
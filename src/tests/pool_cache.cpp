@@ -0,0 +1,133 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file pool_cache.cpp Test the slab allocation of pools which cache their items. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/pool_func.hpp"
+
+#include <chrono>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+/** Item with the size of a cargo packet, in a pool which caches its items. */
+struct CachedItem;
+typedef Pool<CachedItem, uint32_t, 1024, 0x1000000, PT_NONE, true, false> CachedItemPool;
+static CachedItemPool _cached_item_pool("CachedItem");
+INSTANTIATE_POOL_METHODS(CachedItem)
+
+struct CachedItem : CachedItemPool::PoolItem<&_cached_item_pool> {
+	uint16_t count;
+	uint16_t hot[5];
+	uint32_t cold[4];
+	int64_t money;
+
+	CachedItem() : count(0) {}
+};
+
+/** Item with the size of a cargo packet, in a pool which allocates each of its items. */
+struct PlainItem;
+typedef Pool<PlainItem, uint32_t, 1024, 0x1000000, PT_NONE, false, false> PlainItemPool;
+static PlainItemPool _plain_item_pool("PlainItem");
+INSTANTIATE_POOL_METHODS(PlainItem)
+
+struct PlainItem : PlainItemPool::PoolItem<&_plain_item_pool> {
+	uint16_t count;
+	uint16_t hot[5];
+	uint32_t cold[4];
+	int64_t money;
+
+	PlainItem() : count(0) {}
+};
+
+TEST_CASE("Pool - cached items are allocated in slabs")
+{
+	std::vector<CachedItem *> items;
+	for (uint i = 0; i < 1024; i++) {
+		REQUIRE(CachedItem::CanAllocateItem());
+		items.push_back(new CachedItem());
+	}
+	for (uint i = 1; i < 1024; i++) {
+		CHECK(items[i] == items[i - 1] + 1);
+	}
+
+	/* Freed items are reused before a new slab is allocated. */
+	CachedItem *freed = items[10];
+	delete freed;
+	REQUIRE(CachedItem::CanAllocateItem());
+	items[10] = new CachedItem();
+	CHECK(items[10] == freed);
+	CHECK(items[10]->index == 10);
+
+	REQUIRE(CachedItem::CanAllocateItem());
+	CachedItem *next_slab = new CachedItem();
+	CHECK((next_slab < items.front() || next_slab > items.back()));
+	CHECK(_cached_item_pool.items == 1025);
+
+	_cached_item_pool.CleanPool();
+	CHECK(_cached_item_pool.items == 0);
+	REQUIRE(CachedItem::CanAllocateItem());
+	delete new CachedItem();
+	_cached_item_pool.CleanPool();
+}
+
+/** Bytes allocated from the heap, if the C library can tell. */
+static size_t HeapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	return mallinfo2().uordblks;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Compare allocating, walking and freeing items in slabs with doing so for each item on its own.
+ * Run with: openttd_test "[.benchmark]"
+ */
+TEST_CASE("Pool - slab benchmark", "[.benchmark]")
+{
+	static const uint ITEMS = 1000000;
+
+	auto time = [&](auto *type, const char *name) {
+		using Titem = std::remove_pointer_t<decltype(type)>;
+		std::vector<Titem *> items;
+		items.reserve(ITEMS);
+		size_t heap_start = HeapInUse();
+		REQUIRE(Titem::CanAllocateItem(ITEMS));
+
+		auto start = std::chrono::steady_clock::now();
+		for (uint i = 0; i < ITEMS; i++) {
+			Titem *item = new Titem();
+			item->count = i;
+			items.push_back(item);
+		}
+		auto allocated = std::chrono::steady_clock::now();
+		size_t bytes = (HeapInUse() - heap_start) / ITEMS;
+
+		uint64_t sum = 0;
+		for (const Titem *item : items) sum += item->count;
+		auto walked = std::chrono::steady_clock::now();
+
+		for (Titem *item : items) delete item;
+		auto freed = std::chrono::steady_clock::now();
+
+		auto ns = [](auto from, auto to) { return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() / (double)ITEMS; };
+		WARN(name << ": " << sizeof(Titem) << " byte items, " << bytes << " heap bytes per item: allocate " << ns(start, allocated) << " ns, walk " << ns(allocated, walked) << " ns, free " << ns(walked, freed) << " ns");
+		return sum;
+	};
+
+	CHECK(time((PlainItem *)nullptr, "malloc per item") == time((CachedItem *)nullptr, "slabs"));
+	_plain_item_pool.CleanPool();
+	_cached_item_pool.CleanPool();
+}
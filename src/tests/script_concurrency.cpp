@@ -0,0 +1,122 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file script_concurrency.cpp Test the serialisation of scripts which run concurrently. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../company_func.h"
+#include "../core/format.hpp"
+#include "../script/squirrel.hpp"
+
+#include <squirrel.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+static std::atomic<int> _natives_running = 0;
+static std::atomic<bool> _natives_overlapped = false;
+static std::atomic<bool> _natives_wrong_company = false;
+static uint _native_calls = 0; ///< Only changed with the lock held.
+
+/** Native function, which checks that it runs alone and as the company passed by the script. */
+static SQInteger TestNative(HSQUIRRELVM vm)
+{
+	if (_natives_running.fetch_add(1) != 0) _natives_overlapped = true;
+
+	SQInteger company;
+	sq_getinteger(vm, 2, &company);
+	if (company != _current_company) _natives_wrong_company = true;
+	_native_calls++;
+	std::this_thread::yield();
+
+	_natives_running.fetch_sub(1);
+	return 0;
+}
+
+TEST_CASE("Script concurrency - native calls are serialised")
+{
+	static const uint THREADS = 4;
+	static const uint CALLS = 2000;
+
+	const CompanyID old_company = _current_company;
+	std::array<bool, THREADS> results{};
+
+	auto run = [&](CompanyID company) {
+		Squirrel engine("test");
+		ScriptAllocatorScope alloc_scope(&engine);
+		engine.AddMethod("Native", &TestNative, 2, ".i");
+
+		HSQUIRRELVM vm = engine.GetVM();
+		std::string source = fmt::format("function Run() {{ local sum = 0; for (local i = 0; i < {}; i++) {{ sum += i * i; Native({}); }} return sum; }}", CALLS, (int)company);
+		if (SQ_FAILED(sq_compilebuffer(vm, source.c_str(), source.size(), "test", SQTrue))) return;
+		sq_pushroottable(vm);
+		if (SQ_FAILED(sq_call(vm, 1, SQFalse, SQTrue))) return;
+		sq_pop(vm, 1);
+
+		HSQOBJECT root;
+		sq_pushroottable(vm);
+		sq_getstackobj(vm, -1, &root);
+
+		SquirrelConcurrency::ThreadScope thread_scope(company);
+		results[company] = engine.CallMethod(root, "Run", -1) && !engine.HasScriptCrashed();
+		sq_pop(vm, 1);
+	};
+
+	std::vector<std::thread> threads;
+	for (uint i = 0; i < THREADS; i++) threads.emplace_back(run, (CompanyID)i);
+	for (std::thread &thread : threads) thread.join();
+	_current_company = old_company;
+
+	for (bool result : results) CHECK(result);
+	CHECK(_native_calls == THREADS * CALLS);
+	CHECK_FALSE(_natives_overlapped);
+	CHECK_FALSE(_natives_wrong_company);
+}
+
+/** Native function without the native call hook, which records whether it runs with the lock held. */
+static SQInteger TestUnhookedNative(HSQUIRRELVM vm)
+{
+	sq_pushbool(vm, SquirrelConcurrency::IsSerialised());
+	return 1;
+}
+
+TEST_CASE("Script concurrency - builtins run without the lock")
+{
+	const CompanyID old_company = _current_company;
+	Squirrel engine("test");
+	ScriptAllocatorScope alloc_scope(&engine);
+
+	HSQUIRRELVM vm = engine.GetVM();
+	sq_pushroottable(vm);
+	sq_pushstring(vm, "Unhooked", -1);
+	sq_newclosure(vm, &TestUnhookedNative, 0);
+	sq_newslot(vm, -3, SQFalse);
+	sq_pop(vm, 1);
+
+	std::string source = "function Run() { local a = []; a.append(1); return Unhooked() ? 1 : 0; }";
+	REQUIRE(SQ_SUCCEEDED(sq_compilebuffer(vm, source.c_str(), source.size(), "test", SQTrue)));
+	sq_pushroottable(vm);
+	REQUIRE(SQ_SUCCEEDED(sq_call(vm, 1, SQFalse, SQTrue)));
+	sq_pop(vm, 1);
+
+	HSQOBJECT root;
+	sq_pushroottable(vm);
+	sq_getstackobj(vm, -1, &root);
+	int result = -1;
+	{
+		SquirrelConcurrency::ThreadScope thread_scope(COMPANY_FIRST);
+		CHECK(engine.CallIntegerMethod(root, "Run", &result, -1));
+	}
+	sq_pop(vm, 1);
+	_current_company = old_company;
+
+	CHECK(result == 0);
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file spsc_queue.cpp Test functionality from core/spsc_queue.hpp */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/spsc_queue.hpp"
+
+#include <thread>
+
+TEST_CASE("spsc_queue - capacity")
+{
+	spsc_queue<int> queue(5);
+	CHECK(queue.capacity() == 8);
+	CHECK(queue.empty());
+
+	for (int i = 0; i < 8; i++) CHECK(queue.push(int{i}));
+	CHECK(queue.full());
+	CHECK_FALSE(queue.push(8));
+
+	int item;
+	for (int i = 0; i < 8; i++) {
+		CHECK(queue.pop(item));
+		CHECK(item == i);
+	}
+	CHECK_FALSE(queue.pop(item));
+	CHECK(queue.empty());
+}
+
+TEST_CASE("spsc_queue - producer and consumer threads")
+{
+	static const uint32_t COUNT = 200000;
+	spsc_queue<std::unique_ptr<uint32_t>> queue(64);
+
+	std::thread producer([&]() {
+		for (uint32_t i = 0; i < COUNT; i++) {
+			auto item = std::make_unique<uint32_t>(i);
+			while (!queue.push(std::move(item))) std::this_thread::yield();
+		}
+	});
+
+	uint32_t expected = 0;
+	bool in_order = true;
+	std::unique_ptr<uint32_t> item;
+	while (expected < COUNT) {
+		if (!queue.pop(item)) {
+			std::this_thread::yield();
+			continue;
+		}
+		if (item == nullptr || *item != expected) in_order = false;
+		expected++;
+	}
+	producer.join();
+
+	CHECK(in_order);
+	CHECK(queue.empty());
+}
@@ -0,0 +1,43 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file station_goods.cpp Test the tracking of the active goods entries of a station. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../station_base.h"
+
+TEST_CASE("StationGoods - only changed entries are active")
+{
+	StationGoods goods;
+	const StationGoods &const_goods = goods;
+	CHECK(goods.GetActiveCargos() == 0);
+
+	/* Reading doesn't activate an entry. */
+	CHECK(const_goods[3].IsIdle());
+	for (const GoodsEntry &ge : const_goods) CHECK(ge.IsIdle());
+	CHECK(goods.GetActiveCargos() == 0);
+
+	SetBit(goods[3].status, GoodsEntry::GES_ACCEPTANCE);
+	goods[40].rating = 0;
+	CHECK(goods.GetActiveCargos() == ((CargoTypes)1 << 3 | (CargoTypes)1 << 40));
+
+	/* Entries are only deactivated once they are idle again. */
+	goods.DeactivateIfIdle(3);
+	goods.DeactivateIfIdle(40);
+	CHECK(goods.GetActiveCargos() == ((CargoTypes)1 << 3 | (CargoTypes)1 << 40));
+
+	goods[40].rating = INITIAL_STATION_RATING;
+	goods.DeactivateIfIdle(40);
+	CHECK(goods.GetActiveCargos() == (CargoTypes)1 << 3);
+
+	/* Changing all entries at once activates all of them. */
+	for (GoodsEntry &ge : goods) ge.rating = 0;
+	CHECK(goods.GetActiveCargos() == ALL_CARGOTYPES);
+}
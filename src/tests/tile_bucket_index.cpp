@@ -0,0 +1,208 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tile_bucket_index.cpp Test functionality from core/tile_bucket_index.hpp */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/tile_bucket_index.hpp"
+#include "../3rdparty/robin_hood/robin_hood.h"
+
+#include <chrono>
+#include <random>
+#include <set>
+
+/** An item in the index, with the intrusive links of both the index and the hash chain to compare with. */
+struct TestItem {
+	uint32_t tile;
+	uint32_t pos;
+	TestItem *hash_next = nullptr;
+};
+
+using TestIndex = tile_bucket_index<TestItem, &TestItem::pos>;
+
+static const uint TEST_LOG_X = 8;
+static const uint TEST_SIZE_Y = 128;
+
+static uint32_t TestTileXY(uint x, uint y)
+{
+	return (y << TEST_LOG_X) | x;
+}
+
+static std::multiset<const TestItem *> ItemsOnTile(const TestIndex &index, uint32_t tile)
+{
+	std::multiset<const TestItem *> found;
+	index.for_each(tile, [&](TestItem *item) {
+		found.insert(item);
+		return false;
+	});
+	return found;
+}
+
+TEST_CASE("tile_bucket_index - insert and remove")
+{
+	TestIndex index;
+	index.reset(TEST_LOG_X, TEST_SIZE_Y);
+
+	std::vector<TestItem> items(100);
+	for (uint i = 0; i < items.size(); i++) {
+		/* Several items per tile, and several tiles per chunk. */
+		items[i].tile = TestTileXY(10 + (i % 7), 20 + (i % 3));
+		index.insert(items[i].tile, &items[i]);
+	}
+	CHECK(index.size() == items.size());
+
+	for (uint i = 0; i < items.size(); i += 2) {
+		index.remove(items[i].tile, &items[i]);
+	}
+	CHECK(index.size() == items.size() / 2);
+
+	for (uint i = 0; i < items.size(); i++) {
+		CHECK(index.contains(items[i].tile, &items[i]) == (i % 2 == 1));
+
+		std::multiset<const TestItem *> found = ItemsOnTile(index, items[i].tile);
+		for (const TestItem *item : found) CHECK(item->tile == items[i].tile);
+		CHECK((found.count(&items[i]) == 1) == (i % 2 == 1));
+	}
+
+	/* Move everything to another chunk, emptying the first one. */
+	for (uint i = 1; i < items.size(); i += 2) {
+		index.remove(items[i].tile, &items[i]);
+		items[i].tile = TestTileXY(200, 100);
+		index.insert(items[i].tile, &items[i]);
+	}
+	CHECK(ItemsOnTile(index, TestTileXY(10, 20)).empty());
+	CHECK(ItemsOnTile(index, TestTileXY(200, 100)).size() == items.size() / 2);
+}
+
+TEST_CASE("tile_bucket_index - area")
+{
+	TestIndex index;
+	index.reset(TEST_LOG_X, TEST_SIZE_Y);
+
+	/* One item on every tile of a band crossing chunk borders and the map edge. */
+	std::vector<TestItem> items;
+	for (uint y = 0; y < TEST_SIZE_Y; y++) {
+		for (uint x = (1 << TEST_LOG_X) - 20; x < (1U << TEST_LOG_X); x++) items.push_back({ TestTileXY(x, y), 0 });
+	}
+	for (TestItem &item : items) index.insert(item.tile, &item);
+
+	auto count_area = [&](int xl, int yl, int xu, int yu) {
+		uint count = 0;
+		index.for_each_in_area(xl, yl, xu, yu, [&](TestItem *item) {
+			uint x = item->tile & ((1 << TEST_LOG_X) - 1);
+			uint y = item->tile >> TEST_LOG_X;
+			CHECK((int)x >= xl);
+			CHECK((int)x <= xu);
+			CHECK((int)y >= yl);
+			CHECK((int)y <= yu);
+			count++;
+			return false;
+		});
+		return count;
+	};
+
+	CHECK(count_area(238, 14, 240, 18) == 3 * 5);
+	CHECK(count_area(250, 120, 300, 200) == 6 * 8);
+	CHECK(count_area(-5, -5, 10, 10) == 0);
+
+	/* Stopping the iteration. */
+	uint visited = 0;
+	CHECK(index.for_each_in_area(236, 0, 255, 127, [&](TestItem *) { return ++visited == 3; }));
+	CHECK(visited == 3);
+}
+
+/**
+ * Compare the lookups of the tile bucket index with a hash table of per tile chains, like the vehicle tile hash used to be.
+ * Run with: openttd_test "[.benchmark]"
+ */
+TEST_CASE("tile_bucket_index - lookup benchmark", "[.benchmark]")
+{
+	static const uint LOG_X = 12;
+	static const uint SIZE_Y = 4096;
+	static const uint ITEMS = 50000;
+	static const uint LOOKUPS = 500000;
+
+	/* Items clustered along lines, as vehicles on tracks and roads are. */
+	std::mt19937 rng(42);
+	std::vector<TestItem> items(ITEMS);
+	for (uint i = 0; i < ITEMS; i++) {
+		uint line = rng() % 400;
+		uint along = rng() % 4000;
+		items[i].tile = (line % 2 == 0) ? ((line * 10) << LOG_X) | along : (along << LOG_X) | (line * 10);
+	}
+
+	TestIndex index;
+	index.reset(LOG_X, SIZE_Y);
+	robin_hood::unordered_map<uint32_t, TestItem *> hash;
+	for (TestItem &item : items) {
+		index.insert(item.tile, &item);
+		auto res = hash.insert({ item.tile, &item });
+		if (!res.second) {
+			item.hash_next = res.first->second;
+			res.first->second = &item;
+		}
+	}
+
+	/* Lookups start at a random item, like the vehicles are ticked in pool order. */
+	std::vector<const TestItem *> origins(LOOKUPS);
+	for (const TestItem *&origin : origins) origin = &items[rng() % ITEMS];
+
+	auto hash_tile = [&](uint32_t tile, uint64_t &found) {
+		auto it = hash.find(tile);
+		if (it == hash.end()) return;
+		for (const TestItem *item = it->second; item != nullptr; item = item->hash_next) found += item->tile;
+	};
+	auto index_tile = [&](uint32_t tile, uint64_t &found) {
+		index.for_each(tile, [&](TestItem *item) {
+			found += item->tile;
+			return false;
+		});
+	};
+
+	auto run = [&](const char *name, auto hash_lookup, auto index_lookup) {
+		auto time = [&](auto lookup) {
+			uint64_t found = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (const TestItem *origin : origins) lookup(origin->tile, found);
+			auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			return std::make_pair(found, ns / LOOKUPS);
+		};
+		auto hash_result = time(hash_lookup);
+		auto index_result = time(index_lookup);
+		CHECK(hash_result.first == index_result.first);
+		WARN(name << ": hash table: " << hash_result.second << " ns, tile bucket index: " << index_result.second << " ns per lookup, " << ITEMS << " items");
+	};
+
+	/* A single tile, like the occupancy checks of signals and tunnels. */
+	run("tile", hash_tile, index_tile);
+
+	/* The tiles ahead, like reservation and blocking checks. */
+	run("4 tiles ahead", [&](uint32_t tile, uint64_t &found) {
+		for (uint i = 0; i < 4; i++) hash_tile(tile + i, found);
+	}, [&](uint32_t tile, uint64_t &found) {
+		for (uint i = 0; i < 4; i++) index_tile(tile + i, found);
+	});
+
+	/* The 2x2 tiles around a position, like the collision checks. */
+	run("2x2 area", [&](uint32_t tile, uint64_t &found) {
+		uint x = tile & ((1 << LOG_X) - 1);
+		uint y = tile >> LOG_X;
+		for (uint dy = 0; dy < 2; dy++) {
+			for (uint dx = 0; dx < 2; dx++) hash_tile(((y + dy) << LOG_X) | (x + dx), found);
+		}
+	}, [&](uint32_t tile, uint64_t &found) {
+		int x = tile & ((1 << LOG_X) - 1);
+		int y = tile >> LOG_X;
+		index.for_each_in_area(x, y, x + 1, y + 1, [&](TestItem *item) {
+			found += item->tile;
+			return false;
+		});
+	});
+}
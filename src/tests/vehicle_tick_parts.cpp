@@ -0,0 +1,91 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file vehicle_tick_parts.cpp Benchmark the per part loops of the vehicle ticks. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../train.h"
+#include INCLUDE_FOR_PREFETCH_NTA
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+
+extern void VehicleTickCargoAging(Vehicle *v);
+
+/**
+ * Compare walking the parts of consists through their chain pointers with walking a flattened array of the parts,
+ * as the tick loops of CallVehicleTicks do with their part caches.
+ * The parts of each consist are taken at random from the pool, like in a game which has been running for a while.
+ * Run with: openttd_test "[.benchmark]"
+ */
+TEST_CASE("Vehicle tick parts - benchmark", "[.benchmark]")
+{
+	static const uint CONSISTS = 10000;
+	static const uint PARTS = 5;
+	static const uint TICKS = 20;
+	static const uint PREFETCH = 4;
+
+	REQUIRE(Vehicle::CanAllocateItem(CONSISTS * PARTS));
+	std::vector<Train *> vehicles;
+	for (uint i = 0; i < CONSISTS * PARTS; i++) {
+		Train *t = new Train();
+		t->vcache.cached_cargo_age_period = 185;
+		vehicles.push_back(t);
+	}
+	std::shuffle(vehicles.begin(), vehicles.end(), std::mt19937(1234));
+
+	std::vector<Train *> fronts;
+	std::vector<Train *> parts;
+	for (uint c = 0; c < CONSISTS; c++) {
+		Train *front = vehicles[c * PARTS];
+		for (uint p = 1; p < PARTS; p++) vehicles[c * PARTS + p - 1]->SetNext(vehicles[c * PARTS + p]);
+		fronts.push_back(front);
+		for (Train *u = front; u != nullptr; u = u->Next()) parts.push_back(u);
+	}
+
+	auto tick_part = [](Train *u) {
+		u->tick_counter++;
+		VehicleTickCargoAging(u);
+	};
+	auto ns_per_part = [](auto from, auto to) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() / (double)(CONSISTS * PARTS * TICKS);
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint tick = 0; tick < TICKS; tick++) {
+		for (Train *front : fronts) {
+			for (Train *u = front; u != nullptr; u = u->Next()) tick_part(u);
+		}
+	}
+	auto chained = std::chrono::steady_clock::now();
+	for (uint tick = 0; tick < TICKS; tick++) {
+		for (size_t i = 0; i < parts.size(); i++) {
+			if (i + PREFETCH < parts.size()) PREFETCH_WRITE(&(parts[i + PREFETCH]->motion_counter));
+			tick_part(parts[i]);
+		}
+	}
+	auto flattened = std::chrono::steady_clock::now();
+
+	for (const Train *u : parts) CHECK(u->tick_counter == 2 * TICKS);
+
+	/* The cache lines of a part which the per part loops touch. */
+	const Train *t = parts.front();
+	auto line = [t](const void *field) { return ((const char *)field - (const char *)t) / 64; };
+	std::set<ptrdiff_t> lines = { line(&t->motion_counter), line(&t->cargo_age_counter), line(&t->tick_counter), line(&t->vehstatus),
+			line(&t->subtype), line(&t->vcache.cached_cargo_age_period) };
+
+	WARN(CONSISTS << " consists of " << PARTS << " parts, " << sizeof(Train) << " bytes per part, hot fields in " << lines.size() << " cache lines: chain pointers "
+			<< ns_per_part(start, chained) << " ns, flattened parts " << ns_per_part(chained, flattened) << " ns per part");
+
+	_vehicle_pool.CleanPool();
+}
@@ -0,0 +1,62 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file worker_thread.cpp Test functionality from worker_thread.h */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../worker_thread.h"
+
+#include <atomic>
+#include <vector>
+
+TEST_CASE("WorkerThreadPool - ParallelFor")
+{
+	WorkerThreadPool pool;
+	pool.Start("test:worker", 4);
+
+	std::vector<std::atomic<uint>> visits(10007);
+	pool.ParallelFor(3, visits.size(), 64, [&](size_t begin, size_t end) {
+		CHECK(end - begin <= 64);
+		for (size_t i = begin; i < end; i++) visits[i]++;
+	});
+
+	for (size_t i = 0; i < visits.size(); i++) {
+		CHECK(visits[i].load() == (i < 3 ? 0 : 1));
+	}
+
+	pool.Stop();
+}
+
+TEST_CASE("WorkerThreadPool - nested task groups")
+{
+	WorkerThreadPool pool;
+	pool.Start("test:worker", 4);
+
+	std::atomic<uint> count = 0;
+	{
+		WorkerTaskGroup outer(pool);
+		for (uint i = 0; i < 16; i++) {
+			outer.Run([&]() {
+				WorkerTaskGroup inner(pool);
+				for (uint j = 0; j < 16; j++) inner.Run([&]() { count++; });
+				inner.Wait();
+				count++;
+			});
+		}
+		outer.Wait();
+		CHECK(count.load() == 16 * 17);
+
+		/* A group can be reused after waiting. */
+		outer.Run([&]() { count++; });
+	}
+	CHECK(count.load() == 16 * 17 + 1);
+
+	pool.Stop();
+}
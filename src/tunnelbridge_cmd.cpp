@@ -22,6 +22,7 @@
 #include "roadveh.h"
 #include "pathfinder/yapf/yapf_cache.h"
 #include "pathfinder/water_regions.h"
+#include "pathfinder/road_regions.h"
 #include "newgrf_sound.h"
 #include "autoslope.h"
 #include "tunnelbridge_map.h"
@@ -769,6 +770,8 @@ CommandCost CmdBuildBridge(TileIndex end_tile, DoCommandFlag flags, uint32_t p1,
 				};
 				make_bridge_ramp(tile_start, dir);
 				make_bridge_ramp(tile_end, ReverseDiagDir(dir));
+				InvalidateRoadRegion(tile_start);
+				InvalidateRoadRegion(tile_end);
 				AddRoadTunnelBridgeInfrastructure(tile_start, tile_end);
 				if (RoadLayoutChangeNotificationEnabled(true)) {
 					if (IsRoadCustomBridgeHead(tile_start) || IsRoadCustomBridgeHead(tile_end)) {
@@ -1146,6 +1149,8 @@ CommandCost CmdBuildTunnel(TileIndex start_tile, DoCommandFlag flags, uint32_t p
 			RoadType tram_rt = RoadTypeIsTram(roadtype) ? roadtype : INVALID_ROADTYPE;
 			MakeRoadTunnel(start_tile, company, t->index, direction,                 road_rt, tram_rt);
 			MakeRoadTunnel(end_tile,   company, t->index, ReverseDiagDir(direction), road_rt, tram_rt);
+			InvalidateRoadRegion(start_tile);
+			InvalidateRoadRegion(end_tile);
 			UpdateRoadCachedOneWayStatesAroundTile(start_tile);
 			UpdateRoadCachedOneWayStatesAroundTile(end_tile);
 		}
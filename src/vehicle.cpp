@@ -41,6 +41,7 @@
 #include "core/random_func.hpp"
 #include "core/backup_type.hpp"
 #include "core/container_func.hpp"
+#include "core/tile_bucket_index.hpp"
 #include "infrastructure_func.h"
 #include "order_backup.h"
 #include "sound_func.h"
@@ -62,9 +63,11 @@
 #include "debug_settings.h"
 #include "network/network_sync.h"
 #include "pathfinder/water_regions.h"
+#include "pathfinder/road_regions.h"
+#include "pathfinder/rail_regions.h"
 #include "3rdparty/cpp-btree/btree_set.h"
 #include "3rdparty/cpp-btree/btree_map.h"
-#include "3rdparty/robin_hood/robin_hood.h"
+#include INCLUDE_FOR_PREFETCH_NTA
 
 #include "table/strings.h"
 
@@ -476,33 +479,33 @@ Vehicle::Vehicle(VehicleType type)
 	this->vcache.cached_veh_flags = 0;
 }
 
-using VehicleTypeTileHash = robin_hood::unordered_map<TileIndex, VehicleID>;
-static std::array<VehicleTypeTileHash, 4> _vehicle_tile_hashes;
+using VehicleTypeTileIndex = tile_bucket_index<Vehicle, &Vehicle::hash_tile_pos>;
+static std::array<VehicleTypeTileIndex, 4> _vehicle_tile_indices;
 
-static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
+/** Remove all vehicles from the tile location index, and size it for the current map. */
+static void ResetVehicleTileIndices()
 {
-	VehicleTypeTileHash &vhash = _vehicle_tile_hashes[type];
-
-	for (int y = yl; ; y++) {
-		for (int x = xl; ; x++) {
-			auto iter = vhash.find(TileXY(x, y));
-			if (iter != vhash.end()) {
-				Vehicle *v = Vehicle::Get(iter->second);
-				do {
-					Vehicle *a = proc(v, data);
-					if (find_first && a != nullptr) return a;
-
-					v = v->hash_tile_next;
-				} while (v != nullptr);
-			}
-			if (x == xu) break;
-		}
-		if (y == yu) break;
+	for (Vehicle *v : Vehicle::Iterate()) {
+		v->hash_tile_current = INVALID_TILE;
+	}
+	for (VehicleTypeTileIndex &index : _vehicle_tile_indices) {
+		index.reset(MapLogX(), MapSizeY());
 	}
-
-	return nullptr;
 }
 
+static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
+{
+	Vehicle *found = nullptr;
+	_vehicle_tile_indices[type].for_each_in_area(xl, yl, xu, yu, [&](Vehicle *v) {
+		Vehicle *a = proc(v, data);
+		if (find_first && a != nullptr) {
+			found = a;
+			return true;
+		}
+		return false;
+	});
+	return found;
+}
 
 /**
  * Helper function for FindVehicleOnPos/HasVehicleOnPos.
@@ -540,20 +543,16 @@ Vehicle *VehicleFromPosXY(int x, int y, VehicleType type, void *data, VehicleFro
  */
 Vehicle *VehicleFromPos(TileIndex tile, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	VehicleTypeTileHash &vhash = _vehicle_tile_hashes[type];
-
-	auto iter = vhash.find(tile);
-	if (iter != vhash.end()) {
-		Vehicle *v = Vehicle::Get(iter->second);
-		do {
-			Vehicle *a = proc(v, data);
-			if (find_first && a != nullptr) return a;
-
-			v = v->hash_tile_next;
-		} while (v != nullptr);
-	}
-
-	return nullptr;
+	Vehicle *found = nullptr;
+	_vehicle_tile_indices[type].for_each(tile, [&](Vehicle *v) {
+		Vehicle *a = proc(v, data);
+		if (find_first && a != nullptr) {
+			found = a;
+			return true;
+		}
+		return false;
+	});
+	return found;
 }
 
 /**
@@ -854,39 +853,12 @@ void UpdateVehicleTileHash(Vehicle *v, bool remove)
 
 	if (old_hash_tile == new_hash_tile) return;
 
-	VehicleTypeTileHash &vhash = _vehicle_tile_hashes[v->type];
-
-	/* Remove from the old position in the hash table */
-	if (old_hash_tile != INVALID_TILE) {
-		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = v->hash_tile_prev;
-		if (v->hash_tile_prev != nullptr) {
-			v->hash_tile_prev->hash_tile_next = v->hash_tile_next;
-		} else {
-			/* This was the first vehicle in the chain */
-			if (v->hash_tile_next != nullptr) {
-				vhash[old_hash_tile] = v->hash_tile_next->index;
-			} else {
-				vhash.erase(old_hash_tile);
-			}
-		}
-	}
+	VehicleTypeTileIndex &index = _vehicle_tile_indices[v->type];
+	/* The index is sized for the map by ResetVehicleHash, which runs whenever the map is allocated. */
+	assert(index.matches(MapLogX(), MapSizeY()));
 
-	/* Insert vehicle at beginning of the new position in the hash table */
-	if (new_hash_tile != INVALID_TILE) {
-		auto res = vhash.insert({ new_hash_tile, v->index });
-		if (res.second) {
-			/* Insert took place */
-			v->hash_tile_next = nullptr;
-			v->hash_tile_prev = nullptr;
-		} else {
-			/* Key already existed */
-			Vehicle *next = Vehicle::Get(res.first->second);
-			next->hash_tile_prev = v;
-			v->hash_tile_next = next;
-			v->hash_tile_prev = nullptr;
-			res.first->second = v->index;
-		}
-	}
+	if (old_hash_tile != INVALID_TILE) index.remove(old_hash_tile, v);
+	if (new_hash_tile != INVALID_TILE) index.insert(new_hash_tile, v);
 
 	/* Remember current hash tile */
 	v->hash_tile_current = new_hash_tile;
@@ -903,14 +875,7 @@ bool ValidateVehicleTileHash(const Vehicle *v)
 
 	if (v->hash_tile_current != v->tile) return false;
 
-	auto iter = _vehicle_tile_hashes[v->type].find(v->hash_tile_current);
-	if (iter == _vehicle_tile_hashes[v->type].end()) return false;
-
-	for (const Vehicle *u = Vehicle::GetIfValid(iter->second); u != nullptr; u = u->hash_tile_next) {
-		if (u == v) return true;
-	}
-
-	return false;
+	return _vehicle_tile_indices[v->type].contains(v->hash_tile_current, v);
 }
 
 static Vehicle *_vehicle_viewport_hash[1 << (GEN_HASHX_BITS + GEN_HASHY_BITS)];
@@ -986,15 +951,8 @@ static void ProcessDeferredUpdateVehicleViewportHashes()
 
 void ResetVehicleHash()
 {
-	for (Vehicle *v : Vehicle::Iterate()) {
-		v->hash_tile_next = nullptr;
-		v->hash_tile_prev = nullptr;
-		v->hash_tile_current = INVALID_TILE;
-	}
+	ResetVehicleTileIndices();
 	memset(_vehicle_viewport_hash, 0, sizeof(_vehicle_viewport_hash));
-	for (VehicleTypeTileHash &vhash : _vehicle_tile_hashes) {
-		vhash.clear();
-	}
 }
 
 void ResetVehicleColourMap()
@@ -1382,6 +1340,72 @@ std::vector<Aircraft *> _tick_aircraft_front_cache;
 std::vector<Ship *> _tick_ship_cache;
 std::vector<Vehicle *> _tick_other_veh_cache;
 
+/** Number of parts ahead to prefetch when iterating a VehicleTickPartCache. */
+static const uint VEHICLE_TICK_PART_PREFETCH = 4;
+
+/**
+ * Flattened parts of the consists in a front vehicle tick cache.
+ * This is kept in step with the tick caches, such that the per part loops in CallVehicleTicks
+ * can walk a contiguous array, and prefetch upcoming parts, instead of following the chain pointers of each vehicle.
+ */
+template <typename T>
+struct VehicleTickPartCache {
+	std::vector<T *> parts;         ///< Parts of all consists, in front cache order and then chain order.
+	std::vector<uint32_t> part_end; ///< For each consist in the front cache, the index in parts after its last part.
+
+	void Clear()
+	{
+		this->parts.clear();
+		this->part_end.clear();
+	}
+
+	void Rebuild(const std::vector<T *> &fronts)
+	{
+		this->Clear();
+		this->part_end.reserve(fronts.size());
+		for (T *front : fronts) {
+			for (T *u = front; u != nullptr; u = u->Next()) {
+				this->parts.push_back(u);
+			}
+			this->part_end.push_back((uint32_t)this->parts.size());
+		}
+	}
+
+	bool operator==(const VehicleTickPartCache<T> &other) const
+	{
+		return this->parts == other.parts && this->part_end == other.part_end;
+	}
+
+	/**
+	 * Call a procedure for each part of a consist in the front cache.
+	 * If the tick caches have been invalidated since they were last built, the chain pointers are used instead.
+	 * @param fronts Front cache which this part cache was built from.
+	 * @param index Index of the consist in the front cache.
+	 * @param proc Procedure to call for each part.
+	 */
+	template <typename F>
+	void IterateParts(const std::vector<T *> &fronts, uint32_t index, F proc) const
+	{
+		if (unlikely(!_tick_caches_valid)) {
+			for (T *u = fronts[index]; u != nullptr; u = u->Next()) {
+				proc(u);
+			}
+			return;
+		}
+
+		const uint32_t end = this->part_end[index];
+		for (uint32_t i = (index > 0) ? this->part_end[index - 1] : 0; i < end; i++) {
+			if (i + VEHICLE_TICK_PART_PREFETCH < this->parts.size()) PREFETCH_WRITE(&(this->parts[i + VEHICLE_TICK_PART_PREFETCH]->motion_counter));
+			proc(this->parts[i]);
+		}
+	}
+};
+
+static VehicleTickPartCache<Train> _tick_train_parts;
+static VehicleTickPartCache<RoadVehicle> _tick_road_veh_parts;
+static VehicleTickPartCache<Aircraft> _tick_aircraft_parts;
+static VehicleTickPartCache<Ship> _tick_ship_parts;
+
 std::vector<VehicleID> _remove_from_tick_effect_veh_cache;
 btree::btree_set<VehicleID> _tick_effect_veh_cache;
 
@@ -1392,6 +1416,10 @@ void ClearVehicleTickCaches()
 	_tick_road_veh_front_cache.clear();
 	_tick_aircraft_front_cache.clear();
 	_tick_ship_cache.clear();
+	_tick_train_parts.Clear();
+	_tick_road_veh_parts.Clear();
+	_tick_aircraft_parts.Clear();
+	_tick_ship_parts.Clear();
 	_tick_effect_veh_cache.clear();
 	_remove_from_tick_effect_veh_cache.clear();
 	_tick_other_veh_cache.clear();
@@ -1440,6 +1468,10 @@ void RebuildVehicleTickCaches()
 				break;
 		}
 	}
+	_tick_train_parts.Rebuild(_tick_train_front_cache);
+	_tick_road_veh_parts.Rebuild(_tick_road_veh_front_cache);
+	_tick_aircraft_parts.Rebuild(_tick_aircraft_front_cache);
+	_tick_ship_parts.Rebuild(_tick_ship_cache);
 	_tick_caches_valid = true;
 }
 
@@ -1461,6 +1493,10 @@ void ValidateVehicleTickCaches()
 		saved_tick_effect_veh_cache.erase(id);
 	}
 	std::vector<Vehicle *> saved_tick_other_veh_cache = std::move(_tick_other_veh_cache);
+	VehicleTickPartCache<Train> saved_tick_train_parts = std::move(_tick_train_parts);
+	VehicleTickPartCache<RoadVehicle> saved_tick_road_veh_parts = std::move(_tick_road_veh_parts);
+	VehicleTickPartCache<Aircraft> saved_tick_aircraft_parts = std::move(_tick_aircraft_parts);
+	VehicleTickPartCache<Ship> saved_tick_ship_parts = std::move(_tick_ship_parts);
 	saved_tick_other_veh_cache.erase(std::remove(saved_tick_other_veh_cache.begin(), saved_tick_other_veh_cache.end(), nullptr), saved_tick_other_veh_cache.end());
 
 	RebuildVehicleTickCaches();
@@ -1472,6 +1508,10 @@ void ValidateVehicleTickCaches()
 	assert(saved_tick_ship_cache == _tick_ship_cache);
 	assert(saved_tick_effect_veh_cache == _tick_effect_veh_cache);
 	assert(saved_tick_other_veh_cache == _tick_other_veh_cache);
+	assert(saved_tick_train_parts == _tick_train_parts);
+	assert(saved_tick_road_veh_parts == _tick_road_veh_parts);
+	assert(saved_tick_aircraft_parts == _tick_aircraft_parts);
+	assert(saved_tick_ship_parts == _tick_ship_parts);
 }
 
 void VehicleTickCargoAging(Vehicle *v)
@@ -1570,6 +1610,18 @@ void CallVehicleTicks()
 	if (HasChickenBit(DCBF_WATER_REGION_INIT_ALL)) {
 		DebugInitAllWaterRegions();
 	}
+	if (HasChickenBit(DCBF_ROAD_REGION_CLEAR)) {
+		DebugInvalidateAllRoadRegions();
+	}
+	if (HasChickenBit(DCBF_ROAD_REGION_INIT_ALL)) {
+		DebugInitAllRoadRegions();
+	}
+	if (HasChickenBit(DCBF_RAIL_REGION_CLEAR)) {
+		InvalidateAllRailRegions();
+	}
+	if (HasChickenBit(DCBF_RAIL_REGION_INIT_ALL)) {
+		DebugInitAllRailRegions();
+	}
 
 	Vehicle *v = nullptr;
 	SCOPE_INFO_FMT([&v], "CallVehicleTicks: %s", scope_dumper().VehicleInfo(v));
@@ -1598,50 +1650,54 @@ void CallVehicleTicks()
 			}
 		}
 		_tick_train_too_heavy_cache.clear();
-		for (Train *front : _tick_train_front_cache) {
+		for (uint32_t i = 0; i < (uint32_t)_tick_train_front_cache.size(); i++) {
+			Train *front = _tick_train_front_cache[i];
 			v = front;
 			if (!front->Train::Tick()) continue;
-			for (Train *u = front; u != nullptr; u = u->Next()) {
+			_tick_train_parts.IterateParts(_tick_train_front_cache, i, [front](Train *u) {
 				u->tick_counter++;
 				VehicleTickCargoAging(u);
 				if (!u->IsWagon() && !((front->vehstatus & VS_STOPPED) && front->cur_speed == 0)) VehicleTickMotion(u, front);
-			}
+			});
 		}
 	}
 	RecordSyncEvent(NSRE_VEH_TRAIN);
 	{
 		PerformanceMeasurer framerate(PFE_GL_ROADVEHS);
-		for (RoadVehicle *front : _tick_road_veh_front_cache) {
+		for (uint32_t i = 0; i < (uint32_t)_tick_road_veh_front_cache.size(); i++) {
+			RoadVehicle *front = _tick_road_veh_front_cache[i];
 			v = front;
 			if (!front->RoadVehicle::Tick()) continue;
-			for (RoadVehicle *u = front; u != nullptr; u = u->Next()) {
+			_tick_road_veh_parts.IterateParts(_tick_road_veh_front_cache, i, [](RoadVehicle *u) {
 				u->tick_counter++;
 				VehicleTickCargoAging(u);
-			}
+			});
 			if (!(front->vehstatus & VS_STOPPED)) VehicleTickMotion(front, front);
 		}
 	}
 	if (!_tick_road_veh_front_cache.empty()) RecordSyncEvent(NSRE_VEH_ROAD);
 	{
 		PerformanceMeasurer framerate(PFE_GL_AIRCRAFT);
-		for (Aircraft *front : _tick_aircraft_front_cache) {
+		for (uint32_t i = 0; i < (uint32_t)_tick_aircraft_front_cache.size(); i++) {
+			Aircraft *front = _tick_aircraft_front_cache[i];
 			v = front;
 			if (!front->Aircraft::Tick()) continue;
-			for (Aircraft *u = front; u != nullptr; u = u->Next()) {
+			_tick_aircraft_parts.IterateParts(_tick_aircraft_front_cache, i, [](Aircraft *u) {
 				VehicleTickCargoAging(u);
-			}
+			});
 			if (!(front->vehstatus & VS_STOPPED)) VehicleTickMotion(front, front);
 		}
 	}
 	if (!_tick_aircraft_front_cache.empty()) RecordSyncEvent(NSRE_VEH_AIR);
 	{
 		PerformanceMeasurer framerate(PFE_GL_SHIPS);
-		for (Ship *s : _tick_ship_cache) {
+		for (uint32_t i = 0; i < (uint32_t)_tick_ship_cache.size(); i++) {
+			Ship *s = _tick_ship_cache[i];
 			v = s;
 			if (!s->Ship::Tick()) continue;
-			for (Ship *u = s; u != nullptr; u = u->Next()) {
+			_tick_ship_parts.IterateParts(_tick_ship_cache, i, [](Ship *u) {
 				VehicleTickCargoAging(u);
-			}
+			});
 			if (!(s->vehstatus & VS_STOPPED)) VehicleTickMotion(s, s);
 		}
 	}
@@ -306,8 +306,7 @@ public:
 	Vehicle *hash_viewport_next;        ///< NOSAVE: Next vehicle in the visual location hash.
 	Vehicle **hash_viewport_prev;       ///< NOSAVE: Previous vehicle in the visual location hash.
 
-	Vehicle *hash_tile_next;            ///< NOSAVE: Next vehicle in the tile location hash.
-	Vehicle *hash_tile_prev;            ///< NOSAVE: Previous vehicle in the tile location hash.
+	uint32_t hash_tile_pos;             ///< NOSAVE: Position in the bucket of the tile location index.
 	TileIndex hash_tile_current = INVALID_TILE; ///< NOSAVE: current tile used for tile location hash.
 
 	byte breakdown_severity;            ///< severity of the breakdown. Note that lower means more severe
@@ -357,7 +356,6 @@ public:
 	uint16_t cur_speed;                 ///< current speed
 	byte subspeed;                      ///< fractional speed
 	byte acceleration;                  ///< used by train & aircraft
-	uint32_t motion_counter;            ///< counter to occasionally play a vehicle sound. (Also used as virtual train client ID).
 	byte progress;                      ///< The percentage (if divided by 256) this vehicle already crossed the tile unit.
 
 	uint16_t random_bits;               ///< Bits used for randomized variational spritegroups.
@@ -372,15 +370,11 @@ public:
 	uint16_t cargo_cap;                 ///< total capacity
 	uint16_t refit_cap;                 ///< Capacity left over from before last refit.
 	VehicleCargoList cargo;             ///< The cargo this vehicle is carrying
-	uint16_t cargo_age_counter;         ///< Ticks till cargo is aged next.
 	int8_t trip_occupancy;              ///< NOSAVE: Occupancy of vehicle of the current trip (updated after leaving a station).
 
 	byte day_counter;                   ///< Increased by one for each day
-	byte tick_counter;                  ///< Increased by one for each tick
 	uint16_t running_ticks;             ///< Number of ticks this vehicle was not stopped this day
 
-	byte vehstatus;                     ///< Status
-
 	uint8_t order_occupancy_average;    ///< NOSAVE: order occupancy average. 0 = invalid, 1 = n/a, 16-116 = 0-100%
 	Order current_order;                ///< The current order (+ status, like: loading)
 
@@ -391,10 +385,16 @@ public:
 
 	uint16_t load_unload_ticks;         ///< Ticks to wait before starting next cycle.
 	GroupID group_id;                   ///< Index of group Pool array
-	byte subtype;                       ///< subtype (Filled with values from #AircraftSubType/#DisasterSubType/#EffectVehicleType/#GroundVehicleSubtypeFlags)
 	Direction cur_image_valid_dir;      ///< NOSAVE: direction for which cur_image does not need to be regenerated on the next tick
 
 	NewGRFCache grf_cache;              ///< Cache of often used calculated NewGRF values
+
+	/* The fields below are used by the per part loops in CallVehicleTicks, keep them together so that each part touches as few cache lines as possible. */
+	uint32_t motion_counter;            ///< counter to occasionally play a vehicle sound. (Also used as virtual train client ID).
+	uint16_t cargo_age_counter;         ///< Ticks till cargo is aged next.
+	byte tick_counter;                  ///< Increased by one for each tick
+	byte vehstatus;                     ///< Status
+	byte subtype;                       ///< subtype (Filled with values from #AircraftSubType/#DisasterSubType/#EffectVehicleType/#GroundVehicleSubtypeFlags)
 	VehicleCache vcache;                ///< Cache of often used vehicle values.
 
 	/**
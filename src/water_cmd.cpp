@@ -1328,6 +1328,25 @@ static void DoDryUp(TileIndex tile)
 	cur_company.Restore();
 }
 
+/**
+ * Check whether a non-water tile would be flooded by an adjacent actively flooding tile.
+ * @param dest The tile which may be flooded.
+ * @param dir Direction from the flooding tile to \a dest.
+ * @return true if \a dest would be flooded.
+ */
+static bool IsTileFloodableFrom(TileIndex dest, Direction dir)
+{
+	/* TREE_GROUND_SHORE is the sign of a previous flood. */
+	if (IsTileType(dest, MP_TREES) && GetTreeGround(dest) == TREE_GROUND_SHORE) return false;
+	if (IsTileType(dest, MP_OBJECT) && (GetObjectEffectiveFoundationType(dest) != OEFT_NONE || GetObjectGroundType(dest) == OBJECT_GROUND_SHORE)) return false;
+
+	int z_dest;
+	Slope slope_dest = GetFoundationSlope(dest, &z_dest) & ~SLOPE_HALFTILE_MASK & ~SLOPE_STEEP;
+	if (z_dest > 0) return false;
+
+	return HasBit(_flood_from_dirs[slope_dest], ReverseDir(dir));
+}
+
 /**
  * Let a water tile floods its diagonal adjoining tiles
  * called from tunnelbridge_cmd, and by TileLoop_Industry() and TileLoop_Track()
@@ -1359,17 +1378,7 @@ void TileLoopWaterFlooding(FloodingBehaviour flooding_behaviour, TileIndex tile)
 
 				non_water_neighbours++;
 
-				/* TREE_GROUND_SHORE is the sign of a previous flood. */
-				if (IsTileType(dest, MP_TREES) && GetTreeGround(dest) == TREE_GROUND_SHORE) continue;
-				if (IsTileType(dest, MP_OBJECT) && (GetObjectEffectiveFoundationType(dest) != OEFT_NONE || GetObjectGroundType(dest) == OBJECT_GROUND_SHORE)) continue;
-
-				int z_dest;
-				Slope slope_dest = GetFoundationSlope(dest, &z_dest) & ~SLOPE_HALFTILE_MASK & ~SLOPE_STEEP;
-				if (z_dest > 0) continue;
-
-				if (!HasBit(_flood_from_dirs[slope_dest], ReverseDir(dir))) continue;
-
-				DoFloodTile(dest);
+				if (IsTileFloodableFrom(dest, dir)) DoFloodTile(dest);
 			}
 			if (non_water_neighbours == 0 && IsTileType(tile, MP_WATER)) SetNonFloodingWaterTile(tile, true);
 			break;
@@ -1392,6 +1401,58 @@ void TileLoopWaterFlooding(FloodingBehaviour flooding_behaviour, TileIndex tile)
 	}
 }
 
+/**
+ * Check whether TileLoop_Water would leave a water tile and the game state untouched.
+ * This only reads the map, and does not run any NewGRF callbacks, so it may be called from worker threads whilst the map is not modified.
+ * @param tile The water tile.
+ * @return true if the tile loop of \a tile is known to do nothing, false if it may do something.
+ */
+bool IsWaterTileLoopNoOp(TileIndex tile)
+{
+	if (HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK)) return false;
+
+	/* At day lengths > 4, flooding is handled by the auxiliary tile loop */
+	if (_settings_game.economy.day_length_factor > 4 && _game_mode != GM_EDITOR) return true;
+
+	if (IsNonFloodingWaterTile(tile)) return true;
+
+	switch (GetFloodingBehaviour(tile)) {
+		case FLOOD_ACTIVE: {
+			bool non_water_neighbours = false;
+			for (Direction dir = DIR_BEGIN; dir < DIR_END; dir++) {
+				TileIndex dest = tile + TileOffsByDir(dir);
+				if (!IsValidTile(dest)) continue;
+				if (IsTileType(dest, MP_WATER)) continue;
+
+				non_water_neighbours = true;
+
+				switch (GetTileType(dest)) {
+					case MP_HOUSE:
+					case MP_INDUSTRY:
+					case MP_OBJECT:
+					case MP_STATION:
+						/* The foundations of these may be decided by NewGRF callbacks. */
+						return false;
+
+					default:
+						break;
+				}
+
+				if (IsTileFloodableFrom(dest, dir)) return false;
+			}
+
+			/* A tile without non-water neighbours is marked as non-flooding by the tile loop. */
+			return non_water_neighbours;
+		}
+
+		case FLOOD_DRYUP:
+			return false;
+
+		default:
+			return true;
+	}
+}
+
 void ConvertGroundTilesIntoWaterTiles()
 {
 	int z;
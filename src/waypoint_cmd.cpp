@@ -17,6 +17,7 @@
 #include "waypoint_base.h"
 #include "pathfinder/yapf/yapf_cache.h"
 #include "pathfinder/water_regions.h"
+#include "pathfinder/road_regions.h"
 #include "strings_func.h"
 #include "viewport_func.h"
 #include "viewport_kdtree.h"
@@ -493,6 +494,7 @@ CommandCost CmdBuildRoadWaypoint(TileIndex start_tile, DoCommandFlag flags, uint
 			UpdateCompanyRoadInfrastructure(tram_rt, tram_owner, ROAD_STOP_TRACKBIT_FACTOR);
 
 			MakeDriveThroughRoadStop(cur_tile, wp->owner, road_owner, tram_owner, wp->index, STATION_ROADWAYPOINT, road_rt, tram_rt, axis);
+			InvalidateRoadRegion(cur_tile);
 			SetDriveThroughStopDisallowedRoadDirections(cur_tile, drd);
 			SetCustomRoadStopSpecIndex(cur_tile, map_spec_index);
 			if (spec != nullptr) wp->SetRoadStopRandomBits(cur_tile, 0);
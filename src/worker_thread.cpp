@@ -15,70 +15,261 @@
 
 WorkerThreadPool _general_worker_pool;
 
+/** Pool of which the current thread is a worker, if any. */
+static thread_local const WorkerThreadPool *_current_worker_pool = nullptr;
+/** Index of the current thread in the workers of #_current_worker_pool. */
+static thread_local uint _current_worker_index = 0;
+
 void WorkerThreadPool::Start(const char *thread_name, uint max_workers)
 {
 	uint cpus = std::thread::hardware_concurrency();
 	if (cpus <= 1) return;
 
-	std::lock_guard<std::mutex> lk(this->lock);
+	std::lock_guard<std::mutex> lk(this->sleep_lock);
+	if (!this->workers.empty()) return;
 
 	this->exit = false;
 
 	uint worker_target = std::min<uint>(max_workers, cpus);
-	if (this->workers >= worker_target) return;
-
-	uint new_workers = worker_target - this->workers;
+	for (uint i = 0; i < worker_target; i++) {
+		this->workers.push_back(std::make_unique<Worker>());
+	}
 
-	for (uint i = 0; i < new_workers; i++) {
-		this->workers++;
-		if (!StartNewThread(nullptr, thread_name, &WorkerThreadPool::Run, this)) {
-			this->workers--;
-			return;
-		}
+	for (uint i = 0; i < worker_target; i++) {
+		if (!StartNewThread(nullptr, thread_name, [this, i]() { this->RunWorker(i); })) break;
+		this->running++;
 	}
+
+	/* Tasks queued to workers which failed to start are stolen by the others. */
+	if (this->running == 0) this->workers.clear();
 }
 
 void WorkerThreadPool::Stop()
 {
-	std::unique_lock<std::mutex> lk(this->lock);
+	std::unique_lock<std::mutex> lk(this->sleep_lock);
 	this->exit = true;
-	this->worker_wait_cv.notify_all();
-	this->done_cv.wait(lk, [this]() { return this->workers == 0; });
+	this->sleep_cv.notify_all();
+	this->done_cv.wait(lk, [this]() { return this->running == 0; });
+	this->workers.clear();
 }
 
-void WorkerThreadPool::EnqueueJob(WorkerJobFunc *func, void *data1, void *data2, void *data3)
+/**
+ * Queue a task.
+ * @param task The task.
+ */
+void WorkerThreadPool::Push(QueuedTask &&task)
 {
-	std::unique_lock<std::mutex> lk(this->lock);
-	if (this->workers == 0) {
+	if (this->workers.empty()) {
 		/* Just execute it here and now */
-		lk.unlock();
-		func(data1, data2, data3);
+		this->Execute(task);
 		return;
 	}
-	bool notify = this->jobs.size() < (size_t)this->workers_waiting;
-	this->jobs.push({ func, data1, data2, data3 });
-	lk.unlock();
-	if (notify) this->worker_wait_cv.notify_one();
+
+	uint index;
+	if (_current_worker_pool == this) {
+		index = _current_worker_index;
+	} else {
+		index = this->next_worker.fetch_add(1, std::memory_order_relaxed) % (uint)this->workers.size();
+	}
+
+	WorkerTaskGroup *group = task.group;
+	if (group != nullptr) {
+		/* Keep the group from completing until its waiter has been notified, the task may complete before that. */
+		group->pending++;
+	}
+	{
+		/* Only count the task once it can be taken, so nothing waits for a task which is not there yet. */
+		Worker &worker = *this->workers[index];
+		std::lock_guard<std::mutex> lk(worker.lock);
+		worker.tasks.push_back(std::move(task));
+		if (group != nullptr) group->queued++;
+		this->queued++;
+	}
+
+	if (this->sleeping.load() > 0) {
+		std::lock_guard<std::mutex> lk(this->sleep_lock);
+		this->sleep_cv.notify_one();
+	}
+	if (group != nullptr) {
+		std::lock_guard<std::mutex> lk(group->lock);
+		group->pending--;
+		group->cv.notify_all();
+	}
+}
+
+/**
+ * Take a queued task: from the back of the own queue of a worker, or from the front of the queue of any other worker.
+ * @param[out] task The task taken.
+ * @return Whether a task was taken.
+ */
+bool WorkerThreadPool::TryTake(QueuedTask &task)
+{
+	const uint count = (uint)this->workers.size();
+	const bool is_worker = (_current_worker_pool == this);
+	const uint own = is_worker ? _current_worker_index : 0;
+
+	if (is_worker) {
+		Worker &worker = *this->workers[own];
+		std::lock_guard<std::mutex> lk(worker.lock);
+		if (!worker.tasks.empty()) {
+			task = std::move(worker.tasks.back());
+			worker.tasks.pop_back();
+			this->queued--;
+			if (task.group != nullptr) task.group->queued--;
+			return true;
+		}
+	}
+
+	for (uint i = is_worker ? 1 : 0; i < count; i++) {
+		Worker &victim = *this->workers[(own + i) % count];
+		std::lock_guard<std::mutex> lk(victim.lock);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			this->queued--;
+			if (task.group != nullptr) task.group->queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Take a queued task of a particular group, searching all worker queues.
+ * @param group The group.
+ * @param[out] task The task taken.
+ * @return Whether a task was taken.
+ */
+bool WorkerThreadPool::TryTakeGroupTask(const WorkerTaskGroup *group, QueuedTask &task)
+{
+	if (group->queued.load() == 0) return false;
+
+	for (auto &worker : this->workers) {
+		std::lock_guard<std::mutex> lk(worker->lock);
+		for (auto it = worker->tasks.rbegin(); it != worker->tasks.rend(); ++it) {
+			if (it->group != group) continue;
+			task = std::move(*it);
+			worker->tasks.erase(std::next(it).base());
+			this->queued--;
+			task.group->queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Run a task which has been taken from the queues, and mark it as completed in its group.
+ * @param task The task.
+ */
+void WorkerThreadPool::Execute(QueuedTask &task)
+{
+	task.func();
+	if (task.group != nullptr) task.group->TaskDone();
 }
 
-void WorkerThreadPool::Run(WorkerThreadPool *pool)
+void WorkerThreadPool::RunWorker(uint index)
 {
-	std::unique_lock<std::mutex> lk(pool->lock);
-	while (!pool->exit || !pool->jobs.empty()) {
-		if (pool->jobs.empty()) {
-			pool->workers_waiting++;
-			pool->worker_wait_cv.wait(lk);
-			pool->workers_waiting--;
-		} else {
-			WorkerJob job = pool->jobs.front();
-			pool->jobs.pop();
-			lk.unlock();
-			job.func(job.data1, job.data2, job.data3);
-			lk.lock();
+	_current_worker_pool = this;
+	_current_worker_index = index;
+
+	while (true) {
+		QueuedTask task;
+		if (this->TryTake(task)) {
+			this->Execute(task);
+			continue;
 		}
+
+		std::unique_lock<std::mutex> lk(this->sleep_lock);
+		this->sleeping++;
+		this->sleep_cv.wait(lk, [this]() { return this->queued.load() > 0 || this->exit; });
+		this->sleeping--;
+		if (this->exit && this->queued.load() == 0) break;
+	}
+
+	std::lock_guard<std::mutex> lk(this->sleep_lock);
+	this->running--;
+	if (this->running == 0) {
+		this->done_cv.notify_all();
 	}
-	pool->workers--;
-	if (pool->workers == 0) {
-		pool->done_cv.notify_all();
+}
+
+/**
+ * Queue a task which is not waited for.
+ * The task must itself signal its completion to whoever needs it.
+ * @param task The task.
+ */
+void WorkerThreadPool::Run(WorkerTask task)
+{
+	this->Push({ std::move(task), nullptr });
+}
+
+/**
+ * Prepare for a call to fork(), this must be followed by ParentAfterFork() or ChildAfterFork().
+ * This makes sure that the child does not inherit any of the pool's locks in a locked state.
+ */
+void WorkerThreadPool::PrepareFork()
+{
+	this->sleep_lock.lock();
+	for (auto &worker : this->workers) worker->lock.lock();
+}
+
+/** Continue after fork() in the parent process. */
+void WorkerThreadPool::ParentAfterFork()
+{
+	for (auto &worker : this->workers) worker->lock.unlock();
+	this->sleep_lock.unlock();
+}
+
+/**
+ * Continue after fork() in the child process.
+ * The child only contains the thread which called fork(), so all tasks are executed immediately from now on.
+ */
+void WorkerThreadPool::ChildAfterFork()
+{
+	for (auto &worker : this->workers) worker->lock.unlock();
+	this->workers.clear();
+	this->running = 0;
+	this->sleeping = 0;
+	this->queued = 0;
+	this->sleep_lock.unlock();
+}
+
+WorkerTaskGroup::WorkerTaskGroup(WorkerThreadPool &pool) : pool(pool) {}
+
+/**
+ * Queue a task of this group.
+ * @param task The task.
+ */
+void WorkerTaskGroup::Run(WorkerTask task)
+{
+	this->pending++;
+	this->pool.Push({ std::move(task), this });
+}
+
+/** Called when a task of this group has completed. */
+void WorkerTaskGroup::TaskDone()
+{
+	std::lock_guard<std::mutex> lk(this->lock);
+	if (this->pending.fetch_sub(1) == 1) this->cv.notify_all();
+}
+
+/**
+ * Wait for all tasks of this group to complete, running queued tasks of this group in the meantime.
+ * Tasks which are queued after this returns can be waited for again.
+ */
+void WorkerTaskGroup::Wait()
+{
+	while (true) {
+		WorkerThreadPool::QueuedTask task;
+		if (this->pool.TryTakeGroupTask(this, task)) {
+			this->pool.Execute(task);
+			continue;
+		}
+
+		/* Only return with the lock held, such that no completing task still refers to this group. */
+		std::unique_lock<std::mutex> lk(this->lock);
+		this->cv.wait(lk, [this]() { return this->pending.load() == 0 || this->queued.load() > 0; });
+		if (this->pending.load() == 0) return;
 	}
 }
@@ -10,36 +10,85 @@
 #ifndef WORKER_THREAD_H
 #define WORKER_THREAD_H
 
-#include "core/ring_buffer_queue.hpp"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
-typedef void WorkerJobFunc(void *, void *, void *);
+/** A unit of work run by a WorkerThreadPool. */
+using WorkerTask = std::function<void()>;
 
+struct WorkerTaskGroup;
+
+/**
+ * Work-stealing pool of worker threads.
+ *
+ * Each worker has its own queue of tasks. Tasks queued from a worker go to the back of its own queue,
+ * and are taken from there by the same worker, most recently queued first.
+ * Tasks queued from other threads are distributed over the worker queues in turn.
+ * A worker whose own queue is empty steals the oldest task from the queues of the other workers.
+ *
+ * When the pool has no workers, tasks are run immediately by the thread which queues them.
+ */
 struct WorkerThreadPool {
 private:
-	struct WorkerJob {
-		WorkerJobFunc *func;
-		void *data1;
-		void *data2;
-		void *data3;
+	friend WorkerTaskGroup;
+
+	struct QueuedTask {
+		WorkerTask func;
+		WorkerTaskGroup *group;        ///< Group which the task belongs to, or nullptr.
 	};
 
-	uint workers = 0;
-	uint workers_waiting = 0;
-	bool exit = false;
-	std::mutex lock;
-	ring_buffer_queue<WorkerJob> jobs;
-	std::condition_variable worker_wait_cv;
+	struct Worker {
+		std::mutex lock;
+		std::deque<QueuedTask> tasks;  ///< Tasks queued for this worker, protected by #lock.
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	uint running = 0;                  ///< Number of worker threads which are running, protected by #sleep_lock.
+	bool exit = false;                 ///< Whether the workers should exit once all tasks are done, protected by #sleep_lock.
+	std::atomic<size_t> queued = 0;    ///< Number of tasks which are queued and not yet taken.
+	std::atomic<uint> sleeping = 0;    ///< Number of workers which are waiting for tasks.
+	std::atomic<uint> next_worker = 0; ///< Worker to queue the next task from a non-worker thread to.
+	std::mutex sleep_lock;
+	std::condition_variable sleep_cv;
 	std::condition_variable done_cv;
 
-	static void Run(WorkerThreadPool *pool);
+	void Push(QueuedTask &&task);
+	bool TryTake(QueuedTask &task);
+	bool TryTakeGroupTask(const WorkerTaskGroup *group, QueuedTask &task);
+	void Execute(QueuedTask &task);
+	void RunWorker(uint index);
 
 public:
-
 	void Start(const char *thread_name, uint max_workers);
 	void Stop();
-	void EnqueueJob(WorkerJobFunc *func, void *data1 = nullptr, void *data2 = nullptr, void *data3 = nullptr);
+
+	/**
+	 * Get the number of worker threads.
+	 * @return The number of worker threads, 0 if tasks are run by the queuing thread.
+	 */
+	uint GetWorkerCount() const { return (uint)this->workers.size(); }
+
+	void Run(WorkerTask task);
+
+	/**
+	 * Call a function for consecutive ranges of indices in parallel, and wait for all calls to complete.
+	 * The range which starts at \a begin is processed by the calling thread.
+	 * @param begin First index.
+	 * @param end One past the last index.
+	 * @param grain Maximum number of indices in each range.
+	 * @param func Function which is called with the first and one past the last index of each range.
+	 */
+	template <typename F>
+	void ParallelFor(size_t begin, size_t end, size_t grain, F func);
+
+	void PrepareFork();
+	void ParentAfterFork();
+	void ChildAfterFork();
 
 	~WorkerThreadPool()
 	{
@@ -47,6 +96,56 @@ public:
 	}
 };
 
+/**
+ * Group of tasks which can be waited for together.
+ * Tasks of a group may themselves queue further tasks, to the same or other groups.
+ * A thread waiting for a group runs queued tasks of that group, so waiting from within a task does not deadlock.
+ */
+struct WorkerTaskGroup {
+private:
+	friend WorkerThreadPool;
+
+	WorkerThreadPool &pool;
+	std::atomic<uint> pending = 0;     ///< Number of tasks of this group which have not yet completed, decremented with #lock held.
+	std::atomic<uint> queued = 0;      ///< Number of tasks of this group which are queued and not yet taken.
+	std::mutex lock;
+	std::condition_variable cv;
+
+	void TaskDone();
+
+public:
+	WorkerTaskGroup(WorkerThreadPool &pool);
+
+	/** Wait for all tasks, such that none refer to this group after it is destroyed. */
+	~WorkerTaskGroup()
+	{
+		this->Wait();
+	}
+
+	void Run(WorkerTask task);
+	void Wait();
+};
+
+template <typename F>
+void WorkerThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, F func)
+{
+	if (begin >= end) return;
+	if (end - begin <= grain || this->workers.empty()) {
+		for (size_t first = begin; first < end; first += std::min(grain, end - first)) {
+			func(first, first + std::min(grain, end - first));
+		}
+		return;
+	}
+
+	WorkerTaskGroup group(*this);
+	for (size_t first = begin + grain; first < end; first += grain) {
+		const size_t last = first + std::min(grain, end - first);
+		group.Run([&func, first, last]() { func(first, last); });
+	}
+	func(begin, begin + grain);
+	group.Wait();
+}
+
 extern WorkerThreadPool _general_worker_pool;
 
 #endif /* WORKER_THREAD_H */